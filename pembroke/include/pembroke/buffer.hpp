@@ -1,13 +1,91 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <type_traits>
 
+#include "pembroke/callback.hpp"
 #include "pembroke/libevent/forward_decls.hpp"
 
 namespace pembroke {
 
-    class ByteSlice;
+    class BufferPool;
+    class BufferSegments;
+    class BufferWriter;
+    class FileSegment;
+
+    namespace internal {
+        struct BufferShelf;
+    }
+
+    namespace net {
+        class Connection;
+    }
+
+    /**
+     * @brief
+     * ByteSlice is a non-owning view into an array of `std::byte` objects. It exists to
+     * facilitate zero-copy reading of Buffer data.
+     * 
+     * This struct is similar in intention to C++20's `std::span`, but without any other
+     * useful utility features.
+     */
+    struct ByteSlice {
+        std::byte *bytes;  /**< Pointer for first `std::byte` in the array */
+        size_t len;        /**< The number of elements in the array/slice */
+    };
+
+    /**
+     * @brief Selects an unsigned LEB128 varint length prefix for Buffer::write_prefixed() and
+     *        Buffer::read_prefixed(), in place of a fixed-width integer.
+     */
+    struct Varint {};
+
+    /**
+     * @brief How lines are terminated, for Buffer::readln(). Mirrors libevent's `evbuffer_eol_style`.
+     */
+    enum class LineEnding {
+        Any,         /**< Any run of carriage returns and linefeeds */
+        Crlf,        /**< An optional carriage return followed by a linefeed */
+        CrlfStrict,  /**< A carriage return followed by a linefeed */
+        Lf,          /**< A single linefeed */
+        Nul,         /**< A single NUL byte */
+    };
+
+    /**
+     * @brief
+     * Writable space at the end of a Buffer, handed out by Buffer::reserve(). The space is
+     * made up of one or more extents (contiguous ranges), to be filled in order.
+     *
+     * @see Buffer::reserve()
+     * @see Buffer::commit()
+     */
+    struct BufferReservation {
+        static constexpr size_t MaxExtents = 2;
+
+        std::array<ByteSlice, MaxExtents> extents{};
+        size_t count = 0;  /**< The number of extents in use */
+
+        [[nodiscard]] auto begin() const noexcept -> const ByteSlice * { return extents.data(); }
+        [[nodiscard]] auto end() const noexcept -> const ByteSlice * { return extents.data() + count; }
+
+        /** @brief Total number of writable bytes across all extents */
+        [[nodiscard]]
+        auto size() const noexcept -> size_t {
+            size_t total = 0;
+            for (const auto &extent : *this) {
+                total += extent.len;
+            }
+            return total;
+        }
+    };
 
     /**
      * @brief
@@ -27,10 +105,23 @@ namespace pembroke {
      * @see ByteSlice
      */
     class Buffer {
+        friend class BufferPool;
+        friend class net::Connection;
     private:
         evbuffer *m_underlying;
+        /* Space handed out by reserve(), waiting for commit() */
+        BufferReservation m_reserved{};
+        /* The pool the underlying evbuffer is returned to, if it came from one */
+        internal::BufferShelf *m_shelf = nullptr;
+        /* Set by drains_to_fd(), such buffers may hold segments that cannot be peeked */
+        bool m_drains_to_fd = false;
+        /* False for a view of an evbuffer owned by someone else (see borrow()) */
+        bool m_owned = true;
 
     public:
+        /** @brief Returned by the search functions when there is no match */
+        static constexpr size_t npos = SIZE_MAX;
+
         /** @brief Construct a new, empty buffer object */
         Buffer() noexcept;
 
@@ -38,6 +129,7 @@ namespace pembroke {
          *         into the newly constructed class. */
         Buffer(Buffer &&) noexcept;
 
+        /** @brief Free the underlying `evbuffer`, or hand it back to the BufferPool it came from */
         ~Buffer() noexcept;
 
         /** @brief Move-assign a buffer-object. The underlying `evbuffer` will be transferred
@@ -50,6 +142,21 @@ namespace pembroke {
         Buffer(const Buffer &) = delete;
         auto operator=(const Buffer &) -> Buffer & = delete;
 
+        /** @brief True if the buffer was acquired from a BufferPool */
+        [[nodiscard]]
+        auto pooled() const noexcept -> bool {
+            return m_shelf != nullptr;
+        }
+
+        /**
+         * @brief The underlying `evbuffer`, for use with libevent APIs that Buffer does not
+         *        wrap. Null for a moved-from buffer.
+         */
+        [[nodiscard]]
+        auto underlying() const noexcept -> evbuffer * {
+            return m_underlying;
+        }
+
 
         // ---
         // Write Functions
@@ -109,6 +216,331 @@ namespace pembroke {
          */
         void add(const ByteSlice &byte_slice) noexcept;
 
+        /**
+         * @brief
+         * Attach @p n_bytes of caller-owned memory to the end of the buffer without copying
+         * it. The memory becomes a segment of the buffer and must stay valid, and unchanged,
+         * until @p cleanup is called: once the segment has been drained or the buffer
+         * destroyed.
+         *
+         * @p cleanup is called exactly once, including when the reference could not be
+         * added. It may be empty for memory that outlives the buffer (such as literals).
+         *
+         * @note A non-empty @p cleanup is moved to the heap to be handed to libevent, so
+         *       referencing (rather than copying) pays off for payloads larger than a few
+         *       hundred bytes.
+         * @returns False if the reference could not be added
+         */
+        auto add_reference(const std::byte *bytes, size_t n_bytes, Callback cleanup = {}) noexcept -> bool;
+
+        /** @see Buffer::add_reference(const std::byte *, size_t, Callback) */
+        auto add_reference(std::string_view str_view, Callback cleanup = {}) noexcept -> bool;
+
+        /**
+         * @brief
+         * Attach @p n_bytes of memory kept alive by @p owner to the end of the buffer without
+         * copying it. The buffer holds a reference to @p owner until the segment is released,
+         * so a single immutable payload can be shared by any number of buffers:
+         *
+         *     auto payload = std::make_shared<const std::string>(render());
+         *     for (auto &out : outgoing) {
+         *         out.add_reference(payload);
+         *     }
+         *
+         * @returns False if the reference could not be added
+         */
+        auto add_reference(std::shared_ptr<const void> owner, const std::byte *bytes, size_t n_bytes) noexcept -> bool;
+
+        /** @brief Attach the contents of a shared string, see Buffer::add_reference(std::shared_ptr<const void>, const std::byte *, size_t) */
+        auto add_reference(std::shared_ptr<const std::string> str) noexcept -> bool;
+
+        /**
+         * @brief
+         * Add @p length bytes of a file segment, starting at @p offset within the segment, to
+         * the end of the buffer without reading them into memory. A negative @p length adds
+         * the rest of the segment. The buffer keeps the segment open until it is drained.
+         *
+         * @see FileSegment
+         * @returns False if the segment is invalid or could not be added
+         */
+        auto add_file(const FileSegment &segment, int64_t offset = 0, int64_t length = -1) noexcept -> bool;
+
+        /**
+         * @brief Open the file at @p path and add @p length bytes of it from @p offset (the rest
+         *        of the file if @p length is negative), see Buffer::add_file(const FileSegment &, int64_t, int64_t).
+         *
+         * @note Opens the file on every call. When serving the same files repeatedly use the
+         *       reactor's FileSegmentCache instead.
+         * @returns False (and logs a warning) if the file cannot be opened
+         */
+        auto add_file(const std::string &path, int64_t offset = 0, int64_t length = -1) noexcept -> bool;
+
+        /**
+         * @brief Mark the buffer as one that will be written to a socket, rather than read by
+         *        the application, so that file segments added to it are sent with `sendfile`
+         *        instead of being mapped into memory.
+         * @note  Must be set before file segments are added. The contents of a buffer marked
+         *        this way should not be read.
+         */
+        void drains_to_fd(bool val = true) noexcept;
+
+
+        // ---
+        // In-Place Writes
+        // ---
+
+        /**
+         * @brief
+         * Reserve at least @p n bytes of writable space at the end of the buffer, to be
+         * written in place and then committed with Buffer::commit(). Nothing is added to the
+         * buffer until it is committed.
+         *
+         * The space is returned as up to @p max_extents (at most BufferReservation::MaxExtents)
+         * extents. Reserving a single extent guarantees contiguous space, but may allocate where
+         * two extents could have used the free space left at the end of the buffer.
+         *
+         *     auto space = buffer.reserve(64, 1);
+         *     size_t written = encode(space.extents[0].bytes, space.extents[0].len);
+         *     buffer.commit(written);
+         *
+         * @note Any other modification of the buffer cancels the reservation. Reserving again
+         *       replaces the previous reservation.
+         * @returns An empty reservation if the space could not be allocated
+         */
+        [[nodiscard]]
+        auto reserve(size_t n, size_t max_extents = BufferReservation::MaxExtents) noexcept -> BufferReservation;
+
+        /**
+         * @brief Add the first @p written bytes of the last reservation to the buffer. The
+         *        extents are filled in order, so only the last extent written to may be
+         *        partially filled.
+         * @returns False if there is no reservation, or @p written exceeds its size
+         */
+        auto commit(size_t written) noexcept -> bool;
+
+        /**
+         * @brief
+         * A writer that formats straight into the end of the buffer. Its iterator is a plain
+         * output iterator, so it can be handed to `fmt::format_to` (or any algorithm that
+         * writes characters) without formatting into a temporary string first:
+         *
+         *     {
+         *         auto out = buffer.writer();
+         *         fmt::format_to(out.begin(), "{} {}\r\n", status, reason);
+         *     } // committed here
+         *
+         * Space is reserved @p chunk bytes at a time and committed when the writer is flushed
+         * or destroyed.
+         *
+         * @note The buffer must not be otherwise modified while the writer is alive.
+         * @see BufferWriter
+         */
+        [[nodiscard]]
+        auto writer(size_t chunk = 1024) noexcept -> BufferWriter;
+
+
+        // ---
+        // Binary Encoding
+        // ---
+
+        /** @brief Longest encoding of a 64-bit varint */
+        static constexpr size_t MaxVarintBytes = 10;
+
+        /** @brief Append an integer in big-endian (network) byte order */
+        template<typename T>
+        void write_be(T value) noexcept {
+            static_assert(std::is_integral_v<T>, "write_be requires an integer type");
+            auto bytes = to_endian<T, true>(value);
+            add(reinterpret_cast<const std::byte *>(&bytes), sizeof(T));
+        }
+
+        /** @brief Append an integer in little-endian byte order */
+        template<typename T>
+        void write_le(T value) noexcept {
+            static_assert(std::is_integral_v<T>, "write_le requires an integer type");
+            auto bytes = to_endian<T, false>(value);
+            add(reinterpret_cast<const std::byte *>(&bytes), sizeof(T));
+        }
+
+        /**
+         * @brief Remove a big-endian integer from the start of the buffer. The integer may span
+         *        segments, the buffer is not linearized.
+         * @returns False, leaving the buffer untouched, if it holds fewer than `sizeof(T)` bytes
+         */
+        template<typename T>
+        auto read_be(T &value) noexcept -> bool {
+            static_assert(std::is_integral_v<T>, "read_be requires an integer type");
+            T bytes;
+            if (!take(&bytes, sizeof(T))) {
+                return false;
+            }
+            value = to_endian<T, true>(bytes);
+            return true;
+        }
+
+        /** @brief Remove a little-endian integer from the start of the buffer, see Buffer::read_be() */
+        template<typename T>
+        auto read_le(T &value) noexcept -> bool {
+            static_assert(std::is_integral_v<T>, "read_le requires an integer type");
+            T bytes;
+            if (!take(&bytes, sizeof(T))) {
+                return false;
+            }
+            value = to_endian<T, false>(bytes);
+            return true;
+        }
+
+        /** @brief Append an unsigned LEB128 varint (1 to 10 bytes) */
+        void write_varint(uint64_t value) noexcept;
+
+        /**
+         * @brief Remove an unsigned LEB128 varint from the start of the buffer.
+         * @returns False, leaving the buffer untouched, if the buffer does not hold a complete
+         *          varint or the varint is malformed (longer than Buffer::MaxVarintBytes)
+         */
+        auto read_varint(uint64_t &value) noexcept -> bool;
+
+        /**
+         * @brief Append @p data preceded by its length, as a @p Prefix: an unsigned integer type
+         *        (written big-endian) or Varint.
+         * @returns False, writing nothing, if the length does not fit in @p Prefix
+         */
+        template<typename Prefix = Varint>
+        auto write_prefixed(std::string_view data) noexcept -> bool {
+            if constexpr (std::is_same_v<Prefix, Varint>) {
+                write_varint(data.size());
+            } else {
+                static_assert(std::is_integral_v<Prefix> && std::is_unsigned_v<Prefix>,
+                              "The length prefix must be an unsigned integer type or Varint");
+                if (data.size() > static_cast<uint64_t>(std::numeric_limits<Prefix>::max())) {
+                    return false;
+                }
+                write_be(static_cast<Prefix>(data.size()));
+            }
+            add(data);
+            return true;
+        }
+
+        /** @see Buffer::write_prefixed(std::string_view) */
+        template<typename Prefix = Varint>
+        auto write_prefixed(const ByteSlice &data) noexcept -> bool {
+            return write_prefixed<Prefix>(std::string_view(reinterpret_cast<const char *>(data.bytes), data.len));
+        }
+
+        /**
+         * @brief Remove a length-prefixed value (see Buffer::write_prefixed()) and copy it into
+         *        @p out.
+         * @returns False, leaving the buffer untouched, if the buffer does not yet hold the
+         *          whole value, or its prefix is malformed
+         */
+        template<typename Prefix = Varint>
+        auto read_prefixed(std::string &out) noexcept -> bool {
+            return take_prefixed(out, prefix_width<Prefix>());
+        }
+
+        /**
+         * @brief Remove a length-prefixed value (see Buffer::write_prefixed()) and move it, without
+         *        copying whole segments, to the end of @p out.
+         * @returns False, leaving the buffer untouched, if the buffer does not yet hold the
+         *          whole value, or its prefix is malformed
+         */
+        template<typename Prefix = Varint>
+        auto read_prefixed(Buffer &out) noexcept -> bool {
+            size_t prefix = 0;
+            size_t len = 0;
+            if (!peek_prefix<Prefix>(prefix, len)) {
+                return false;
+            }
+            drain(prefix);
+            return move_prefix_to(out, len) == len;
+        }
+
+
+        // ---
+        // Moving Data Between Buffers
+        // ---
+
+        /**
+         * @brief Move the entire contents of @p other to the end of this buffer, leaving
+         *        @p other empty. Segments change hands, no bytes are copied.
+         * @returns False if either buffer has been moved-from, or they are the same buffer
+         */
+        auto append(Buffer &&other) noexcept -> bool;
+
+        /**
+         * @brief Move the entire contents of @p other to the start of this buffer, leaving
+         *        @p other empty. Segments change hands, no bytes are copied.
+         * @returns False if either buffer has been moved-from, or they are the same buffer
+         */
+        auto prepend(Buffer &&other) noexcept -> bool;
+
+        /**
+         * @brief
+         * Move (at most) the first @p n bytes of this buffer to the end of @p dest. Whole
+         * segments change hands without being copied, only a segment split by the @p n'th
+         * byte has its leading part copied.
+         *
+         * Useful for framing: move a complete message out of a receive buffer, or a prefix
+         * of an upstream buffer to a downstream one in a proxy.
+         *
+         * @returns The number of bytes moved
+         */
+        auto move_prefix_to(Buffer &dest, size_t n) noexcept -> size_t;
+
+
+        // ---
+        // File Descriptor I/O
+        // ---
+
+        /**
+         * @brief
+         * Write (at most @p max bytes of) the buffer to @p fd and drain what was written. All
+         * segments go out in a single `writev`, without linearizing the buffer, and file
+         * segments in a buffer marked with Buffer::drains_to_fd() are sent with `sendfile`.
+         *
+         * A short write is not an error: the unwritten bytes stay in the buffer, ready for
+         * the next call once @p fd is writable again.
+         *
+         * @returns The number of bytes written, or -1 with `errno` set (`EAGAIN` if a
+         *          non-blocking @p fd is not writable)
+         */
+        auto write_to(int fd, size_t max = npos) noexcept -> int64_t;
+
+        /**
+         * @brief
+         * Read (at most @p max bytes) from @p fd into space reserved at the end of the buffer,
+         * with a single `readv`. By default as many bytes as @p fd reports readable are read
+         * (at least 4 KiB, at most Buffer::MaxRead).
+         *
+         * @returns The number of bytes read, 0 at end of file, or -1 with `errno` set
+         *          (`EAGAIN` if a non-blocking @p fd has nothing to read)
+         */
+        auto read_from(int fd, size_t max = npos) noexcept -> int64_t;
+
+        /** @brief Most bytes read by a single Buffer::read_from() without an explicit limit */
+        static constexpr size_t MaxRead = 1024 * 1024;
+
+        /**
+         * @brief
+         * Write (at most @p max bytes of) several buffers to @p fd, in order, with a single
+         * `writev`, draining what was written from each. Flushing a batch of small buffers
+         * (log lines, response header and body) costs one system call instead of one per
+         * buffer.
+         *
+         *     Buffer::write_batch(fd, {&header, &body});
+         *
+         * A batch stops short of a buffer marked with Buffer::drains_to_fd() unless it is the
+         * first, which is written on its own (see Buffer::write_to()), so its file segments
+         * can still be sent with `sendfile`. As with write_to() a short write leaves the rest
+         * of the batch in the buffers.
+         *
+         * @returns The total number of bytes written, or -1 with `errno` set
+         */
+        static auto write_batch(int fd, std::initializer_list<Buffer *> buffers, size_t max = npos) noexcept -> int64_t;
+
+        /** @see Buffer::write_batch(int, std::initializer_list<Buffer *>, size_t) */
+        static auto write_batch(int fd, Buffer *const *buffers, size_t n_buffers, size_t max = npos) noexcept -> int64_t;
+
 
         // ---
         // Read Functions
@@ -118,16 +550,19 @@ namespace pembroke {
          * @brief Return the length of the data currently stored in the buffer. Same as Buffer::size().
          */
         [[nodiscard]]
-        auto length() noexcept -> size_t;
+        auto length() const noexcept -> size_t;
 
         /**
          * @brief Return the length of the data currently stored in the buffer. Same as Buffer::length().
          */
         [[nodiscard]]
-        auto size() noexcept -> size_t;
+        auto size() const noexcept -> size_t;
 
         /**
          * @brief Return a string-view into the buffer.
+         * @note  The buffer is stored as a chain of segments, and a view of all of it requires
+         *        linearizing (copying) the whole chain into one segment first. Prefer
+         *        Buffer::segments() or Buffer::view_prefix() for large buffers.
          */
         [[nodiscard]]
         auto view_str() noexcept -> std::string_view;
@@ -142,22 +577,303 @@ namespace pembroke {
 
         /**
          * @brief Return a ByteSlice of the buffer. No copies of the underlying buffer-data are performed.
+         * @note  Like Buffer::view_str() this linearizes the whole buffer first.
          */
         [[nodiscard]]
         auto bytes() const noexcept -> ByteSlice;
+
+        /**
+         * @brief Iterate over the buffer's contents one segment (contiguous chunk) at a time,
+         *        without copying or linearizing anything.
+         *
+         *     for (ByteSlice segment : buffer.segments()) {
+         *         parse(segment.bytes, segment.len);
+         *     }
+         *
+         * @note The segments are invalidated by any modification of the buffer.
+         * @param limit Only iterate over (at most) the first @p limit bytes of the buffer. The
+         *              final segment is truncated to fit.
+         */
+        [[nodiscard]]
+        auto segments(size_t limit = SIZE_MAX) const noexcept -> BufferSegments;
+
+        /**
+         * @brief Zero-copy peek at the start of the buffer: a slice of at most @p n bytes from
+         *        the first segment. May be shorter than @p n (even if the buffer is not), never
+         *        copies. Empty only if the buffer is.
+         */
+        [[nodiscard]]
+        auto peek(size_t n) const noexcept -> ByteSlice;
+
+        /**
+         * @brief Contiguous view of the first @p n bytes of the buffer (or all of it if shorter).
+         *        Only those bytes are linearized, and only if they span more than one segment.
+         */
+        [[nodiscard]]
+        auto view_prefix(size_t n) noexcept -> std::string_view;
+
+
+        // ---
+        // Search Functions
+        // ---
+
+        /**
+         * @brief
+         * Offset of the first occurrence of @p pattern at or after @p from, or Buffer::npos.
+         *
+         * The buffer's segments are scanned in place (with SSE2/AVX2 where the CPU supports
+         * them), matches that straddle two or more segments are found without linearizing
+         * the buffer.
+         */
+        [[nodiscard]]
+        auto find(std::string_view pattern, size_t from = 0) const noexcept -> size_t;
+
+        /**
+         * @brief Offset of the first byte at or after @p from that is any of the bytes in
+         *        @p byteset, or Buffer::npos. Sets of up to 8 bytes are scanned with SIMD.
+         */
+        [[nodiscard]]
+        auto find_any(std::string_view byteset, size_t from = 0) const noexcept -> size_t;
+
+        /**
+         * @brief
+         * Remove the first line from the buffer (terminator included) and copy it, without its
+         * terminator, into @p line.
+         *
+         * @returns False, leaving the buffer untouched, if the buffer does not contain a
+         *          complete line
+         */
+        auto readln(std::string &line, LineEnding style = LineEnding::Crlf) noexcept -> bool;
+
+        /** @brief Discard (at most) the first @p n bytes of the buffer */
+        void drain(size_t n) noexcept;
+
+    private:
+        /* Copy exactly @p n bytes from offset @p skip of the buffer into @p out and drain all
+         * @p skip + @p n bytes. False (and nothing is drained) if the buffer is too short */
+        auto take(void *out, size_t n, size_t skip = 0) noexcept -> bool;
+
+        /* Copy (at most) @p n bytes from the start of the buffer into @p out without draining
+         * them, returning the number copied */
+        auto copy_prefix(void *out, size_t n) const noexcept -> size_t;
+
+        /* Decode a varint from @p bytes, storing the number of bytes it takes in @p consumed.
+         * False if @p bytes does not hold a complete, well-formed varint */
+        static auto decode_varint(const uint8_t *bytes, size_t len, uint64_t &value, size_t &consumed) noexcept -> bool;
+
+        /* Convert between native and big-endian (@p Big) or little-endian byte order */
+        template<typename T, bool Big>
+        static auto to_endian(T value) noexcept -> T {
+            constexpr bool native_big = __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+            if constexpr (sizeof(T) == 1 || Big == native_big) {
+                return value;
+            } else if constexpr (sizeof(T) == 2) {
+                return static_cast<T>(__builtin_bswap16(static_cast<uint16_t>(value)));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<T>(__builtin_bswap32(static_cast<uint32_t>(value)));
+            } else {
+                static_assert(sizeof(T) == 8, "Unsupported integer width");
+                return static_cast<T>(__builtin_bswap64(static_cast<uint64_t>(value)));
+            }
+        }
+
+        /* Width in bytes of an integer @p Prefix, or 0 for Varint */
+        template<typename Prefix>
+        static constexpr auto prefix_width() noexcept -> size_t {
+            if constexpr (std::is_same_v<Prefix, Varint>) {
+                return 0;
+            } else {
+                static_assert(std::is_integral_v<Prefix> && std::is_unsigned_v<Prefix>,
+                              "The length prefix must be an unsigned integer type or Varint");
+                return sizeof(Prefix);
+            }
+        }
+
+        /* Decode a big-endian prefix of @p width bytes, or a varint if @p width is 0. False if
+         * @p bytes does not hold a complete, well-formed prefix */
+        static auto decode_prefix(const uint8_t *bytes, size_t len, size_t width, uint64_t &value, size_t &consumed) noexcept -> bool;
+
+        /* Remove a prefixed value (see prefix_width()) into @p out, in a single pass over the
+         * first segment when it holds the whole value */
+        auto take_prefixed(std::string &out, size_t width) noexcept -> bool;
+
+        /* Read the length prefix of a prefixed value without draining anything: @p prefix is
+         * the size of the prefix and @p len the size of the value. False unless the buffer
+         * holds the whole prefix and value */
+        template<typename Prefix>
+        auto peek_prefix(size_t &prefix, size_t &len) const noexcept -> bool {
+            uint8_t bytes[MaxVarintBytes];
+            uint64_t value = 0;
+            size_t n = copy_prefix(bytes, prefix_width<Prefix>() == 0 ? MaxVarintBytes : prefix_width<Prefix>());
+            if (!decode_prefix(bytes, n, prefix_width<Prefix>(), value, prefix)) {
+                return false;
+            }
+            len = static_cast<size_t>(value);
+            return size() - prefix >= len;
+        }
+
+        /* Wrap a recycled evbuffer (see BufferPool) */
+        Buffer(evbuffer *underlying, internal::BufferShelf *shelf) noexcept;
+
+        /* Wrap an evbuffer owned by someone else (such as a bufferevent) without taking
+         * ownership of it */
+        [[nodiscard]]
+        static auto borrow(evbuffer *underlying) noexcept -> Buffer;
+
+        /* Free (or return to its pool) the underlying evbuffer */
+        void release() noexcept;
     };
 
     /**
      * @brief
-     * ByteSlice is a non-owning view into an array of `std::byte` objects. It exists to
-     * facilitate zero-copy reading of Buffer data.
-     * 
-     * This struct is similar in intention to C++20's `std::span`, but without any other
-     * useful utility features.
+     * Writes characters into reserved space at the end of a Buffer, committing them when
+     * flushed or destroyed. Create one with Buffer::writer().
      */
-    struct ByteSlice {
-        std::byte *bytes;  /**< Pointer for first `std::byte` in the array */
-        size_t len;        /**< The number of elements in the array/slice */
+    class BufferWriter {
+        Buffer *m_buffer;
+        size_t m_chunk;
+        char *m_start = nullptr;
+        char *m_pos = nullptr;
+        char *m_end = nullptr;
+
+    public:
+        /** @brief Output iterator writing into a BufferWriter, for use with `fmt::format_to` */
+        class iterator {
+            BufferWriter *m_writer;
+
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            explicit iterator(BufferWriter *writer) noexcept : m_writer(writer) {}
+
+            auto operator=(char c) noexcept -> iterator & {
+                m_writer->put(c);
+                return *this;
+            }
+            auto operator*() noexcept -> iterator & { return *this; }
+            auto operator++() noexcept -> iterator & { return *this; }
+            auto operator++(int) noexcept -> iterator { return *this; }
+        };
+
+        BufferWriter(Buffer &buffer, size_t chunk) noexcept
+            : m_buffer(&buffer), m_chunk(chunk == 0 ? 1 : chunk) {}
+
+        BufferWriter(const BufferWriter &) = delete;
+        BufferWriter(BufferWriter &&) = delete;
+        auto operator=(const BufferWriter &) -> BufferWriter & = delete;
+        auto operator=(BufferWriter &&) -> BufferWriter & = delete;
+
+        ~BufferWriter() noexcept {
+            flush();
+        }
+
+        /** @brief Write a single character */
+        void put(char c) noexcept {
+            if (m_pos == m_end && !refill()) {
+                return;
+            }
+            *m_pos++ = c;
+        }
+
+        /** @brief Write a run of characters */
+        void write(std::string_view str) noexcept;
+
+        /** @brief An output iterator writing into this writer */
+        [[nodiscard]]
+        auto begin() noexcept -> iterator {
+            return iterator(this);
+        }
+
+        /** @brief Commit everything written so far to the buffer */
+        void flush() noexcept;
+
+    private:
+        /* Commit the current chunk and reserve the next one. False if out of memory, in
+         * which case further writes are dropped */
+        auto refill() noexcept -> bool;
+    };
+
+    /**
+     * @brief Forward-iterator over the segments of a Buffer
+     * @see Buffer::segments()
+     */
+    class BufferSegmentIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ByteSlice;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ByteSlice *;
+        using reference = const ByteSlice &;
+
+        /* Storage for libevent's `evbuffer_ptr` which cannot be forward-declared by value,
+         * its size is checked against the real thing in buffer.cpp */
+        struct Position {
+            std::ptrdiff_t pos;
+            void *chain;
+            size_t pos_in_chain;
+        };
+
+    private:
+        evbuffer *m_buffer = nullptr;
+        Position m_position{};
+        ByteSlice m_current{nullptr, 0};
+        size_t m_remaining = 0;
+
+    public:
+        /** @brief Construct an end iterator */
+        BufferSegmentIterator() noexcept = default;
+
+        /** @brief Construct an iterator over the (at most) @p limit bytes of @p buffer from
+         *         offset @p start */
+        BufferSegmentIterator(evbuffer *buffer, size_t limit, size_t start = 0) noexcept;
+
+        auto operator*() const noexcept -> reference { return m_current; }
+        auto operator->() const noexcept -> pointer { return &m_current; }
+
+        auto operator++() noexcept -> BufferSegmentIterator &;
+        auto operator++(int) noexcept -> BufferSegmentIterator {
+            auto prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        auto operator==(const BufferSegmentIterator &other) const noexcept -> bool {
+            return m_current.bytes == other.m_current.bytes && m_current.len == other.m_current.len;
+        }
+        auto operator!=(const BufferSegmentIterator &other) const noexcept -> bool {
+            return !(*this == other);
+        }
+
+    private:
+        void load() noexcept;
+    };
+
+    /**
+     * @brief Range of the segments of a Buffer, for use with range-based for loops
+     * @see Buffer::segments()
+     */
+    class BufferSegments {
+        evbuffer *m_buffer;
+        size_t m_limit;
+        size_t m_start;
+
+    public:
+        BufferSegments(evbuffer *buffer, size_t limit, size_t start = 0) noexcept
+            : m_buffer(buffer), m_limit(limit), m_start(start) {}
+
+        [[nodiscard]]
+        auto begin() const noexcept -> BufferSegmentIterator {
+            return BufferSegmentIterator(m_buffer, m_limit, m_start);
+        }
+
+        [[nodiscard]]
+        auto end() const noexcept -> BufferSegmentIterator {
+            return BufferSegmentIterator();
+        }
     };
 
 }  // namespace pembroke
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pembroke/buffer.hpp"
+
+namespace pembroke {
+
+    /**
+     * @brief
+     * A pool of recycled Buffers. Buffers acquired from a pool return their `evbuffer` to
+     * it when they are destroyed, drained and ready for the next acquire(), rather than
+     * freeing it. A request/response cycle that acquires its buffers from a warm pool does
+     * not call `evbuffer_new` or `evbuffer_free` at all.
+     *
+     * Each Reactor owns a pool (see Reactor::buffer_pool()), so a pool, and the buffers
+     * acquired from it, are only safe to use from the reactor's thread.
+     *
+     * @note libevent frees a buffer's storage when it is drained, so recycling saves the
+     *       allocation of the `evbuffer` itself (and its lock for thread-safe reactors), not
+     *       of the data it held.
+     * @see ReactorBuilder::buffer_pool()
+     */
+    class BufferPool {
+    public:
+        /** @brief Counters describing how well the pool is being used */
+        struct Stats {
+            uint64_t acquired = 0;   /**< Buffers handed out by acquire() */
+            uint64_t hits = 0;       /**< ... of which were recycled rather than newly created */
+            uint64_t returned = 0;   /**< Buffers returned to the pool on destruction */
+            uint64_t discarded = 0;  /**< ... of which were freed because the pool was full */
+            size_t retained = 0;     /**< Buffers currently waiting in the pool */
+
+            /** @brief Fraction (0-1) of acquired buffers that were recycled */
+            [[nodiscard]]
+            auto hit_rate() const noexcept -> double {
+                return acquired == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(acquired);
+            }
+        };
+
+    private:
+        internal::BufferShelf *m_shelf;
+
+    public:
+        /** @brief Create a pool that keeps at most @p capacity buffers for reuse */
+        explicit BufferPool(size_t capacity);
+
+        ~BufferPool() noexcept;
+
+        BufferPool(const BufferPool &) = delete;
+        BufferPool(BufferPool &&) = delete;
+        auto operator=(const BufferPool &) -> BufferPool & = delete;
+        auto operator=(BufferPool &&) -> BufferPool & = delete;
+
+        /** @brief An empty buffer, recycled if the pool has one available */
+        [[nodiscard]]
+        auto acquire() noexcept -> Buffer;
+
+        /** @brief Maximum number of buffers kept for reuse */
+        [[nodiscard]]
+        auto capacity() const noexcept -> size_t;
+
+        [[nodiscard]]
+        auto stats() const noexcept -> Stats;
+    };
+
+} // namespace pembroke
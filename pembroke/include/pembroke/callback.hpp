@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pembroke {
+
+    /* Bytes of inline storage in a Callback by default. Enough for a lambda capturing a
+     * handful of pointers/references (or a `std::function`). */
+    constexpr size_t DefaultCallbackCapacity = 48;
+
+    template<typename Signature, size_t Capacity = DefaultCallbackCapacity>
+    class InplaceCallback;
+
+    /**
+     * @brief
+     * A move-only, type-erased callable that is always stored inline, in @p Capacity bytes,
+     * and never on the heap. Used in place of `std::function` for event callbacks, posted
+     * tasks and the log handler, so that registering a typical lambda does not allocate.
+     *
+     * Callables that do not fit in @p Capacity bytes (or are over-aligned, or may throw when
+     * moved) are rejected at compile-time rather than silently moved to the heap. Capture
+     * less, or capture a pointer to the larger state instead.
+     *
+     * Unlike `std::function` the call operator is non-const, so mutable lambdas are
+     * supported, and the callable may not be copied.
+     *
+     * @note Invoking an empty callback is undefined.
+     */
+    template<typename R, typename... Args, size_t Capacity>
+    class InplaceCallback<R(Args...), Capacity> {
+        using invoke_t = R (*)(void *, Args &&...);
+
+        /* Move and destroy operations. Null for trivially copyable callables (the common
+         * case of lambdas capturing references and pointers) which are relocated with a
+         * plain copy of the storage and need no destruction. */
+        struct Ops {
+            void (*relocate)(void *dst, void *src) noexcept;
+            void (*destroy)(void *) noexcept;
+        };
+
+        template<typename F>
+        struct OpsFor {
+            static auto invoke(void *f, Args &&...args) -> R {
+                return (*static_cast<F *>(f))(std::forward<Args>(args)...);
+            }
+            static void relocate(void *dst, void *src) noexcept {
+                new (dst) F(std::move(*static_cast<F *>(src)));
+                static_cast<F *>(src)->~F();
+            }
+            static void destroy(void *f) noexcept {
+                static_cast<F *>(f)->~F();
+            }
+            static constexpr Ops ops{&relocate, &destroy};
+        };
+
+        template<typename F>
+        static constexpr bool trivial = std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>;
+
+        alignas(std::max_align_t) std::byte m_storage[Capacity];
+        invoke_t m_invoke = nullptr;
+        const Ops *m_ops = nullptr;
+
+    public:
+        InplaceCallback() noexcept = default;
+
+        template<typename F,
+                 typename Fn = std::decay_t<F>,
+                 typename = std::enable_if_t<!std::is_same_v<Fn, InplaceCallback>>>
+        InplaceCallback(F &&f) noexcept(std::is_nothrow_constructible_v<Fn, F>) {  // NOLINT(google-explicit-constructor)
+            static_assert(std::is_invocable_r_v<R, Fn &, Args...>, "Callable does not match the callback signature");
+            static_assert(sizeof(Fn) <= Capacity, "Callable is too large to be stored inline");
+            static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable is over-aligned");
+            static_assert(std::is_nothrow_move_constructible_v<Fn>, "Callable must be nothrow-movable");
+            new (m_storage) Fn(std::forward<F>(f));
+            m_invoke = &OpsFor<Fn>::invoke;
+            if constexpr (!trivial<Fn>) {
+                m_ops = &OpsFor<Fn>::ops;
+            }
+        }
+
+        InplaceCallback(InplaceCallback &&other) noexcept {
+            take(other);
+        }
+
+        auto operator=(InplaceCallback &&other) noexcept -> InplaceCallback & {
+            if (this != &other) {
+                reset();
+                take(other);
+            }
+            return *this;
+        }
+
+        InplaceCallback(const InplaceCallback &) = delete;
+        auto operator=(const InplaceCallback &) -> InplaceCallback & = delete;
+
+        ~InplaceCallback() {
+            reset();
+        }
+
+        /** @brief Invoke the stored callable */
+        auto operator()(Args... args) -> R {
+            return m_invoke(m_storage, std::forward<Args>(args)...);
+        }
+
+        /** @brief True if a callable is stored */
+        explicit operator bool() const noexcept {
+            return m_invoke != nullptr;
+        }
+
+        /** @brief Destroy the stored callable (if any) */
+        void reset() noexcept {
+            if (m_ops != nullptr) {
+                m_ops->destroy(m_storage);
+            }
+            m_invoke = nullptr;
+            m_ops = nullptr;
+        }
+
+    private:
+        void take(InplaceCallback &other) noexcept {
+            if (other.m_invoke == nullptr) {
+                return;
+            }
+            if (other.m_ops != nullptr) {
+                other.m_ops->relocate(m_storage, other.m_storage);
+            } else {
+                std::memcpy(m_storage, other.m_storage, Capacity);
+            }
+            m_invoke = other.m_invoke;
+            m_ops = other.m_ops;
+            other.m_invoke = nullptr;
+            other.m_ops = nullptr;
+        }
+    };
+
+    /** @brief A `void()` InplaceCallback, the callback type of events and posted tasks */
+    using Callback = InplaceCallback<void()>;
+
+} // namespace pembroke
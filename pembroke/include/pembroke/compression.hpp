@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pembroke/buffer.hpp"
+
+struct z_stream_s;
+
+namespace pembroke {
+
+    /** @brief The framing of a compressed stream */
+    enum class CompressionFormat {
+        Gzip,     /**< gzip (RFC 1952), as in `Content-Encoding: gzip` */
+        Deflate,  /**< zlib (RFC 1950), as in `Content-Encoding: deflate` */
+        Raw,      /**< raw deflate (RFC 1951), with no header or checksum */
+    };
+
+    /**
+     * @brief
+     * Streaming (zlib) compression from one Buffer into another.
+     *
+     * Input is consumed segment by segment, straight out of the input buffer, and output is
+     * written into space reserved at the end of the output buffer (see Buffer::reserve()),
+     * so neither side is ever linearized or copied through a temporary string. Working
+     * memory is fixed by zlib (about 256 KiB) whatever the length of the stream, a
+     * multi-gigabyte stream can be compressed a buffer at a time as it is produced.
+     *
+     *     pembroke::Compressor gzip;
+     *     while (auto chunk = next_chunk()) {
+     *         gzip.compress(*chunk, out);
+     *     }
+     *     gzip.finish(out);
+     *
+     * A compressor is not tied to a reactor and may be used from any (single) thread.
+     *
+     * @see Decompressor
+     */
+    class Compressor {
+        z_stream_s *m_stream = nullptr;
+        size_t m_chunk;
+        bool m_finished = false;
+
+    public:
+        /** @brief zlib's default trade-off between speed and size (currently level 6) */
+        static constexpr int DefaultLevel = -1;
+        /** @brief Output space reserved at a time */
+        static constexpr size_t DefaultChunk = 16 * 1024;
+
+        /**
+         * @brief Create a compressor producing @p format at @p level (0-9, or DefaultLevel),
+         *        reserving @p chunk bytes of output space at a time.
+         * @note Throws a ConfigurationException if @p level or @p chunk is invalid, or the
+         *       compression state cannot be allocated.
+         */
+        explicit Compressor(CompressionFormat format = CompressionFormat::Gzip, int level = DefaultLevel,
+                            size_t chunk = DefaultChunk);
+
+        Compressor(Compressor &&other) noexcept;
+        auto operator=(Compressor &&other) noexcept -> Compressor &;
+
+        Compressor(const Compressor &) = delete;
+        auto operator=(const Compressor &) -> Compressor & = delete;
+
+        ~Compressor() noexcept;
+
+        /**
+         * @brief Compress (and drain) all of @p in, appending the output to @p out. zlib
+         *        holds back some output until it has enough input to compress well, see
+         *        flush() and finish().
+         * @returns False (and logs a warning) if the stream has already been finished or
+         *          output space cannot be allocated
+         */
+        auto compress(Buffer &in, Buffer &out) noexcept -> bool;
+
+        /**
+         * @brief Emit everything compressed so far to @p out (a flush point), so the peer can
+         *        decompress all the input given so far. Flushing too often hurts the ratio.
+         * @returns False (and logs a warning) if the stream has already been finished or
+         *          output space cannot be allocated
+         */
+        auto flush(Buffer &out) noexcept -> bool;
+
+        /**
+         * @brief End the stream, writing the remaining output and trailer to @p out. The
+         *        compressor must be reset() before it is used for another stream.
+         * @returns False (and logs a warning) if output space cannot be allocated
+         */
+        auto finish(Buffer &out) noexcept -> bool;
+
+        /** @brief Start a new stream, with the same format and level, reusing the state */
+        void reset() noexcept;
+
+        /** @brief True once finish() has completed the stream */
+        [[nodiscard]]
+        auto finished() const noexcept -> bool {
+            return m_finished;
+        }
+
+        /** @brief Bytes consumed since the stream started */
+        [[nodiscard]]
+        auto total_in() const noexcept -> uint64_t;
+
+        /** @brief Bytes produced since the stream started */
+        [[nodiscard]]
+        auto total_out() const noexcept -> uint64_t;
+
+    private:
+        /* Run deflate over @p in (if any) with the zlib @p flush mode */
+        auto run(Buffer *in, Buffer &out, int flush) noexcept -> bool;
+    };
+
+    /**
+     * @brief
+     * Streaming (zlib) decompression from one Buffer into another, the counterpart of
+     * Compressor.
+     *
+     * Input may arrive in pieces of any size: whatever cannot be decompressed yet stays in
+     * zlib's state (fixed at about 40 KiB) and the call simply produces less output. The
+     * output of each call can be bounded, to protect against input that expands without
+     * limit, in which case the unconsumed input is left in the input buffer for the next
+     * call.
+     *
+     *     if (!inflate.decompress(socket_input, body, 1024 * 1024)) {
+     *         // corrupt stream
+     *     }
+     *     if (inflate.finished()) {
+     *         // body holds the whole payload, anything after the stream is left in socket_input
+     *     }
+     *
+     * @see Compressor
+     */
+    class Decompressor {
+        z_stream_s *m_stream = nullptr;
+        size_t m_chunk;
+        bool m_finished = false;
+        /* The last call filled its output space, inflate may be holding back more output */
+        bool m_full = false;
+
+    public:
+        /**
+         * @brief Create a decompressor for @p format, reserving @p chunk bytes of output
+         *        space at a time.
+         * @note Throws a ConfigurationException if @p chunk is zero or the decompression state
+         *       cannot be allocated.
+         */
+        explicit Decompressor(CompressionFormat format = CompressionFormat::Gzip,
+                              size_t chunk = Compressor::DefaultChunk);
+
+        Decompressor(Decompressor &&other) noexcept;
+        auto operator=(Decompressor &&other) noexcept -> Decompressor &;
+
+        Decompressor(const Decompressor &) = delete;
+        auto operator=(const Decompressor &) -> Decompressor & = delete;
+
+        ~Decompressor() noexcept;
+
+        /**
+         * @brief Decompress (and drain) as much of @p in as possible, appending at most
+         *        @p max_output bytes to @p out. Stops at the end of the stream, leaving any
+         *        bytes after it in @p in.
+         * @returns False (and logs a warning) if the stream is corrupt or output space cannot
+         *          be allocated
+         */
+        auto decompress(Buffer &in, Buffer &out, size_t max_output = Buffer::npos) noexcept -> bool;
+
+        /** @brief Start a new stream, reusing the state */
+        void reset() noexcept;
+
+        /** @brief True once the end of the stream has been decompressed */
+        [[nodiscard]]
+        auto finished() const noexcept -> bool {
+            return m_finished;
+        }
+
+        /** @brief Bytes consumed since the stream started */
+        [[nodiscard]]
+        auto total_in() const noexcept -> uint64_t;
+
+        /** @brief Bytes produced since the stream started */
+        [[nodiscard]]
+        auto total_out() const noexcept -> uint64_t;
+    };
+
+} // namespace pembroke
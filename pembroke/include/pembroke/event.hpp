@@ -3,18 +3,69 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <utility>
 
+#include "pembroke/callback.hpp"
+#include "pembroke/instrumentation.hpp"
 #include "pembroke/libevent/forward_decls.hpp"
 #include "pembroke/internal/lang_macros.hpp"
 
 namespace pembroke {
 
+    class Reactor;
+
     class Event {
+        friend class Reactor;
     public:
+        /** @brief Priority of events registered without one: libevent's default (the middle queue) */
+        static constexpr int DefaultPriority = -1;
+
         virtual ~Event() = default;
 
         [[nodiscard]]
         virtual auto register_event(event_base &base) noexcept -> bool PURE;
+
+        /**
+         * @brief Register the event with a reactor. By default this registers directly on the
+         *        reactor's event-base, event types that can make use of other reactor facilities
+         *        (such as the TimingWheel) override this.
+         */
+        [[nodiscard]]
+        virtual auto register_event(Reactor &reactor) noexcept -> bool;
+
+    protected:
+        /* Priority given to Reactor::register_event(), applied by event types to the libevent
+         * events they create (see apply_priority()) */
+        int m_priority = DefaultPriority;
+
+        /* Instrumentation of the reactor the event was registered with, if it has any */
+        Instrumentation *m_instrumentation = nullptr;
+
+        /** @brief Access the underlying event-base of a reactor */
+        [[nodiscard]]
+        static auto base_of(Reactor &reactor) noexcept -> event_base &;
+
+        /**
+         * @brief Set the priority the event was registered with on a (non-active) libevent
+         *        event. A no-op for events registered without a priority.
+         * @returns False if the priority is not valid for the event's base
+         */
+        [[nodiscard]]
+        auto apply_priority(::event *ev) const noexcept -> bool;
+
+        /** @brief Run @p callback with @p args, timing it if the event's reactor is instrumented */
+        template<typename F, typename... Args>
+        void run_callback(F &callback, CallbackKind kind, Args &&...args) noexcept {
+            // copied first, the callback is free to destroy or move the event
+            auto *instrumentation = m_instrumentation;
+            if (instrumentation == nullptr) {
+                callback(std::forward<Args>(args)...);
+                return;
+            }
+            auto start = instrumentation->callback_started();
+            callback(std::forward<Args>(args)...);
+            instrumentation->callback_finished(kind, start);
+        }
     };
 
     class EventCancellation {
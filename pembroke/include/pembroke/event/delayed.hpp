@@ -1,11 +1,12 @@
 #pragma once
 
 #include <chrono>
-#include <functional>
 #include <utility>
 
+#include "pembroke/callback.hpp"
 #include "pembroke/event.hpp"
 #include "pembroke/libevent/forward_decls.hpp"
+#include "pembroke/timing_wheel.hpp"
 #include "pembroke/util.hpp"
 
 namespace pembroke::event {
@@ -16,23 +17,31 @@ namespace pembroke::event {
      * 
      * Useful for defering actions, implementing timeout behaviors for asynchronous
      * events, or building more complex event types.
+     *
+     * When registered with a reactor that declared the event's delay as a common timeout,
+     * the event is queued on libevent's common-timeout queue rather than the timer heap.
+     *
+     * @see ReactorBuilder::common_timeout()
      */
     class DelayedEvent final
         : public Event,
           public EventCancellation
     {
         duration m_delay;
-        std::function<void()> m_callback;
+        std::chrono::steady_clock::time_point m_deadline{};  // only tracked when instrumented
+        Callback m_callback;
         struct event *m_timer_event = nullptr;
         bool m_canceled = false;
+        TimingWheel::Entry m_wheel_entry{DelayedEvent::run_wheel_cb, this};
+        bool m_use_timing_wheel = false;
 
     public:
 
         /**
          * Construct a Delayed event that executes ``callback`` after an initial duration
-         * ``delay``.
+         * ``delay``. The callback is stored inline (see pembroke::Callback).
          */
-        DelayedEvent(duration delay, std::function<void()> callback)
+        DelayedEvent(duration delay, Callback callback)
             : m_delay(delay), m_callback(std::move(callback)) {}
 
         ~DelayedEvent() override;
@@ -43,9 +52,23 @@ namespace pembroke::event {
         auto operator=(const DelayedEvent&) -> DelayedEvent& = delete;
         auto operator=(DelayedEvent &&event) noexcept -> DelayedEvent&;
 
+        /**
+         * Schedule the event on the reactor's TimingWheel rather than libevent's timer heap.
+         * Has no effect when registered with a reactor that has no wheel.
+         *
+         * @note Must be set before the event is registered. On a reactor running in another
+         *       thread the event must then be registered and cancelled from that thread (see
+         *       Reactor::post()).
+         * @see ReactorBuilder::timing_wheel()
+         */
+        auto use_timing_wheel(bool val = true) noexcept -> DelayedEvent &;
+
         [[nodiscard]]
         auto register_event(event_base &base) noexcept -> bool override;
 
+        [[nodiscard]]
+        auto register_event(Reactor &reactor) noexcept -> bool override;
+
         [[nodiscard]]
         auto cancel() noexcept -> bool override;
 
@@ -54,6 +77,10 @@ namespace pembroke::event {
 
     private:
         static void run_timer_cb(int, short, void* cb) noexcept;
+        static void run_wheel_cb(void *cb) noexcept;
+        auto registrable() noexcept -> bool;
+        void fire() noexcept;
+        auto add_timer(event_base &base, const timeval *common) noexcept -> bool;
         auto close_timer() noexcept -> bool;
     };
 
@@ -1,15 +1,27 @@
 #pragma once
 
 #include <chrono>
-#include <functional>
 #include <utility>
 
+#include "pembroke/callback.hpp"
 #include "pembroke/event.hpp"
 #include "pembroke/libevent/forward_decls.hpp"
+#include "pembroke/timing_wheel.hpp"
 #include "pembroke/util.hpp"
 
 namespace pembroke::event {
 
+    /**
+     * @brief How a fixed-rate TimerEvent handles periods that were missed entirely because the
+     *        callback (or the reactor) ran long.
+     * @see TimerEvent::fixed_rate()
+     */
+    enum class MissedPolicy {
+        Skip,      /**< Drop missed periods and wait for the next deadline on the schedule */
+        Coalesce,  /**< Run once, immediately, in place of all missed periods */
+        CatchUp,   /**< Run once per missed period, back-to-back, until caught up */
+    };
+
     /**
      * A repeating event that triggers every user-defined interval
      * 
@@ -28,6 +40,23 @@ namespace pembroke::event {
      * 
      * The 5s timer does not start until the callback completes. So in this scenario, the times
      * at which a task starts may be 7s apart each time.
+     *
+     * For tasks that need to run at a steady rate (heartbeats, metrics flushing) use
+     * `fixed_rate()`. The timer is then scheduled against absolute deadlines (`start + n *
+     * interval` on the monotonic clock) so the same 5s timer with a 2s callback starts every 5s
+     * without drifting:
+     *
+     *     |**|---|**|---|**|---|**|...
+     *
+     * In either mode `lateness()` reports how far behind its deadline the current firing is,
+     * which is a direct measure of reactor loop lag.
+     *
+     * When registered with a reactor that declared the timer's interval (or initial delay) as a
+     * common timeout, fixed-delay firings are queued on libevent's common-timeout queue rather
+     * than the timer heap. Fixed-rate timers re-arm with varying delays and always use the heap.
+     *
+     * The underlying libevent timer is allocated once, on first registration, and re-armed in
+     * place after every firing. A running timer performs no heap allocations.
      */
     class TimerEvent final
         : public Event,
@@ -35,10 +64,18 @@ namespace pembroke::event {
     {
         duration m_initial_delay;
         duration m_interval;
-        std::function<void()> m_callback;
+        Callback m_callback;
         struct event *m_timer_event = nullptr;
         bool m_canceled = false;
         bool m_first_run = true;
+        TimingWheel::Entry m_wheel_entry{TimerEvent::run_wheel_cb, this};
+        TimingWheel *m_wheel = nullptr;
+        const timeval *m_common_interval = nullptr;
+        bool m_use_timing_wheel = false;
+        bool m_fixed_rate = false;
+        MissedPolicy m_missed_policy = MissedPolicy::Skip;
+        std::chrono::steady_clock::time_point m_deadline{};
+        duration m_lateness = no_delay;
 
     public:
 
@@ -46,14 +83,14 @@ namespace pembroke::event {
          * @brief Construct a Timer that executes ``callback`` immediately and then
          * every ``interval``.
          */
-        TimerEvent(duration interval, std::function<void()> callback)
+        TimerEvent(duration interval, Callback callback)
             : m_interval(interval), m_callback(std::move(callback)), m_initial_delay(no_delay) {}
 
         /**
          * @brief Construct a timer that execute ``callback`` after an initial duration of
          * ``initial_delay` and then every ``interval``.
          */
-        TimerEvent(duration initial_delay, duration interval, std::function<void()> callback)
+        TimerEvent(duration initial_delay, duration interval, Callback callback)
             : m_interval(interval), m_initial_delay(initial_delay), m_callback(std::move(callback)) {}
 
         ~TimerEvent() override;
@@ -64,9 +101,40 @@ namespace pembroke::event {
         auto operator=(const TimerEvent&) -> TimerEvent& = delete;
         auto operator=(TimerEvent &&event) noexcept -> TimerEvent&;
 
+        /**
+         * @brief Schedule the timer on the reactor's TimingWheel rather than libevent's timer
+         * heap. Has no effect when registered with a reactor that has no wheel.
+         *
+         * @note Must be set before the timer is registered. On a reactor running in another
+         *       thread the timer must then be registered and cancelled from that thread (see
+         *       Reactor::post()).
+         * @see ReactorBuilder::timing_wheel()
+         */
+        auto use_timing_wheel(bool val = true) noexcept -> TimerEvent &;
+
+        /**
+         * @brief Run the timer at a fixed rate rather than with a fixed delay between runs.
+         * Deadlines are computed from the time the timer was registered, so the time spent in
+         * the callback does not push back the next run. @p policy decides what happens when
+         * one or more deadlines have already passed by the time the callback returns.
+         *
+         * @note Must be set before the timer is registered.
+         */
+        auto fixed_rate(MissedPolicy policy = MissedPolicy::Skip) noexcept -> TimerEvent &;
+
+        /**
+         * @brief How late the current (or most recent) firing ran, compared to the deadline it
+         * was scheduled for. Meaningful from within the callback.
+         */
+        [[nodiscard]]
+        auto lateness() const noexcept -> duration;
+
         [[nodiscard]]
         auto register_event(event_base &base) noexcept -> bool override;
 
+        [[nodiscard]]
+        auto register_event(Reactor &reactor) noexcept -> bool override;
+
         [[nodiscard]]
         auto cancel() noexcept -> bool override;
 
@@ -75,6 +143,12 @@ namespace pembroke::event {
 
     private:
         static void run_timer_cb(int, short, void* cb) noexcept;
+        static void run_wheel_cb(void *cb) noexcept;
+        auto registrable() noexcept -> bool;
+        auto attach(event_base &base) noexcept -> bool;
+        auto arm(duration delay, const timeval *common = nullptr) noexcept -> bool;
+        void start_firing() noexcept;
+        auto next_delay() noexcept -> duration;
         auto close_timer() noexcept -> bool;
     };
 
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "pembroke/libevent/forward_decls.hpp"
+
+namespace pembroke {
+
+    /**
+     * @brief
+     * A region of a file that can be added to any number of Buffers without reading it into
+     * memory, a wrapper over libevent's `evbuffer_file_segment`.
+     *
+     * libevent decides how the file is delivered: a buffer that drains to a socket (see
+     * Buffer::drains_to_fd()) sends the segment with `sendfile`, any other buffer maps it
+     * with `mmap` (falling back to reading it, for files that cannot be mapped). Either way
+     * the file is only touched once the bytes are actually needed.
+     *
+     * The segment is reference-counted by libevent: each Buffer it is added to keeps it
+     * (and its file-descriptor) open, so a FileSegment may be destroyed while buffers still
+     * hold its contents.
+     *
+     * @see Buffer::add_file()
+     * @see FileSegmentCache
+     */
+    class FileSegment {
+        evbuffer_file_segment *m_segment = nullptr;
+        int64_t m_length = 0;
+
+    public:
+        /** @brief Construct an empty (invalid) segment */
+        FileSegment() noexcept = default;
+
+        /**
+         * @brief Open @p length bytes of the file at @p path, starting at @p offset. A
+         *        negative @p length means "to the end of the file".
+         * @returns An invalid segment (and logs a warning) if the file cannot be opened
+         */
+        [[nodiscard]]
+        static auto open(const std::string &path, int64_t offset = 0, int64_t length = -1) noexcept -> FileSegment;
+
+        /**
+         * @brief Create a segment over an already open file-descriptor. The segment takes
+         *        ownership of @p fd, closing it once it is released (or on failure).
+         * @returns An invalid segment (and logs a warning) if the segment cannot be created
+         */
+        [[nodiscard]]
+        static auto adopt(int fd, int64_t offset = 0, int64_t length = -1) noexcept -> FileSegment;
+
+        FileSegment(FileSegment &&other) noexcept;
+        auto operator=(FileSegment &&other) noexcept -> FileSegment &;
+
+        FileSegment(const FileSegment &) = delete;
+        auto operator=(const FileSegment &) -> FileSegment & = delete;
+
+        ~FileSegment() noexcept;
+
+        /** @brief True if the segment was opened successfully */
+        explicit operator bool() const noexcept {
+            return m_segment != nullptr;
+        }
+
+        /** @brief Number of bytes of the file covered by the segment */
+        [[nodiscard]]
+        auto length() const noexcept -> int64_t {
+            return m_length;
+        }
+
+        /** @brief The underlying libevent segment, or nullptr if the segment is invalid */
+        [[nodiscard]]
+        auto underlying() const noexcept -> evbuffer_file_segment * {
+            return m_segment;
+        }
+    };
+
+    /**
+     * @brief
+     * A per-reactor, least-recently-used cache of whole-file segments, keyed by path.
+     *
+     * Serving the same static files over and over needs an `open`, `fstat` and segment for
+     * each response, the cache replaces those with a single `stat` to check that the file
+     * has not been replaced or modified (by its inode, size and modification time) since it
+     * was opened. Stale entries are re-opened transparently.
+     *
+     * Like the Reactor that owns it, a cache is only safe to use from the reactor's thread.
+     *
+     * @note Files modified in place within the resolution of their modification time (or
+     *       without changing it) are not detected.
+     * @see ReactorBuilder::file_segment_cache()
+     * @see Reactor::file_segments()
+     */
+    class FileSegmentCache {
+        struct Entry {
+            FileSegment segment;
+            uint64_t device;
+            uint64_t inode;
+            int64_t size;
+            timespec mtime;
+            std::list<std::string>::iterator position;
+        };
+
+        size_t m_capacity;
+        std::unordered_map<std::string, Entry> m_entries;
+        /* Paths from most to least recently used */
+        std::list<std::string> m_order;
+
+    public:
+        /** @brief Create a cache holding at most @p capacity (non-zero) open files */
+        explicit FileSegmentCache(size_t capacity) noexcept;
+
+        /**
+         * @brief The segment for the whole of the file at @p path, opening (or re-opening) it
+         *        if it is not cached or has changed.
+         *
+         *     if (auto *file = reactor.file_segments()->get(path)) {
+         *         response.add_file(*file);
+         *     }
+         *
+         * @note The returned segment is owned by the cache and is only valid until the next
+         *       call to get() or clear(). Add it to a Buffer to keep its contents.
+         * @returns nullptr (and logs a warning) if the file cannot be opened
+         */
+        [[nodiscard]]
+        auto get(const std::string &path) noexcept -> const FileSegment *;
+
+        /** @brief Drop the cached segment for @p path (if any) */
+        void evict(const std::string &path) noexcept;
+
+        /** @brief Drop every cached segment */
+        void clear() noexcept;
+
+        /** @brief Number of files currently cached */
+        [[nodiscard]]
+        auto size() const noexcept -> size_t;
+
+        /** @brief Maximum number of files cached */
+        [[nodiscard]]
+        auto capacity() const noexcept -> size_t;
+    };
+
+} // namespace pembroke
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pembroke {
+
+    /**
+     * @brief A point-in-time copy of a Histogram, safe to inspect from any thread.
+     * @see Histogram::snapshot()
+     */
+    class HistogramSnapshot {
+        friend class Histogram;
+
+        std::vector<uint64_t> m_counts;
+        uint64_t m_count = 0;
+        uint64_t m_sum = 0;
+        uint64_t m_min = 0;
+        uint64_t m_max = 0;
+
+    public:
+        /** @brief Number of values recorded */
+        [[nodiscard]]
+        auto count() const noexcept -> uint64_t;
+
+        /** @brief Smallest value recorded (zero if nothing was recorded) */
+        [[nodiscard]]
+        auto min() const noexcept -> std::chrono::nanoseconds;
+
+        /** @brief Largest value recorded (zero if nothing was recorded) */
+        [[nodiscard]]
+        auto max() const noexcept -> std::chrono::nanoseconds;
+
+        /** @brief Mean of the values recorded (zero if nothing was recorded) */
+        [[nodiscard]]
+        auto mean() const noexcept -> std::chrono::nanoseconds;
+
+        /**
+         * @brief The value at percentile @p p (0-100), accurate to the histogram's precision.
+         *        Zero if nothing was recorded.
+         */
+        [[nodiscard]]
+        auto percentile(double p) const noexcept -> std::chrono::nanoseconds;
+    };
+
+    /**
+     * @brief
+     * A fixed-size, log-linear histogram of durations in the style of HdrHistogram. Every
+     * power-of-two range is split into 32 linear buckets, bounding the error of any reported
+     * value to ~3%, over a range of 1ns to ~73 minutes (larger values are clamped).
+     *
+     * Recording is lock-free and allocation-free: a handful of relaxed atomic loads and stores.
+     * A histogram has a single writer (the reactor thread) but may be snapshotted from any
+     * number of threads while it is being written to.
+     */
+    class Histogram {
+    public:
+        static constexpr unsigned SubBucketBits = 6;
+        static constexpr unsigned MaxValueBits = 42;
+        static constexpr size_t SubBuckets = size_t{1} << SubBucketBits;
+        static constexpr size_t HalfSubBuckets = SubBuckets / 2;
+        static constexpr size_t BucketCount = SubBuckets + (MaxValueBits - SubBucketBits) * HalfSubBuckets;
+        static constexpr uint64_t MaxValue = (uint64_t{1} << MaxValueBits) - 1;
+
+    private:
+        std::array<std::atomic<uint64_t>, BucketCount> m_counts{};
+        std::atomic<uint64_t> m_count{0};
+        std::atomic<uint64_t> m_sum{0};
+        std::atomic<uint64_t> m_min{UINT64_MAX};
+        std::atomic<uint64_t> m_max{0};
+
+    public:
+        Histogram() noexcept = default;
+
+        Histogram(const Histogram &) = delete;
+        Histogram(Histogram &&) = delete;
+        auto operator=(const Histogram &) -> Histogram & = delete;
+        auto operator=(Histogram &&) -> Histogram & = delete;
+        ~Histogram() = default;
+
+        /** @brief Record a single value. Negative durations are recorded as zero. */
+        void record(std::chrono::nanoseconds value) noexcept;
+
+        /** @brief Copy the current contents of the histogram */
+        [[nodiscard]]
+        auto snapshot() const -> HistogramSnapshot;
+
+        /** @brief Index of the bucket that counts @p value */
+        [[nodiscard]]
+        static auto bucket_of(uint64_t value) noexcept -> size_t;
+
+        /** @brief Largest value counted by the bucket at @p index */
+        [[nodiscard]]
+        static auto bucket_max(size_t index) noexcept -> uint64_t;
+    };
+
+    /**
+     * @brief The kinds of callback timed separately by Instrumentation.
+     */
+    enum class CallbackKind : size_t {
+        Delayed,  /**< DelayedEvent callbacks */
+        Timer,    /**< TimerEvent callbacks */
+        Task,     /**< Tasks handed to the reactor with Reactor::post() */
+        Io,       /**< net::Listener and net::Connection callbacks */
+    };
+
+    constexpr size_t CallbackKinds = 4;
+
+    /**
+     * @brief
+     * Loop and callback timings for a single Reactor, enabled with
+     * `ReactorBuilder::instrument()`.
+     *
+     * Three things are measured:
+     *   - **ticks**: how long each batch of ready callbacks kept the reactor busy, from the
+     *     start of the first callback until the event-loop returned to waiting
+     *   - **callbacks**: how long each callback ran, by kind of event
+     *   - **timer lateness**: how far behind their deadlines timers and delayed events ran,
+     *     a direct measure of loop lag
+     *
+     * Reactors built without instrumentation carry no Instrumentation at all, events check a
+     * single null pointer before running their callback.
+     *
+     * @note `snapshot()` may be called from any thread, everything else is called by the
+     *       reactor (and events) on the reactor's thread.
+     */
+    class Instrumentation {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        /** @brief A point-in-time copy of all of a reactor's histograms */
+        struct Snapshot {
+            HistogramSnapshot ticks;
+            std::array<HistogramSnapshot, CallbackKinds> callbacks;
+            HistogramSnapshot timer_lateness;
+
+            /** @brief Callback durations of one kind of event */
+            [[nodiscard]]
+            auto callbacks_of(CallbackKind kind) const noexcept -> const HistogramSnapshot &;
+        };
+
+    private:
+        Histogram m_ticks;
+        std::array<Histogram, CallbackKinds> m_callbacks;
+        Histogram m_timer_lateness;
+
+        /* Reactor-thread state for the tick in progress */
+        bool m_in_tick = false;
+        clock::time_point m_tick_start{};
+
+    public:
+        Instrumentation() noexcept = default;
+
+        /** @brief Copy every histogram. Safe to call from any thread. */
+        [[nodiscard]]
+        auto snapshot() const -> Snapshot;
+
+        /** @brief Mark the start of a callback, opening a tick if none is in progress */
+        [[nodiscard]]
+        auto callback_started() noexcept -> clock::time_point;
+
+        /** @brief Record the duration of a callback started at @p start */
+        void callback_finished(CallbackKind kind, clock::time_point start) noexcept;
+
+        /** @brief Record how far behind its deadline a timer fired */
+        void timer_fired(std::chrono::nanoseconds lateness) noexcept;
+
+        /** @brief Close the tick in progress (if any), called when the event-loop returns */
+        void tick_finished() noexcept;
+    };
+
+} // namespace pembroke
@@ -13,6 +13,12 @@ extern "C" {
     struct event_base;
     struct event;
     struct evbuffer;
+    struct timeval;
+    struct evbuffer_file_segment;
+    struct bufferevent;
+    struct evconnlistener;
+    struct evbuffer_cb_entry;
+    struct evbuffer_cb_info;
 
     // ---
     // Functions
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <functional>
 #include <string_view>
 
+#include "pembroke/callback.hpp"
+
 namespace pembroke::logger {
 
     enum class Level {
@@ -15,26 +16,16 @@ namespace pembroke::logger {
     };
 
     /**
-     * @brief Assign a global log-message handler for all internal pembroke messages
+     * @brief A log-message handler. Any callable taking a level and message that fits in
+     *        inline storage (see pembroke::InplaceCallback) converts to a handler.
      */
-    void register_handler(const std::function<void(Level, std::string_view)> &f);
+    using Handler = InplaceCallback<void(Level, std::string_view)>;
 
     /**
      * @brief Register a handler that will receive all of the log messages produced by
-     *        the pembroke library.
-     * @note  This is a utility wrapper for the non-generic `register_handler` function
-     *        which is constructed with a std::function.
+     *        the pembroke library, replacing any previous handler.
      */
-    template<typename generic_functor>
-    void register_handler(generic_functor f) {
-        static_assert(
-            std::is_constructible_v<
-                std::function<void(Level, std::string_view)>,
-                generic_functor>,
-            "Invalid callable given to 'register_handler'");
-        std::function<void(Level, std::string_view)> func {f};
-        register_handler(func);
-    }
+    void register_handler(Handler f);
 
 
 } // namespace pembroke::logger
\ No newline at end of file
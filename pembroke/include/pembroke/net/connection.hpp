@@ -0,0 +1,295 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "pembroke/buffer.hpp"
+#include "pembroke/callback.hpp"
+#include "pembroke/instrumentation.hpp"
+#include "pembroke/libevent/forward_decls.hpp"
+#include "pembroke/util.hpp"
+
+namespace pembroke {
+    class Reactor;
+}
+
+namespace pembroke::net {
+
+    class Connection;
+    class Listener;
+    class Splice;
+
+    /** @brief Why a Connection was closed, given to its close callback */
+    enum class CloseReason {
+        Eof,      /**< The peer closed the connection */
+        Error,    /**< A socket error (or a failed connect), see `errno` */
+        Timeout,  /**< The connection was idle for longer than its idle timeout */
+    };
+
+    using ConnectionCallback = InplaceCallback<void(Connection &)>;
+    using CloseCallback = InplaceCallback<void(Connection &, CloseReason)>;
+    using BackpressureCallback = InplaceCallback<void(Connection &, bool)>;
+
+    /**
+     * @brief
+     * A TCP (or unix) stream connection on a Reactor, wrapping a libevent `bufferevent`.
+     *
+     * Data read from the socket is collected in input() and data added to output() is
+     * written out as the socket becomes writable, both are plain Buffers, so everything
+     * Buffer offers (segment iteration, search, binary decoding, zero-copy moves) works on
+     * the socket's data directly:
+     *
+     *     connection.on_read([](pembroke::net::Connection &c) {
+     *         c.output().append(std::move(c.input()));  // echo
+     *     });
+     *
+     * Connections are accepted by a Listener, opened with connect(), or adopted from an
+     * already connected socket. The read callback runs whenever new data has been read,
+     * the write callback whenever the output has been completely written out, and the
+     * close callback once, when the peer closes the connection, an error occurs or the
+     * connection times out. The connection has already been closed by the time the close
+     * callback runs, which is free to destroy the Connection. So are the other callbacks,
+     * which are taken out of the connection while they run (and put back afterwards, unless
+     * they were replaced), so their captures outlive a connection destroyed or moved by them.
+     *
+     * @note Like everything on a Reactor, a connection is only safe to use from the
+     *       reactor's thread and must be destroyed before the reactor.
+     * @see Listener
+     */
+    class Connection {
+        friend class Listener;
+        friend class Splice;
+
+        bufferevent *m_bev = nullptr;
+        /* Views of the bufferevent's own buffers */
+        Buffer m_input = Buffer::borrow(nullptr);
+        Buffer m_output = Buffer::borrow(nullptr);
+        Reactor *m_reactor = nullptr;
+        Instrumentation *m_instrumentation = nullptr;
+        ConnectionCallback m_on_read;
+        ConnectionCallback m_on_write;
+        CloseCallback m_on_close;
+        BackpressureCallback m_on_backpressure;
+
+        /* Track every change to the buffers, for the watermarks and the reactor's gauge */
+        evbuffer_cb_entry *m_input_cb = nullptr;
+        evbuffer_cb_entry *m_output_cb = nullptr;
+        size_t m_low_watermark = 0;
+        size_t m_high_watermark = 0;
+        bool m_congested = false;
+        size_t m_input_limit = 0;
+        bool m_input_full = false;
+        bool m_reading_paused = false;
+
+        /* A callback taken out of the connection while it runs (see run_owned()), kept
+         * pointing at the connection as it moves, or at nullptr once it is destroyed */
+        struct RunningCallback {
+            Connection *connection;
+            RunningCallback *outer;
+        };
+        RunningCallback *m_running = nullptr;
+
+    public:
+        /** @brief Construct a closed connection */
+        Connection() noexcept = default;
+
+        /**
+         * @brief Open a connection to @p address (`"host:port"`, `"[ipv6]:port"`), without
+         *        blocking. Data may be added to the output straight away, it is sent once the
+         *        connection is established. A connect that fails later is reported to the
+         *        close callback with CloseReason::Error.
+         * @returns A closed connection (and logs a warning) if @p address cannot be parsed
+         *          or the connect fails immediately
+         */
+        [[nodiscard]]
+        static auto connect(Reactor &reactor, const std::string &address) noexcept -> Connection;
+
+        /**
+         * @brief Take ownership of an already connected socket @p fd (which is made
+         *        non-blocking), for example one accepted on another thread and handed over
+         *        with Reactor::post().
+         * @returns A closed connection (and logs a warning, closing @p fd) on failure
+         */
+        [[nodiscard]]
+        static auto adopt(Reactor &reactor, int fd) noexcept -> Connection;
+
+        Connection(Connection &&other) noexcept;
+        auto operator=(Connection &&other) noexcept -> Connection &;
+
+        Connection(const Connection &) = delete;
+        auto operator=(const Connection &) -> Connection & = delete;
+
+        /** @brief Closes the connection, without running the close callback */
+        ~Connection() noexcept;
+
+        /** @brief True until the connection has been closed */
+        explicit operator bool() const noexcept {
+            return m_bev != nullptr;
+        }
+
+        /**
+         * @brief Data read from the socket and not yet consumed. Drain (or move) what has
+         *        been handled, whatever is left is kept for the next read callback.
+         * @note  The buffer belongs to the connection, it must not be moved-from itself.
+         */
+        [[nodiscard]]
+        auto input() noexcept -> Buffer & {
+            return m_input;
+        }
+
+        /**
+         * @brief Data waiting to be written to the socket. Anything added is written out
+         *        (without further copies) as the socket becomes writable.
+         * @note  The buffer belongs to the connection, it must not be moved-from itself.
+         */
+        [[nodiscard]]
+        auto output() noexcept -> Buffer & {
+            return m_output;
+        }
+
+        /** @brief Run @p callback whenever new data has been read into input() */
+        auto on_read(ConnectionCallback callback) noexcept -> Connection &;
+
+        /** @brief Run @p callback whenever output() has been completely written out */
+        auto on_write(ConnectionCallback callback) noexcept -> Connection &;
+
+        /** @brief Run @p callback once, when the connection is closed by the peer, an error or a timeout */
+        auto on_close(CloseCallback callback) noexcept -> Connection &;
+
+        // ---
+        // Flow Control
+        // ---
+
+        /**
+         * @brief
+         * Watch the output for a slow peer: once @p high bytes or more are waiting to be
+         * written the connection becomes congested() and the backpressure callback runs with
+         * `true`, once the output has drained to @p low bytes or fewer it runs again with
+         * `false`. A @p high of 0 disables the watermarks (the default).
+         *
+         * The callback runs as soon as a watermark is crossed, from within whatever added to
+         * or wrote out the output, and is the place to pause (and later resume) the sources
+         * feeding this connection:
+         *
+         *     downstream.output_watermarks(64 * 1024, 1024 * 1024);
+         *     downstream.on_backpressure([&](pembroke::net::Connection &, bool congested) {
+         *         congested ? upstream.pause_reading() : upstream.resume_reading();
+         *     });
+         *
+         * @returns False if the connection is closed or @p low is above @p high
+         */
+        auto output_watermarks(size_t low, size_t high) noexcept -> bool;
+
+        /**
+         * @brief Run @p callback when the output crosses a watermark, with whether the
+         *        connection is now congested.
+         * @note  The callback must not close or destroy the connection.
+         * @see   Connection::output_watermarks()
+         */
+        auto on_backpressure(BackpressureCallback callback) noexcept -> Connection &;
+
+        /** @brief True while the output is above its high watermark, until it drains to the low one */
+        [[nodiscard]]
+        auto congested() const noexcept -> bool {
+            return m_congested;
+        }
+
+        /**
+         * @brief Stop reading from the socket once input() holds @p max bytes or more (it may
+         *        overshoot by one read), until enough has been consumed to fall below it, so a
+         *        fast peer cannot grow it without bound. 0 removes the limit (the default).
+         * @returns False if the connection is closed
+         */
+        auto input_limit(size_t max) noexcept -> bool;
+
+        /** @brief Stop reading from the socket (the peer is held back by TCP flow control) */
+        void pause_reading() noexcept;
+
+        /** @brief Resume reading after pause_reading() */
+        void resume_reading() noexcept;
+
+        /** @brief Bytes held in the connection's input and output, not yet consumed or written */
+        [[nodiscard]]
+        auto buffered() const noexcept -> size_t {
+            return m_input.length() + m_output.length();
+        }
+
+        /**
+         * @brief
+         * Close the connection if nothing has been read for @p read_timeout, or a pending
+         * write has made no progress for @p write_timeout. A non-positive timeout disables
+         * it (the default).
+         *
+         * Timeouts declared with ReactorBuilder::common_timeout() are placed on libevent's
+         * common-timeout queues, which keeps re-arming them on every read and write O(1) for
+         * servers with many connections.
+         *
+         * @returns False if the timeouts cannot be set
+         */
+        auto idle_timeout(duration read_timeout, duration write_timeout) noexcept -> bool;
+
+        /** @see Connection::idle_timeout(duration, duration) */
+        auto idle_timeout(duration timeout) noexcept -> bool {
+            return idle_timeout(timeout, timeout);
+        }
+
+        /**
+         * @brief Close the connection immediately, without running the close callback. Output
+         *        that has not been written yet is discarded.
+         */
+        void close() noexcept;
+
+        /** @brief The connection's socket, or -1 once closed */
+        [[nodiscard]]
+        auto fd() const noexcept -> int;
+
+        /** @brief The underlying bufferevent, or nullptr once closed */
+        [[nodiscard]]
+        auto underlying() const noexcept -> bufferevent * {
+            return m_bev;
+        }
+
+    private:
+        /* Wrap a new bufferevent over @p fd (-1 for a connection yet to connect) */
+        static auto open(event_base &base, Reactor *reactor, int fd, int priority) noexcept -> Connection;
+
+        /* Point the bufferevent's callbacks at this object */
+        void bind() noexcept;
+
+        /* Close the connection but keep its socket, which is returned (or -1 if closed). Data
+         * read but not consumed is moved to @p input, data not yet written to @p output. */
+        auto release(Buffer &input, Buffer &output) noexcept -> int;
+
+        /* Stop or resume reading as the input crosses its limit */
+        void update_input_limit() noexcept;
+
+        /* Run @p callback, timing it if the reactor is instrumented */
+        template<typename F, typename... Args>
+        void run_callback(F &callback, Args &&...args) noexcept {
+            // copied first, the callback is free to destroy or move the connection
+            auto *instrumentation = m_instrumentation;
+            if (instrumentation == nullptr) {
+                callback(std::forward<Args>(args)...);
+                return;
+            }
+            auto start = instrumentation->callback_started();
+            callback(std::forward<Args>(args)...);
+            instrumentation->callback_finished(CallbackKind::Io, start);
+        }
+
+        /* Run the persistent @p callback, taken out of the connection while it runs so that it
+         * may destroy or move the connection, and put back afterwards unless replaced */
+        template<typename F, typename... Args>
+        void run_owned(F Connection::*callback, Args &&...args) noexcept;
+
+        /* Hand the callbacks running on this connection to @p to (nullptr once destroyed) */
+        void move_running(Connection *to) noexcept;
+
+        static void read_cb(bufferevent *bev, void *arg) noexcept;
+        static void write_cb(bufferevent *bev, void *arg) noexcept;
+        static void event_cb(bufferevent *bev, short what, void *arg) noexcept;
+        static void buffer_cb(evbuffer *buffer, const evbuffer_cb_info *info, void *arg) noexcept;
+    };
+
+} // namespace pembroke::net
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "pembroke/callback.hpp"
+#include "pembroke/event.hpp"
+#include "pembroke/libevent/forward_decls.hpp"
+#include "pembroke/net/connection.hpp"
+
+extern "C" {
+struct sockaddr;
+}
+
+namespace pembroke::net {
+
+    class ShardedListener;
+
+    using AcceptCallback = InplaceCallback<void(Connection &&)>;
+
+    /**
+     * @brief
+     * A listening TCP socket, wrapping a libevent `evconnlistener`. Register it with a
+     * Reactor to start accepting, each accepted socket is handed to the accept callback as
+     * a Connection on the same reactor (and at the listener's priority):
+     *
+     *     std::vector<std::unique_ptr<pembroke::net::Connection>> connections;
+     *     pembroke::net::Listener listener("0.0.0.0:8080", [&](pembroke::net::Connection &&c) {
+     *         auto &conn = *connections.emplace_back(std::make_unique<pembroke::net::Connection>(std::move(c)));
+     *         conn.on_read([](auto &c) { c.output().append(std::move(c.input())); });
+     *     });
+     *     reactor->register_event(listener);
+     *
+     * The accept callback owns the new connection: it is closed as soon as the callback
+     * returns unless it has been moved somewhere that outlives the callback.
+     *
+     * @note A listener must not be moved once registered, and must be destroyed before its
+     *       reactor.
+     * @see Connection
+     */
+    class Listener final : public Event {
+        friend class ShardedListener;
+
+        std::string m_address;
+        AcceptCallback m_on_accept;
+        /* When set, accepted sockets are handed over as-is instead of as Connections */
+        InplaceCallback<void(int)> m_on_accept_fd;
+        evconnlistener *m_listener = nullptr;
+        event_base *m_base = nullptr;
+        /* Activated after the first accept of a batch, to end it (see accept_batch()) */
+        ::event *m_batch_end = nullptr;
+        Reactor *m_reactor = nullptr;
+        int m_backlog = -1;
+        bool m_reuse_port = false;
+        size_t m_accept_batch = 0;
+        size_t m_accepted = 0;
+        /* Cleared by ShardedListener, which enables every shard's socket once all are bound */
+        bool m_enable_on_listen = true;
+
+    public:
+        /**
+         * @brief Listen on @p address (`"host:port"`, `"[ipv6]:port"`, port 0 for any free
+         *        port) once registered, handing accepted connections to @p on_accept.
+         */
+        Listener(std::string address, AcceptCallback on_accept) noexcept;
+
+        /** @brief Stops listening (connections already accepted are unaffected) */
+        ~Listener() override;
+
+        Listener(const Listener &) = delete;
+        Listener(Listener &&) = delete;
+        auto operator=(const Listener &) -> Listener & = delete;
+        auto operator=(Listener &&) -> Listener & = delete;
+
+        /**
+         * @brief The length of the kernel's queue of connections waiting to be accepted. By
+         *        default (or when negative) the system's maximum, `net.core.somaxconn`.
+         * @note Must be set before the listener is registered.
+         */
+        auto backlog(int n) noexcept -> Listener &;
+
+        /**
+         * @brief Set `SO_REUSEPORT` on the socket, so that several listeners (one per reactor
+         *        of a ReactorGroup, or per process) can bind the same address and have the
+         *        kernel balance incoming connections between them.
+         * @note Must be set before the listener is registered.
+         */
+        auto reuse_port(bool val = true) noexcept -> Listener &;
+
+        /**
+         * @brief
+         * Accept at most @p n connections each time the socket becomes readable, then let
+         * the reactor run its other ready events before accepting more. Without a limit (0,
+         * the default) libevent accepts until the queue is empty, which under a connection
+         * storm delays every established connection on the reactor.
+         */
+        auto accept_batch(size_t n) noexcept -> Listener &;
+
+        [[nodiscard]]
+        auto register_event(event_base &base) noexcept -> bool override;
+
+        [[nodiscard]]
+        auto register_event(Reactor &reactor) noexcept -> bool override;
+
+        /** @brief The port the listener is bound to, or 0 if it is not listening */
+        [[nodiscard]]
+        auto port() const noexcept -> uint16_t;
+
+        /** @brief The listening socket, or -1 if the listener is not listening */
+        [[nodiscard]]
+        auto fd() const noexcept -> int;
+
+        /** @brief Stop listening. Connections already accepted are unaffected. */
+        void close() noexcept;
+
+    private:
+        auto listen(event_base &base, Reactor *reactor) noexcept -> bool;
+
+        /* Start accepting on a socket bound disabled */
+        auto enable() noexcept -> bool;
+
+        static void accept_cb(evconnlistener *listener, int fd, sockaddr *addr, int len, void *arg) noexcept;
+        static void batch_end_cb(int, short, void *arg) noexcept;
+    };
+
+} // namespace pembroke::net
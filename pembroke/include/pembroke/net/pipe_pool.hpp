@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pembroke::net {
+
+    /** @brief Both ends of a non-blocking pipe, as handed out by a PipePool */
+    struct Pipe {
+        int read_fd = -1;
+        int write_fd = -1;
+
+        /** @brief True if the pipe is open */
+        explicit operator bool() const noexcept {
+            return read_fd != -1;
+        }
+    };
+
+    /**
+     * @brief
+     * A pool of recycled pipes, the intermediate buffers that `splice` moves socket data
+     * through (see Splice). Creating a pipe costs two system calls and two file-descriptors
+     * (and closing it two more), so a proxy that opens a splice per connection takes its
+     * pipes from the pool and hands them back empty once done.
+     *
+     * Each Reactor owns a pool (see Reactor::pipe_pool()), only safe to use from the
+     * reactor's thread.
+     *
+     * @see ReactorBuilder::pipe_pool()
+     */
+    class PipePool {
+    public:
+        /** @brief Counters describing how well the pool is being used */
+        struct Stats {
+            uint64_t acquired = 0;   /**< Pipes handed out by acquire() */
+            uint64_t hits = 0;       /**< ... of which were recycled rather than newly created */
+            uint64_t returned = 0;   /**< Pipes handed back with release() */
+            uint64_t discarded = 0;  /**< ... of which were closed, because the pool was full or the pipe not empty */
+            size_t retained = 0;     /**< Pipes currently waiting in the pool */
+
+            /** @brief Fraction (0-1) of acquired pipes that were recycled */
+            [[nodiscard]]
+            auto hit_rate() const noexcept -> double {
+                return acquired == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(acquired);
+            }
+        };
+
+    private:
+        std::vector<Pipe> m_free;
+        size_t m_capacity;
+        Stats m_stats;
+
+    public:
+        /** @brief Create a pool that keeps at most @p capacity pipes for reuse */
+        explicit PipePool(size_t capacity);
+
+        /** @brief Closes the pipes kept for reuse (pipes still acquired are unaffected) */
+        ~PipePool() noexcept;
+
+        PipePool(const PipePool &) = delete;
+        PipePool(PipePool &&) = delete;
+        auto operator=(const PipePool &) -> PipePool & = delete;
+        auto operator=(PipePool &&) -> PipePool & = delete;
+
+        /**
+         * @brief An empty, non-blocking pipe, recycled if the pool has one available.
+         * @returns A closed pipe (and logs a warning) if a new pipe cannot be created
+         */
+        [[nodiscard]]
+        auto acquire() noexcept -> Pipe;
+
+        /**
+         * @brief Hand @p pipe back to the pool, or close it if the pool is full or the pipe
+         *        still holds data. @p pipe is closed (reset) either way.
+         */
+        void release(Pipe &pipe) noexcept;
+
+        /** @brief Maximum number of pipes kept for reuse */
+        [[nodiscard]]
+        auto capacity() const noexcept -> size_t {
+            return m_capacity;
+        }
+
+        [[nodiscard]]
+        auto stats() const noexcept -> Stats;
+
+        /** @brief Close both ends of @p pipe, resetting it */
+        static void close(Pipe &pipe) noexcept;
+    };
+
+} // namespace pembroke::net
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pembroke/callback.hpp"
+#include "pembroke/reactor_group.hpp"
+#include "pembroke/net/connection.hpp"
+#include "pembroke/net/listener.hpp"
+
+namespace pembroke::net {
+
+    /** @brief How a ShardedListener spreads connections over the reactors of a group */
+    enum class AcceptMode {
+        /**
+         * One `SO_REUSEPORT` listening socket per reactor. The kernel balances incoming
+         * connections between the sockets (by hashing the connection's addresses), and each
+         * reactor accepts its own without any shared lock.
+         */
+        ReusePort,
+        /**
+         * A single listening socket on the first reactor, which accepts every connection and
+         * hands the socket over to the reactor chosen by the group's Placement with
+         * Reactor::post(). Balances exactly (round-robin by default), for systems without
+         * `SO_REUSEPORT` or where the kernel's hashing balances poorly (few clients).
+         */
+        Handoff,
+    };
+
+    using ShardedAcceptCallback = InplaceCallback<void(Connection &&, size_t)>;
+
+    /**
+     * @brief
+     * Serves one address from every reactor of a ReactorGroup. Accepted connections are
+     * handed to the accept callback on the thread of the reactor they belong to, along with
+     * that reactor's shard:
+     *
+     *     auto group = pembroke::reactor().build_group(4);
+     *     std::vector<std::vector<pembroke::net::Connection>> connections(group->size());
+     *     pembroke::net::ShardedListener listener("0.0.0.0:8080", [&](pembroke::net::Connection &&c, size_t shard) {
+     *         connections[shard].push_back(std::move(c));  // only ever touched by shard's thread
+     *     });
+     *     listener.listen(*group);
+     *     group->start();
+     *
+     * The callback runs concurrently on every reactor's thread, anything it shares between
+     * shards must be synchronized.
+     *
+     * @note The listener must only be closed (or destroyed) while the group is stopped.
+     * @see AcceptMode
+     */
+    class ShardedListener {
+        std::string m_address;
+        ShardedAcceptCallback m_on_accept;
+        AcceptMode m_mode;
+        Placement m_placement = Placement::RoundRobin;
+        int m_backlog = -1;
+        size_t m_accept_batch = 0;
+        ReactorGroup *m_group = nullptr;
+        std::vector<std::unique_ptr<Listener>> m_listeners;
+        /* Connections handed to the accept callback, per shard */
+        std::unique_ptr<std::atomic<uint64_t>[]> m_accepted;
+
+    public:
+        ShardedListener(std::string address, ShardedAcceptCallback on_accept,
+                        AcceptMode mode = AcceptMode::ReusePort) noexcept;
+
+        ~ShardedListener();
+
+        ShardedListener(const ShardedListener &) = delete;
+        ShardedListener(ShardedListener &&) = delete;
+        auto operator=(const ShardedListener &) -> ShardedListener & = delete;
+        auto operator=(ShardedListener &&) -> ShardedListener & = delete;
+
+        /** @see Listener::backlog() */
+        auto backlog(int n) noexcept -> ShardedListener &;
+
+        /** @see Listener::accept_batch() */
+        auto accept_batch(size_t n) noexcept -> ShardedListener &;
+
+        /**
+         * @brief How AcceptMode::Handoff picks the reactor for each connection (ignored by
+         *        AcceptMode::ReusePort, where the kernel decides)
+         */
+        auto placement(Placement placement) noexcept -> ShardedListener &;
+
+        /**
+         * @brief Start listening on every reactor of @p group (which may already be running).
+         *        With port 0, every reactor listens on the port picked for the first one.
+         *        Every socket is bound before any starts accepting.
+         * @returns False (and logs a warning) if any reactor fails to listen. A socket that
+         *          fails to bind leaves none listening, one that fails to start accepting
+         *          leaves the others accepting (close() them once the group is stopped).
+         */
+        [[nodiscard]]
+        auto listen(ReactorGroup &group) noexcept -> bool;
+
+        [[nodiscard]]
+        auto mode() const noexcept -> AcceptMode {
+            return m_mode;
+        }
+
+        /** @brief The port being listened on, or 0 if not listening */
+        [[nodiscard]]
+        auto port() const noexcept -> uint16_t;
+
+        /**
+         * @brief The number of connections handed to the accept callback on @p shard so far,
+         *        to gauge how evenly connections are spread
+         */
+        [[nodiscard]]
+        auto accepted(size_t shard) const noexcept -> uint64_t;
+
+        /** @brief Stop listening. Connections already accepted are unaffected. */
+        void close() noexcept;
+
+    private:
+        void deliver(Connection &&connection, size_t shard) noexcept;
+        void hand_off(int fd) noexcept;
+    };
+
+} // namespace pembroke::net
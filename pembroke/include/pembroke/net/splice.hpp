@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pembroke/buffer.hpp"
+#include "pembroke/callback.hpp"
+#include "pembroke/libevent/forward_decls.hpp"
+#include "pembroke/net/connection.hpp"
+#include "pembroke/net/pipe_pool.hpp"
+
+namespace pembroke::net {
+
+    /** @brief How a Splice moves data between its connections */
+    enum class SpliceMode {
+        ZeroCopy,  /**< With `splice` through a pair of pipes from the reactor's PipePool, where available */
+        Buffered,  /**< Read into a Buffer and written back out, copying through userspace */
+    };
+
+    using SpliceCallback = InplaceCallback<void(Splice &, CloseReason)>;
+
+    /**
+     * @brief
+     * A bidirectional pipeline between two connections, for layer 4 proxying: everything read
+     * from one is written to the other, without passing through a callback.
+     *
+     *     auto &proxy = splices.emplace_back(std::make_unique<pembroke::net::Splice>(
+     *         std::move(client), std::move(upstream),
+     *         [](pembroke::net::Splice &s, pembroke::net::CloseReason) { ... }));
+     *
+     * The splice takes over both sockets, along with any data the connections had read but
+     * not consumed, or not yet written. By default (SpliceMode::ZeroCopy) the bytes are moved
+     * with `splice` from one socket into a pipe and from the pipe into the other socket, never
+     * copied into userspace. Without a PipePool on the reactor, or where the sockets do not
+     * support `splice`, data is read into a Buffer and written back out instead.
+     *
+     * Each direction holds at most one pipe (or 64 KiB of buffer) of data in flight: while it
+     * cannot be written out the splice stops reading from the source, so a slow destination
+     * holds back a fast source through TCP flow control. When one side shuts down its end of
+     * the connection the other side's is shut down for writing once everything in flight has
+     * been written, and data keeps flowing in the opposite direction until that side shuts
+     * down too. The close callback runs once, when both directions are done or on an error
+     * in either, after both sockets have been closed. It is free to destroy the Splice.
+     *
+     * @note Like any write to a socket, writing to a peer that has reset the connection
+     *       raises `SIGPIPE`, which a proxy should ignore.
+     * @note A splice must not be moved, and must be destroyed before its reactor.
+     */
+    class Splice {
+        /* One way through the splice, reading @p from and writing @p to */
+        struct Direction {
+            Splice *splice = nullptr;
+            int from = -1;
+            int to = -1;
+            /* Data waiting to be written, before anything in the pipe (and instead of the
+             * pipe once buffered) */
+            Buffer buffer;
+            Pipe pipe;
+            size_t in_pipe = 0;
+            bool zero_copy = false;
+            ::event *read_event = nullptr;
+            ::event *write_event = nullptr;
+            /* The event currently added, if any */
+            ::event *waiting = nullptr;
+            uint64_t forwarded = 0;
+            bool eof = false;
+            bool done = false;
+        };
+
+        int m_fd_a = -1;
+        int m_fd_b = -1;
+        Direction m_a_to_b;
+        Direction m_b_to_a;
+        PipePool *m_pipes = nullptr;
+        SpliceCallback m_on_close;
+
+    public:
+        /** @brief Most bytes moved per direction each time a socket becomes ready */
+        static constexpr size_t MaxBytesPerWakeup = 1024 * 1024;
+
+        /**
+         * @brief Take over @p a and @p b (which must be on the same reactor), and start moving
+         *        data between them.
+         * @note  On failure (logged as a warning) both connections are closed and the splice
+         *        is closed, without running @p on_close.
+         */
+        Splice(Connection &&a, Connection &&b, SpliceCallback on_close, SpliceMode mode = SpliceMode::ZeroCopy) noexcept;
+
+        /** @brief Closes both sockets, without running the close callback */
+        ~Splice() noexcept;
+
+        Splice(const Splice &) = delete;
+        Splice(Splice &&) = delete;
+        auto operator=(const Splice &) -> Splice & = delete;
+        auto operator=(Splice &&) -> Splice & = delete;
+
+        /** @brief True until the splice has been closed */
+        explicit operator bool() const noexcept {
+            return m_fd_a != -1;
+        }
+
+        /** @brief True while both directions move data with `splice`, rather than through a Buffer */
+        [[nodiscard]]
+        auto zero_copy() const noexcept -> bool {
+            return m_a_to_b.zero_copy && m_b_to_a.zero_copy;
+        }
+
+        /** @brief Bytes written to the second connection (including data it had buffered) */
+        [[nodiscard]]
+        auto bytes_a_to_b() const noexcept -> uint64_t {
+            return m_a_to_b.forwarded;
+        }
+
+        /** @brief Bytes written to the first connection (including data it had buffered) */
+        [[nodiscard]]
+        auto bytes_b_to_a() const noexcept -> uint64_t {
+            return m_b_to_a.forwarded;
+        }
+
+        /** @brief Close both sockets immediately, without running the close callback */
+        void close() noexcept;
+
+    private:
+        /* Write out what @p d holds, then read more, until the socket would block */
+        void pump(Direction &d) noexcept;
+
+        /* Read from the source into the pipe or buffer, like read(2) */
+        auto read_in(Direction &d) noexcept -> int64_t;
+
+        /* Write the buffer, or the pipe, to the destination, like write(2) */
+        auto write_out(Direction &d) noexcept -> int64_t;
+
+        /* Wait for the given event of @p d only (nullptr for neither) */
+        static void wait_for(Direction &d, ::event *ev) noexcept;
+
+        /* Close, then run the close callback, which may destroy the splice */
+        void finish(CloseReason reason) noexcept;
+
+        static void ready_cb(int fd, short what, void *arg) noexcept;
+    };
+
+} // namespace pembroke::net
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "pembroke/buffer.hpp"
+#include "pembroke/callback.hpp"
+#include "pembroke/event.hpp"
+#include "pembroke/libevent/forward_decls.hpp"
+
+extern "C" {
+struct sockaddr;
+}
+
+namespace pembroke::internal {
+    struct UdpSlabs;
+}
+
+namespace pembroke::net {
+
+    class UdpSocket;
+
+    /**
+     * @brief A datagram received by a UdpSocket. Both the data and the peer address point
+     *        into the socket's receive slab and are only valid during the callback.
+     */
+    struct Datagram {
+        ByteSlice data;         /**< The datagram's payload */
+        const sockaddr *peer;   /**< The sender, to be passed to UdpSocket::send() to reply */
+        uint32_t peer_len;      /**< The length of the sender's address */
+        bool truncated;         /**< The datagram was longer than UdpSocket::max_datagram() and was cut short */
+
+        /** @brief The payload as characters */
+        [[nodiscard]]
+        auto str() const noexcept -> std::string_view {
+            return {reinterpret_cast<const char *>(data.bytes), data.len};
+        }
+    };
+
+    /**
+     * @brief The datagrams received in a single wakeup of a UdpSocket, a poor man's
+     *        `std::span<const Datagram>` like ByteSlice.
+     */
+    struct DatagramBatch {
+        const Datagram *datagrams;
+        size_t count;
+
+        [[nodiscard]]
+        auto size() const noexcept -> size_t {
+            return count;
+        }
+
+        [[nodiscard]]
+        auto operator[](size_t i) const noexcept -> const Datagram & {
+            return datagrams[i];
+        }
+
+        [[nodiscard]]
+        auto begin() const noexcept -> const Datagram * {
+            return datagrams;
+        }
+
+        [[nodiscard]]
+        auto end() const noexcept -> const Datagram * {
+            return datagrams + count;
+        }
+    };
+
+    using DatagramCallback = InplaceCallback<void(UdpSocket &, const DatagramBatch &)>;
+
+    /**
+     * @brief
+     * A UDP socket on a Reactor, built for high packet rates. Each time the socket becomes
+     * readable up to batch_size() datagrams are received with a single `recvmmsg` into a
+     * slab allocated at registration, and handed to the callback together:
+     *
+     *     pembroke::net::UdpSocket socket("0.0.0.0:8125", [](auto &s, const pembroke::net::DatagramBatch &batch) {
+     *         for (const auto &d : batch) {
+     *             s.send(d.str(), d.peer, d.peer_len);  // echo
+     *         }
+     *     });
+     *     reactor->register_event(socket);
+     *
+     * Datagrams given to send() are copied into a send slab and sent together with a single
+     * `sendmmsg` at the end of the current loop iteration (or as soon as the slab is full).
+     * Runs of equally sized datagrams to the same peer are sent as one message and split by
+     * the kernel (UDP generic segmentation offload) where it is supported.
+     *
+     * @note A socket must not be moved once registered, and must be destroyed before its
+     *       reactor. It is not safe to destroy it from within its own callback.
+     */
+    class UdpSocket final : public Event {
+    public:
+        static constexpr size_t DefaultBatchSize = 64;
+        static constexpr size_t DefaultMaxDatagram = 2048;
+
+    private:
+        std::string m_address;
+        DatagramCallback m_on_datagrams;
+        size_t m_batch_size = DefaultBatchSize;
+        size_t m_max_datagram = DefaultMaxDatagram;
+        bool m_gso = true;
+        int m_fd = -1;
+        ::event *m_read_event = nullptr;
+        /* Activated when the first datagram is queued, and added to wait for writability
+         * when the socket's send buffer is full */
+        ::event *m_flush_event = nullptr;
+        std::unique_ptr<internal::UdpSlabs> m_slabs;
+
+    public:
+        /**
+         * @brief Bind @p address (`"host:port"`, `"[ipv6]:port"`, port 0 for any free port)
+         *        once registered, handing received datagrams to @p on_datagrams.
+         */
+        UdpSocket(std::string address, DatagramCallback on_datagrams) noexcept;
+
+        /** @brief Closes the socket, dropping any datagrams not yet sent */
+        ~UdpSocket() override;
+
+        UdpSocket(const UdpSocket &) = delete;
+        UdpSocket(UdpSocket &&) = delete;
+        auto operator=(const UdpSocket &) -> UdpSocket & = delete;
+        auto operator=(UdpSocket &&) -> UdpSocket & = delete;
+
+        /**
+         * @brief The most datagrams received per wakeup, and queued for sending before the
+         *        queue is flushed (64 by default).
+         * @note Must be set before the socket is registered.
+         * @throws ConfigurationException if @p n is 0
+         */
+        auto batch_size(size_t n) -> UdpSocket &;
+
+        /**
+         * @brief The largest datagram received in full, or accepted by send() (2048 bytes by
+         *        default). Longer datagrams are received truncated.
+         * @note Must be set before the socket is registered.
+         * @throws ConfigurationException if @p bytes is 0 or larger than a UDP datagram can be
+         */
+        auto max_datagram(size_t bytes) -> UdpSocket &;
+
+        /** @brief Use UDP generic segmentation offload when sending, if available (the default) */
+        auto gso(bool val) noexcept -> UdpSocket &;
+
+        [[nodiscard]]
+        auto register_event(event_base &base) noexcept -> bool override;
+
+        /**
+         * @brief Queue @p data to be sent to @p to (an address received in a Datagram, or
+         *        built by the caller). Queued datagrams are sent at the end of the loop
+         *        iteration, or straight away when the queue is full.
+         * @returns False if the socket is not open, @p data is longer than max_datagram(), or
+         *          the queue is full and cannot be sent yet (the datagram is dropped)
+         */
+        auto send(std::string_view data, const sockaddr *to, uint32_t to_len) noexcept -> bool;
+
+        /**
+         * @brief Queue @p data to be sent to @p address (`"host:port"`). Parses the address on
+         *        every call, prefer send(std::string_view, const sockaddr *, uint32_t) for
+         *        repeated sends.
+         */
+        auto send(std::string_view data, const std::string &address) noexcept -> bool;
+
+        /**
+         * @brief Send every queued datagram now, rather than at the end of the loop iteration.
+         * @returns The number of datagrams still queued (the socket's send buffer is full),
+         *          or -1 (see `errno`) if at least one datagram could not be sent and was
+         *          dropped. The rest are still sent or queued, see queued() for what is left.
+         */
+        auto flush() noexcept -> int;
+
+        /** @brief The number of datagrams waiting to be sent */
+        [[nodiscard]]
+        auto queued() const noexcept -> size_t;
+
+        /** @brief The port the socket is bound to, or 0 if it is not open */
+        [[nodiscard]]
+        auto port() const noexcept -> uint16_t;
+
+        /** @brief The socket, or -1 if it is not open */
+        [[nodiscard]]
+        auto fd() const noexcept -> int {
+            return m_fd;
+        }
+
+        /** @brief Close the socket, dropping any datagrams not yet sent */
+        void close() noexcept;
+
+    private:
+        static void read_cb(int fd, short what, void *arg) noexcept;
+        static void flush_cb(int fd, short what, void *arg) noexcept;
+    };
+
+} // namespace pembroke::net
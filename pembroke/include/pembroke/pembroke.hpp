@@ -6,9 +6,22 @@
  * seen will import this file for convience.
  */
 
+#include "pembroke/buffer.hpp"
+#include "pembroke/buffer_pool.hpp"
+#include "pembroke/callback.hpp"
+#include "pembroke/compression.hpp"
 #include "pembroke/event.hpp"
+#include "pembroke/file_segment.hpp"
+#include "pembroke/instrumentation.hpp"
 #include "pembroke/logging.hpp"
 #include "pembroke/reactor.hpp"
+#include "pembroke/reactor_group.hpp"
 #include "pembroke/util.hpp"
 #include "pembroke/event/timer.hpp"
-#include "pembroke/event/delayed.hpp"
\ No newline at end of file
+#include "pembroke/event/delayed.hpp"
+#include "pembroke/net/connection.hpp"
+#include "pembroke/net/listener.hpp"
+#include "pembroke/net/pipe_pool.hpp"
+#include "pembroke/net/sharded_listener.hpp"
+#include "pembroke/net/splice.hpp"
+#include "pembroke/net/udp_socket.hpp"
\ No newline at end of file
@@ -1,18 +1,60 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "pembroke/buffer_pool.hpp"
+#include "pembroke/callback.hpp"
 #include "pembroke/event.hpp"
+#include "pembroke/file_segment.hpp"
+#include "pembroke/instrumentation.hpp"
 #include "pembroke/libevent/forward_decls.hpp"
+#include "pembroke/timing_wheel.hpp"
+#include "pembroke/util.hpp"
 
 namespace pembroke {
     struct ReactorBuilder;
+    class ReactorGroup;
+
+    namespace internal {
+        class TaskQueue;
+
+        /* Owns a file-descriptor, closing it when destroyed */
+        class UniqueFd {
+            int m_fd = -1;
+
+        public:
+            UniqueFd() noexcept = default;
+            ~UniqueFd();
+
+            UniqueFd(const UniqueFd &) = delete;
+            UniqueFd(UniqueFd &&) = delete;
+            auto operator=(const UniqueFd &) -> UniqueFd & = delete;
+            auto operator=(UniqueFd &&) -> UniqueFd & = delete;
+
+            [[nodiscard]]
+            auto get() const noexcept -> int {
+                return m_fd;
+            }
+
+            /* Close the current file-descriptor (if any) and take ownership of @p fd */
+            void reset(int fd = -1) noexcept;
+        };
+    }
+
+    namespace net {
+        class Connection;
+        class PipePool;
+    }
 
     using reactor_base = std::unique_ptr<event_base, decltype(event_base_free) *>;
-    using event_ptr = std::unique_ptr<event, decltype(event_free) *>;
+    using event_ptr = std::unique_ptr<::event, decltype(event_free) *>;
 
     /**
      * @brief Class representing the main event-loop
@@ -22,8 +64,38 @@ namespace pembroke {
      */
     class Reactor {
         friend class Scheduler;
+        friend class ReactorGroup;
+        friend class Event;
+        friend class net::Connection;
     private:
         reactor_base m_base{nullptr, nullptr};
+        int m_priorities = 1;
+        /* Activated by tick_fast() just below the top priority, to end the loop once the top
+         * priority has been drained (only with more than one priority) */
+        event_ptr m_tick_fast_event{nullptr, nullptr};
+        std::unique_ptr<TimingWheel> m_timing_wheel;
+        std::unique_ptr<FileSegmentCache> m_file_segments;
+        std::unique_ptr<BufferPool> m_buffer_pool;
+        std::unique_ptr<net::PipePool> m_pipe_pool;
+
+        /* Null unless the reactor was built with instrumentation */
+        std::unique_ptr<Instrumentation> m_instrumentation;
+        /* Activated by stop() on an instrumented reactor, whose run_blocking() runs the loop
+         * once per tick and would lose a plain loopbreak landing between two ticks */
+        event_ptr m_stop_event{nullptr, nullptr};
+
+        /* Durations registered with event_base_init_common_timeout (see common_timeout()) */
+        std::vector<std::pair<duration, const timeval *>> m_common_timeouts;
+
+        /* Cross-thread task submission (see post()) */
+        std::unique_ptr<internal::TaskQueue> m_tasks;
+        /* Declared before its event, which is freed first */
+        internal::UniqueFd m_wakeup_fd;
+        event_ptr m_wakeup_event{nullptr, nullptr};
+        std::atomic<bool> m_wakeup_pending{false};
+        /* Bytes held by the buffers of every net::Connection on this reactor, only written
+         * from the reactor's thread */
+        std::atomic<size_t> m_buffered_bytes{0};
 
     public:
         /**
@@ -40,7 +112,7 @@ namespace pembroke {
          */
         Reactor(const ReactorBuilder &builder);
 
-        ~Reactor() = default;
+        ~Reactor();
 
         Reactor(const Reactor &r) = delete;
         Reactor(Reactor &&r) = delete;
@@ -74,9 +146,14 @@ namespace pembroke {
         /**
          * @brief Run the event-loop once, much like tick(). However this function will only execute
          *        the callbacks of events that are ready.
+         *
+         * On a reactor with more than one priority, only events of the top priority (0) are
+         * run. Lower-priority events that are ready are left for tick() or the blocking run,
+         * so latency-critical events can be serviced on their own.
          * 
          * @note Not all of the ready-events may be executed. To execute them all, use `tick()`
          * @see tick()
+         * @see ReactorBuilder::priorities()
          * @returns True if the loop ran successfully, False otherwise
          */
         [[nodiscard]]
@@ -86,6 +163,8 @@ namespace pembroke {
          * @brief Stop the reactor, returning control to the portion of code that invoked the blocking
          *        run (`blocking_run()`). If the reactor is not running, this function will have no
          *        success.
+         * @note  On an instrumented reactor the stop is remembered until the loop honours it, so
+         *        a stop requested while the reactor is not running ends its next run straight away.
          * @see blocking_run()
          * @return True if the reactor was successfully stopped (or if the reactor was not runnig), False
          *         if an error was encountered while attempting to stop.
@@ -96,6 +175,123 @@ namespace pembroke {
 
         [[nodiscard]]
         auto register_event(pembroke::Event &event) noexcept -> bool;
+
+        /**
+         * @brief Register an event at the given priority. Priorities range from 0 (highest)
+         *        to `priorities() - 1` (lowest). Whenever events of several priorities are
+         *        ready at once, the callbacks of higher-priority events run first and
+         *        lower-priority events wait for a later loop iteration.
+         *
+         * @note Events scheduled on the TimingWheel run at the priority of the wheel.
+         * @see ReactorBuilder::priorities()
+         * @returns False if the priority is out of range or registration fails
+         */
+        [[nodiscard]]
+        auto register_event(pembroke::Event &event, int priority) noexcept -> bool;
+
+        /**
+         * @brief The reactor's loop and callback timings, or nullptr if it was built without
+         *        instrumentation. Call `snapshot()` on it, from any thread, to read them.
+         * @see ReactorBuilder::instrument()
+         */
+        [[nodiscard]]
+        auto instrumentation() const noexcept -> Instrumentation *;
+
+        /**
+         * @brief The number of bytes held in the input and output buffers of every
+         *        net::Connection on this reactor. Safe to call from any thread.
+         */
+        [[nodiscard]]
+        auto buffered_bytes() const noexcept -> size_t;
+
+        /** @brief Number of event priorities the reactor was built with */
+        [[nodiscard]]
+        auto priorities() const noexcept -> int;
+
+        /**
+         * @brief The reactor's timing wheel, or nullptr if it was not enabled.
+         * @see ReactorBuilder::timing_wheel()
+         */
+        [[nodiscard]]
+        auto timing_wheel() noexcept -> TimingWheel *;
+
+        /**
+         * @brief The reactor's pool of recycled buffers, or nullptr if it was disabled.
+         * @see ReactorBuilder::buffer_pool()
+         */
+        [[nodiscard]]
+        auto buffer_pool() noexcept -> BufferPool *;
+
+        /**
+         * @brief The reactor's pool of recycled pipes for net::Splice, or nullptr if it was
+         *        disabled.
+         * @see ReactorBuilder::pipe_pool()
+         */
+        [[nodiscard]]
+        auto pipe_pool() noexcept -> net::PipePool *;
+
+        /**
+         * @brief The reactor's cache of open file segments, or nullptr if it was disabled.
+         * @see ReactorBuilder::file_segment_cache()
+         */
+        [[nodiscard]]
+        auto file_segments() noexcept -> FileSegmentCache *;
+
+        /**
+         * @brief The libevent common-timeout handle for @p timeout, or nullptr if the duration
+         *        was not declared with ReactorBuilder::common_timeout().
+         *
+         * Timers added with a common-timeout handle are appended to a per-duration queue rather
+         * than inserted in the timer heap. DelayedEvent and TimerEvent look this up themselves
+         * when registered, so there is usually no need to call it directly.
+         *
+         * @note The handle is only valid for timers on this reactor.
+         */
+        [[nodiscard]]
+        auto common_timeout(duration timeout) const noexcept -> const timeval *;
+
+        /**
+         * @brief
+         * Hand a task to the reactor to be run on its event-loop thread. Along with
+         * buffered_bytes() this is safe to call from any thread. Registering events from
+         * another thread is also safe on a thread-safe reactor (see ReactorGroup), except for
+         * events that use the TimingWheel, which must be registered through post().
+         *
+         * Tasks are pushed onto a bounded, lock-free queue and the loop is woken through a
+         * single eventfd. Tasks posted while a wakeup is already pending do not trigger
+         * another one, they are simply picked up in the same batch: all tasks queued when
+         * the reactor wakes are run together, in the order they were posted.
+         *
+         * Posting never allocates. @p task must be a `void()` callable small enough to be
+         * stored inline (see pembroke::Callback), larger callables are a compile-time error.
+         *
+         * @see ReactorBuilder::task_queue_capacity()
+         * @returns False if the queue is full and the task was not posted
+         */
+        template<typename Callable>
+        [[nodiscard]]
+        auto post(Callable &&task) noexcept -> bool {
+            return post_task(Callback(std::forward<Callable>(task)));
+        }
+
+    private:
+        [[nodiscard]]
+        auto post_task(Callback &&task) noexcept -> bool;
+
+        /* Number of events registered by users of the reactor, excluding the reactor's own */
+        [[nodiscard]]
+        auto user_event_count() const noexcept -> size_t;
+
+        /* The body of run_blocking(), once the timing wheel (if any) is owned by the caller */
+        [[nodiscard]]
+        auto run_loop() const noexcept -> bool;
+
+        /* Close the instrumentation tick (if any) after the event-loop returns */
+        void end_tick() const noexcept;
+
+        static void run_tasks_cb(int fd, short, void *arg) noexcept;
+        static void end_tick_cb(int, short, void *arg) noexcept;
+        static void stop_cb(int, short, void *arg) noexcept;
     };
 
     /** 
@@ -116,14 +312,168 @@ namespace pembroke {
         bool m_require_file_descriptor = false;
         bool m_require_early_close = false;
         bool m_require_order_one_trigger = false;
+        bool m_thread_safe = false;
+        size_t m_task_queue_capacity = 1024;
+        duration m_timing_wheel_resolution = no_delay;
+        size_t m_file_segment_cache = 64;
+        size_t m_buffer_pool = 256;
+        size_t m_pipe_pool = 32;
+        std::vector<duration> m_common_timeouts;
+        int m_priorities = 1;
+        bool m_instrument = false;
+        duration m_max_dispatch_interval = no_delay;
+        int m_max_dispatch_callbacks = 0;
+        int m_dispatch_limit_priority = -1;
+        bool m_precise_timer = false;
+        bool m_cache_time = true;
+        bool m_epoll_changelist = false;
 
         auto require_edge_trigger_support(bool val = true) noexcept -> ReactorBuilder &;
         auto require_file_descriptor_support(bool val = true) noexcept -> ReactorBuilder &;
         auto require_early_close_support(bool val = true) noexcept -> ReactorBuilder &;
         auto require_order_one_trigger_support(bool val = true) noexcept -> ReactorBuilder &;
 
+        /**
+         * @brief Enable libevent's internal locking so that events may be registered with the
+         *        reactor from threads other than the one running it (events that use the
+         *        TimingWheel excepted, see Reactor::post()).
+         * @note  Always enabled for reactors constructed with `build_group()`.
+         */
+        auto thread_safe(bool val = true) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Set the maximum number of tasks that may be waiting in the reactor's
+         *        cross-thread task queue. Rounded up to the next power of two.
+         * @see Reactor::post()
+         */
+        auto task_queue_capacity(size_t capacity) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Give the reactor a TimingWheel with the given tick resolution. Events that
+         *        opt into the wheel are then scheduled on it rather than on libevent's timer
+         *        heap. A non-positive resolution (the default) disables the wheel.
+         * @see TimingWheel
+         */
+        auto timing_wheel(duration resolution) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Set the number of recycled buffers the reactor's BufferPool keeps (256 by
+         *        default). Zero disables the pool.
+         * @see Reactor::buffer_pool()
+         */
+        auto buffer_pool(size_t capacity) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Set the number of recycled pipes the reactor's net::PipePool keeps (32 by
+         *        default). Zero disables the pool, and with it zero-copy net::Splice.
+         * @see Reactor::pipe_pool()
+         */
+        auto pipe_pool(size_t capacity) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Set the number of files the reactor's FileSegmentCache keeps open (64 by
+         *        default). Zero disables the cache.
+         * @see Reactor::file_segments()
+         */
+        auto file_segment_cache(size_t entries) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Declare a timeout duration that many timers on the reactor will share (request
+         *        timeouts, idle timeouts, keep-alives). May be called once per duration.
+         *
+         * libevent keeps timers of a common duration in a queue ordered by insertion, making
+         * them O(1) to add and remove instead of O(log n) heap operations. DelayedEvents and
+         * (fixed-delay) TimerEvents whose duration matches exactly are routed through the
+         * queue automatically. Timers of any other duration are unaffected.
+         *
+         * @note The reactor throws a ConfigurationException on construction if a duration is
+         *       not positive, or if more durations are declared than libevent supports (256).
+         * @see Reactor::common_timeout()
+         */
+        auto common_timeout(duration timeout) -> ReactorBuilder &;
+
+        /**
+         * @brief Give the reactor @p n event priorities (1, a single priority, by default). Events
+         *        registered without a priority are placed in the middle (`n / 2`).
+         * @note  The reactor throws a ConfigurationException on construction unless
+         *        `1 <= n <= 254`.
+         * @see   Reactor::register_event(Event &, int)
+         */
+        auto priorities(int n) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Record tick durations, callback durations and timer lateness for the reactor
+         *        in lock-free histograms. Disabled by default, in which case none of the timing
+         *        code runs.
+         * @note  While instrumented, `run_blocking()` runs the loop one batch of callbacks at
+         *        a time, so that each batch can be timed.
+         * @see   Reactor::instrumentation()
+         */
+        auto instrument(bool val = true) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Limit how long the reactor keeps running callbacks of one priority before
+         *        checking for newly ready events of a higher priority. Bounds how long a large
+         *        batch of low-priority work can starve latency-critical events, at the cost of
+         *        an extra loop iteration (and clock read) per interval. Non-positive (the
+         *        default) means no limit.
+         * @see dispatch_limit_priority()
+         */
+        auto max_dispatch_interval(duration interval) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Like max_dispatch_interval(), but limiting the number of callbacks run before
+         *        checking for higher-priority events. Zero (the default) means no limit.
+         * @see dispatch_limit_priority()
+         */
+        auto max_dispatch_callbacks(int n) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief The highest priority that the dispatch limits apply to. Events of a higher
+         *        priority always run to completion. By default the limits apply to every
+         *        priority below the top one, or to every event on a single-priority reactor.
+         * @see max_dispatch_interval()
+         * @see max_dispatch_callbacks()
+         */
+        auto dispatch_limit_priority(int priority) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Use the most precise timer the platform offers (e.g. CLOCK_MONOTONIC rather
+         *        than CLOCK_MONOTONIC_COARSE on Linux) at the cost of slower clock reads.
+         *        Reduces timer jitter from milliseconds to microseconds.
+         */
+        auto precise_timer(bool val = true) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Read the clock once per loop iteration and share it between all of the
+         *        iteration's timers (the default). Disabling the cache reads the clock for
+         *        every timer that is added, trading syscalls for timer accuracy.
+         */
+        auto cache_time(bool val = true) noexcept -> ReactorBuilder &;
+
+        /**
+         * @brief Have the epoll backend batch interest changes into a single `epoll_ctl` call
+         *        per loop iteration rather than one per change. Reduces syscalls when events
+         *        are added and removed frequently.
+         * @note  Unsafe with file-descriptors that are `dup()`-ed and watched through more than
+         *        one descriptor. Ignored (with a warning) when the backend is not epoll.
+         */
+        auto epoll_changelist(bool val = true) noexcept -> ReactorBuilder &;
+
         [[nodiscard]]
         auto build() const noexcept -> std::unique_ptr<Reactor>;
+
+        /**
+         * @brief Build a ReactorGroup of @p n reactors, each configured with the current
+         *        builder settings (plus thread-safety). The group is not started until
+         *        ReactorGroup::start() is called.
+         *
+         * @note Throws a ConfigurationException if any of the reactors fail to construct.
+         * @param n Number of reactors (and threads) in the group. When zero (the default), one
+         *          reactor is created per available core.
+         */
+        [[nodiscard]]
+        auto build_group(size_t n = 0) const -> std::unique_ptr<ReactorGroup>;
     };
 
     /**
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "pembroke/event.hpp"
+#include "pembroke/reactor.hpp"
+
+namespace pembroke {
+
+    namespace net {
+        class ShardedListener;
+    }
+
+    /**
+     * @brief Strategy used by ReactorGroup to pick the reactor an event is registered on
+     * @see ReactorGroup::register_event
+     */
+    enum class Placement {
+        RoundRobin,   /**< Cycle through the reactors of the group in order */
+        LeastLoaded,  /**< Pick the reactor with the fewest pending and active events */
+    };
+
+    /**
+     * @brief
+     * A fixed set of reactors, each running its own event-loop on a dedicated thread.
+     *
+     * A single Reactor can only ever make use of one core. ReactorGroup spreads events across
+     * several reactors so that a process can scale out across cores without hand-rolling
+     * threads around Reactor::run_blocking(). Every reactor in the group is constructed with
+     * the same ReactorBuilder settings (with thread-safety enabled) so events can be
+     * registered from any thread. The exception are events that use the reactor's
+     * TimingWheel, which must be registered (and cancelled) from the reactor's own thread with
+     * Reactor::post(). Doing so from another thread while the group runs aborts.
+     *
+     * **Example:**
+     *
+     *     auto group = pembroke::reactor().build_group(4);
+     *     group->start();
+     *     group->register_event(event);                         // round-robin
+     *     group->register_event(other, Placement::LeastLoaded); // least-loaded
+     *     group->register_event(pinned, 2);                     // explicit shard
+     *     group->stop();
+     *
+     * @note An event's callback always runs on the thread of the reactor it was placed on.
+     * @see ReactorBuilder::build_group()
+     */
+    class ReactorGroup {
+        friend class net::ShardedListener;
+
+        std::vector<std::unique_ptr<Reactor>> m_reactors;
+        /* declared after m_reactors so they are freed before the bases they belong to */
+        std::vector<event_ptr> m_stop_events;
+        std::vector<std::thread> m_threads;
+        std::atomic<size_t> m_next_shard{0};
+        std::atomic<bool> m_running{false};
+
+    public:
+        /**
+         * @brief Construct a group of @p n reactors from the given builder.
+         * @see ReactorBuilder::build_group()
+         */
+        ReactorGroup(const ReactorBuilder &builder, size_t n);
+
+        /** @brief Stops and joins all running reactor threads */
+        ~ReactorGroup();
+
+        ReactorGroup(const ReactorGroup &) = delete;
+        ReactorGroup(ReactorGroup &&) = delete;
+
+        auto operator=(const ReactorGroup &) -> ReactorGroup & = delete;
+        auto operator=(ReactorGroup &&) -> ReactorGroup & = delete;
+
+        /**
+         * @brief Start one thread per reactor, each running the reactor's event-loop until
+         *        stop() is called.
+         * @returns False if the group was already running
+         */
+        [[nodiscard]]
+        auto start() -> bool;
+
+        /**
+         * @brief Stop every reactor in the group and join their threads. Events that are
+         *        still registered remain so and will run if the group is started again.
+         * @returns False if the group was not running
+         */
+        auto stop() noexcept -> bool;
+
+        /** @brief True if the group has been started and not yet stopped */
+        [[nodiscard]]
+        auto running() const noexcept -> bool;
+
+        /** @brief The number of reactors (and threads) in the group */
+        [[nodiscard]]
+        auto size() const noexcept -> size_t;
+
+        /**
+         * @brief Access the reactor for a given shard
+         * @pre @p shard must be less than size()
+         */
+        [[nodiscard]]
+        auto reactor(size_t shard) noexcept -> Reactor &;
+
+        /**
+         * @brief The number of events currently pending or active on the reactor for a given
+         *        shard. This is the measure used by Placement::LeastLoaded.
+         * @pre @p shard must be less than size()
+         */
+        [[nodiscard]]
+        auto load(size_t shard) const noexcept -> size_t;
+
+        /**
+         * @brief Register an event on a reactor chosen by the given placement strategy.
+         * @returns True if the event was registered successfully
+         */
+        [[nodiscard]]
+        auto register_event(Event &event, Placement placement = Placement::RoundRobin) noexcept -> bool;
+
+        /**
+         * @brief Register an event on the reactor for an explicit shard.
+         * @returns True if the event was registered successfully, False if @p shard is out of
+         *          range or registration failed
+         */
+        [[nodiscard]]
+        auto register_event(Event &event, size_t shard) noexcept -> bool;
+
+    private:
+        [[nodiscard]]
+        auto pick_shard(Placement placement) noexcept -> size_t;
+
+        static void stop_cb(int, short, void *arg) noexcept;
+    };
+
+} // namespace pembroke
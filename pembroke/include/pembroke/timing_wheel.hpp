@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "pembroke/libevent/forward_decls.hpp"
+#include "pembroke/util.hpp"
+
+namespace pembroke {
+
+    /**
+     * @brief
+     * A hierarchical timing wheel: an alternative to libevent's timer min-heap for
+     * applications with very large numbers of (mostly cancelled) timeouts.
+     *
+     * Timeouts are bucketed by expiry tick into 4 levels of 256 slots each, so
+     * scheduling and cancelling are O(1) and never allocate (entries are intrusive, they
+     * live inside the object that owns the timeout). The whole wheel is driven by a single
+     * libevent timer that fires once per tick, and only while the wheel is non-empty.
+     *
+     * The trade-off is precision: timeouts are rounded up to the wheel's tick resolution,
+     * so a 100us delay on a 1ms wheel will fire somewhere between 1ms and 2ms later.
+     *
+     * A wheel is normally created by the reactor (see ReactorBuilder::timing_wheel()) and
+     * used by events that opt into it (e.g. DelayedEvent::use_timing_wheel()).
+     *
+     * @note Unlike libevent's own timers the wheel is not thread-safe: entries must only be
+     *       scheduled and cancelled from the reactor's thread, so events that use the wheel
+     *       must be registered from it (with Reactor::post() when the reactor belongs to a
+     *       running ReactorGroup). Only size() may be read from other threads. While a
+     *       reactor runs its loop with Reactor::run_blocking() the wheel is owned by that
+     *       thread, and scheduling or cancelling from any other aborts.
+     */
+    class TimingWheel {
+    public:
+        static constexpr size_t Levels = 4;
+        static constexpr size_t SlotBits = 8;
+        static constexpr size_t Slots = 1U << SlotBits;
+
+        using callback_t = void (*)(void *arg) noexcept;
+
+        /**
+         * @brief
+         * A single timeout on the wheel. Entries are embedded into the object that owns the
+         * timeout and linked into the wheel while they are scheduled.
+         *
+         * Destroying a scheduled entry cancels it. Moving a scheduled entry moves its place
+         * on the wheel.
+         */
+        class Entry {
+            friend class TimingWheel;
+
+            callback_t m_callback;
+            void *m_arg;
+            TimingWheel *m_wheel = nullptr;
+            Entry **m_head = nullptr;
+            Entry *m_prev = nullptr;
+            Entry *m_next = nullptr;
+            uint64_t m_expiry = 0;
+
+        public:
+            /** @brief Create an (unscheduled) entry that runs @p callback with @p arg on expiry */
+            Entry(callback_t callback, void *arg) noexcept
+                : m_callback(callback), m_arg(arg) {}
+
+            ~Entry();
+
+            Entry(const Entry &) = delete;
+            Entry(Entry &&other) noexcept;
+
+            auto operator=(const Entry &) -> Entry & = delete;
+            auto operator=(Entry &&other) noexcept -> Entry &;
+
+            /** @brief Change the argument passed to the callback (e.g. after the owner moved) */
+            void rebind(void *arg) noexcept { m_arg = arg; }
+
+            /** @brief True if the entry is currently scheduled on a wheel */
+            [[nodiscard]]
+            auto scheduled() const noexcept -> bool { return m_wheel != nullptr; }
+
+            /** @brief The wheel the entry is scheduled on, or nullptr */
+            [[nodiscard]]
+            auto wheel() const noexcept -> TimingWheel * { return m_wheel; }
+
+            /** @brief Remove the entry from its wheel (no-op if it is not scheduled). O(1). */
+            void cancel() noexcept;
+
+        private:
+            void take_place_of(Entry &other) noexcept;
+        };
+
+        /**
+         * @brief Construct a wheel driven by a timer on @p base that ticks every @p resolution
+         * @note Throws a ConfigurationException if @p resolution is not positive or the driving
+         *       timer cannot be created.
+         */
+        TimingWheel(event_base &base, duration resolution);
+
+        /** @brief Unschedules all remaining entries (without running them) */
+        ~TimingWheel();
+
+        TimingWheel(const TimingWheel &) = delete;
+        TimingWheel(TimingWheel &&) = delete;
+        auto operator=(const TimingWheel &) -> TimingWheel & = delete;
+        auto operator=(TimingWheel &&) -> TimingWheel & = delete;
+
+        /**
+         * @brief Schedule @p entry to expire after (at least) @p delay. Delays are rounded up to
+         *        a whole number of ticks, with a minimum of one tick. If the entry is already
+         *        scheduled it is rescheduled. O(1).
+         * @returns False if the driving timer could not be armed
+         */
+        [[nodiscard]]
+        auto schedule(Entry &entry, duration delay) noexcept -> bool;
+
+        /** @brief Remove @p entry from the wheel. Same as Entry::cancel(). */
+        void cancel(Entry &entry) noexcept;
+
+        /** @brief The tick resolution of the wheel */
+        [[nodiscard]]
+        auto resolution() const noexcept -> duration;
+
+        /** @brief Number of entries currently scheduled. Safe to call from any thread. */
+        [[nodiscard]]
+        auto size() const noexcept -> size_t;
+
+        /**
+         * @brief Restrict schedule() and cancel() to @p owner, aborting when they are called from
+         *        any other thread. A default-constructed id lifts the restriction.
+         */
+        void set_owner(std::thread::id owner) noexcept;
+
+        /** @brief The longest delay that can be represented, longer delays are clamped */
+        [[nodiscard]]
+        auto max_delay() const noexcept -> duration;
+
+        /**
+         * @brief Expire all entries that are due as of now. Called by the driving timer, but
+         *        may be called manually.
+         */
+        void advance() noexcept;
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        clock::time_point m_start;
+        duration m_resolution;
+        uint64_t m_now_tick = 0;
+        /* Only written from the reactor's thread, atomic so that size() may be read from
+         * others (see ReactorGroup::load()) */
+        std::atomic<size_t> m_size{0};
+        /* The thread running the reactor's loop, if any (see set_owner()) */
+        std::atomic<std::thread::id> m_owner{};
+        std::array<std::array<Entry *, Slots>, Levels> m_slots{};
+        std::unique_ptr<::event, decltype(event_free) *> m_driver{nullptr, nullptr};
+        bool m_driver_armed = false;
+
+        [[nodiscard]]
+        auto current_tick() const noexcept -> uint64_t;
+
+        void assert_owner() const noexcept;
+        void link(Entry &entry) noexcept;
+        void unlink(Entry &entry) noexcept;
+        void cascade(size_t level) noexcept;
+        void expire_tick() noexcept;
+        auto arm_driver() noexcept -> bool;
+        void disarm_driver() noexcept;
+
+        static void tick_cb(int, short, void *arg) noexcept;
+    };
+
+} // namespace pembroke
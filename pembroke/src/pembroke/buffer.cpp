@@ -1,9 +1,19 @@
 #include "pembroke/buffer.hpp"
+#include "pembroke/file_segment.hpp"
+#include "pembroke/internal/buffer_shelf.hpp"
+#include "pembroke/internal/byte_search.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <new>
 #include <string>
 
 extern "C" {
     #include "event2/buffer.h"
+    #include <sys/ioctl.h>
+    #include <sys/uio.h>
 }
 
 namespace pembroke {
@@ -13,11 +23,33 @@ namespace pembroke {
     Buffer::Buffer() noexcept
         : m_underlying(evbuffer_new()) {}
 
+    Buffer::Buffer(evbuffer *underlying, internal::BufferShelf *shelf) noexcept
+        : m_underlying(underlying), m_shelf(shelf) {}
+
+    auto Buffer::borrow(evbuffer *underlying) noexcept -> Buffer {
+        Buffer b(underlying, nullptr);
+        b.m_owned = false;
+        return b;
+    }
+
     Buffer::~Buffer() noexcept {
-        if (m_underlying != nullptr) {
+        release();
+    }
+
+    void Buffer::release() noexcept {
+        if (m_underlying == nullptr) {
+            return;
+        }
+        /* a borrowed evbuffer is freed by its owner */
+        if (m_owned && m_shelf != nullptr) {
+            internal::return_to_shelf(m_shelf, m_underlying);
+        } else if (m_owned) {
             evbuffer_free(m_underlying);
-            m_underlying = nullptr;
         }
+        m_underlying = nullptr;
+        m_shelf = nullptr;
+        m_drains_to_fd = false;
+        m_owned = true;
     }
 
     // ---
@@ -25,17 +57,34 @@ namespace pembroke {
     // ---
     Buffer::Buffer(Buffer &&b) noexcept {
         m_underlying = b.m_underlying;
+        m_reserved = b.m_reserved;
+        m_shelf = b.m_shelf;
+        m_drains_to_fd = b.m_drains_to_fd;
+        m_owned = b.m_owned;
         b.m_underlying = nullptr;
+        b.m_reserved = BufferReservation{};
+        b.m_shelf = nullptr;
+        b.m_drains_to_fd = false;
+        b.m_owned = true;
     }
 
     auto Buffer::operator=(Buffer &&b) noexcept -> Buffer& {
-        if (m_underlying != nullptr) {
-            // make sure to free any existing resources
-            evbuffer_free(m_underlying);
+        if (this == &b) {
+            return *this;
         }
+        // make sure to free any existing resources
+        release();
 
         m_underlying = b.m_underlying;
+        m_reserved = b.m_reserved;
+        m_shelf = b.m_shelf;
+        m_drains_to_fd = b.m_drains_to_fd;
+        m_owned = b.m_owned;
         b.m_underlying = nullptr;
+        b.m_reserved = BufferReservation{};
+        b.m_shelf = nullptr;
+        b.m_drains_to_fd = false;
+        b.m_owned = true;
 
         return *this;
     }
@@ -69,19 +118,435 @@ namespace pembroke {
         add(byte_slice.bytes, byte_slice.len);
     }
 
+    /* Called by libevent when a referenced segment is released */
+    static void run_reference_cleanup(const void * /* data */, size_t /* len */, void *extra) {
+        auto *cleanup = static_cast<Callback *>(extra);
+        (*cleanup)();
+        delete cleanup;
+    }
+
+    auto Buffer::add_reference(const std::byte *bytes, size_t n_bytes, Callback cleanup) noexcept -> bool {
+        if (m_underlying == nullptr) {
+            if (cleanup) {
+                cleanup();
+            }
+            return false;
+        }
+        if (!cleanup) {
+            return evbuffer_add_reference(m_underlying, bytes, n_bytes, nullptr, nullptr) == 0;
+        }
+
+        auto *extra = new (std::nothrow) Callback(std::move(cleanup));
+        if (extra == nullptr) {
+            cleanup();
+            return false;
+        }
+        if (evbuffer_add_reference(m_underlying, bytes, n_bytes, &run_reference_cleanup, extra) != 0) {
+            // libevent does not release the reference when it fails to add it
+            run_reference_cleanup(bytes, n_bytes, extra);
+            return false;
+        }
+        return true;
+    }
+
+    auto Buffer::add_reference(std::string_view str_view, Callback cleanup) noexcept -> bool {
+        return add_reference(reinterpret_cast<const std::byte *>(str_view.data()), str_view.length(), std::move(cleanup));
+    }
+
+    auto Buffer::add_reference(std::shared_ptr<const void> owner, const std::byte *bytes, size_t n_bytes) noexcept -> bool {
+        return add_reference(bytes, n_bytes, [owner = std::move(owner)]() mutable { owner.reset(); });
+    }
+
+    auto Buffer::add_reference(std::shared_ptr<const std::string> str) noexcept -> bool {
+        if (str == nullptr) {
+            return false;
+        }
+        const auto *bytes = reinterpret_cast<const std::byte *>(str->data());
+        auto len = str->length();
+        return add_reference(std::shared_ptr<const void>(std::move(str)), bytes, len);
+    }
+
+
+    auto Buffer::add_file(const FileSegment &segment, int64_t offset, int64_t length) noexcept -> bool {
+        if (m_underlying == nullptr || !segment || offset < 0 || offset > segment.length()) {
+            return false;
+        }
+        if (length < 0 || length > segment.length() - offset) {
+            length = segment.length() - offset;
+        }
+        return evbuffer_add_file_segment(m_underlying, segment.underlying(), offset, length) == 0;
+    }
+
+    auto Buffer::add_file(const std::string &path, int64_t offset, int64_t length) noexcept -> bool {
+        // our reference to the segment is dropped once it has been added
+        auto segment = FileSegment::open(path, offset, length);
+        return add_file(segment);
+    }
+
+    void Buffer::drains_to_fd(bool val) noexcept {
+        if (m_underlying == nullptr) {
+            return;
+        }
+        m_drains_to_fd = val;
+        if (val) {
+            evbuffer_set_flags(m_underlying, EVBUFFER_FLAG_DRAINS_TO_FD);
+        } else {
+            evbuffer_clear_flags(m_underlying, EVBUFFER_FLAG_DRAINS_TO_FD);
+        }
+    }
+
+    // ---
+    // In-Place Writes
+    // ---
+
+    auto Buffer::reserve(size_t n, size_t max_extents) noexcept -> BufferReservation {
+        m_reserved = BufferReservation{};
+        if (m_underlying == nullptr) {
+            return m_reserved;
+        }
+
+        std::array<evbuffer_iovec, BufferReservation::MaxExtents> vecs{};
+        int n_vecs = static_cast<int>(std::clamp<size_t>(max_extents, 1, vecs.size()));
+        int used = evbuffer_reserve_space(m_underlying, static_cast<ev_ssize_t>(n), vecs.data(), n_vecs);
+        if (used <= 0) {
+            return m_reserved;
+        }
+        m_reserved.count = static_cast<size_t>(used);
+        for (size_t i = 0; i < m_reserved.count; i++) {
+            m_reserved.extents[i] = ByteSlice{static_cast<std::byte *>(vecs[i].iov_base), vecs[i].iov_len};
+        }
+        return m_reserved;
+    }
+
+    auto Buffer::commit(size_t written) noexcept -> bool {
+        if (m_underlying == nullptr || m_reserved.count == 0 || written > m_reserved.size()) {
+            return false;
+        }
+
+        /* Only the extents written to are committed, trimmed to what was written */
+        std::array<evbuffer_iovec, BufferReservation::MaxExtents> vecs{};
+        int n_vecs = 0;
+        for (const auto &extent : m_reserved) {
+            if (written == 0) {
+                break;
+            }
+            auto len = std::min(written, extent.len);
+            vecs[static_cast<size_t>(n_vecs++)] = evbuffer_iovec{extent.bytes, len};
+            written -= len;
+        }
+        m_reserved = BufferReservation{};
+        return evbuffer_commit_space(m_underlying, vecs.data(), n_vecs) == 0;
+    }
+
+    auto Buffer::writer(size_t chunk) noexcept -> BufferWriter {
+        return BufferWriter(*this, chunk);
+    }
+
+    void BufferWriter::write(std::string_view str) noexcept {
+        while (!str.empty()) {
+            if (m_pos == m_end && !refill()) {
+                return;
+            }
+            auto n = std::min(str.size(), static_cast<size_t>(m_end - m_pos));
+            std::memcpy(m_pos, str.data(), n);
+            m_pos += n;
+            str.remove_prefix(n);
+        }
+    }
+
+    void BufferWriter::flush() noexcept {
+        if (m_start != nullptr) {
+            (void)m_buffer->commit(static_cast<size_t>(m_pos - m_start));
+        }
+        m_start = m_pos = m_end = nullptr;
+    }
+
+    auto BufferWriter::refill() noexcept -> bool {
+        flush();
+        auto space = m_buffer->reserve(m_chunk, 1);
+        if (space.count == 0) {
+            return false;
+        }
+        m_start = m_pos = reinterpret_cast<char *>(space.extents[0].bytes);
+        m_end = m_start + space.extents[0].len;
+        return true;
+    }
+
+    // ---
+    // Binary Encoding
+    // ---
+
+    void Buffer::write_varint(uint64_t value) noexcept {
+        uint8_t bytes[MaxVarintBytes];
+        size_t n = 0;
+        while (value >= 0x80) {
+            bytes[n++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        bytes[n++] = static_cast<uint8_t>(value);
+        add(reinterpret_cast<const std::byte *>(bytes), n);
+    }
+
+    auto Buffer::read_varint(uint64_t &value) noexcept -> bool {
+        uint8_t bytes[MaxVarintBytes];
+        size_t n = copy_prefix(bytes, sizeof(bytes));
+        size_t consumed = 0;
+        if (!decode_varint(bytes, n, value, consumed)) {
+            return false;
+        }
+        drain(consumed);
+        return true;
+    }
+
+    auto Buffer::decode_varint(const uint8_t *bytes, size_t len, uint64_t &value, size_t &consumed) noexcept -> bool {
+        uint64_t result = 0;
+        for (size_t i = 0; i < len && i < MaxVarintBytes; i++) {
+            result |= static_cast<uint64_t>(bytes[i] & 0x7F) << (7 * i);
+            if ((bytes[i] & 0x80) == 0) {
+                // the tenth byte may only carry the single remaining bit
+                if (i == MaxVarintBytes - 1 && bytes[i] > 1) {
+                    return false;
+                }
+                value = result;
+                consumed = i + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto Buffer::decode_prefix(const uint8_t *bytes, size_t len, size_t width, uint64_t &value, size_t &consumed) noexcept -> bool {
+        if (width == 0) {
+            return decode_varint(bytes, len, value, consumed);
+        }
+        if (len < width) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < width; i++) {
+            value = (value << 8) | bytes[i];
+        }
+        consumed = width;
+        return true;
+    }
+
+    auto Buffer::take_prefixed(std::string &out, size_t width) noexcept -> bool {
+        if (m_underlying == nullptr) {
+            return false;
+        }
+        uint64_t value = 0;
+        size_t prefix = 0;
+
+        /* Usually the whole value sits within the first segment: decode and copy it from
+         * there, draining once */
+        evbuffer_iovec vec{};
+        if (evbuffer_peek(m_underlying, -1, nullptr, &vec, 1) == 1) {
+            const auto *first = static_cast<const uint8_t *>(vec.iov_base);
+            if (decode_prefix(first, vec.iov_len, width, value, prefix) && vec.iov_len - prefix >= value) {
+                out.assign(reinterpret_cast<const char *>(first + prefix), static_cast<size_t>(value));
+                evbuffer_drain(m_underlying, prefix + static_cast<size_t>(value));
+                return true;
+            }
+        }
+
+        uint8_t bytes[MaxVarintBytes];
+        size_t n = copy_prefix(bytes, width == 0 ? MaxVarintBytes : width);
+        if (!decode_prefix(bytes, n, width, value, prefix) || evbuffer_get_length(m_underlying) - prefix < value) {
+            return false;
+        }
+        out.resize(static_cast<size_t>(value));
+        return take(out.data(), out.size(), prefix);
+    }
+
+    auto Buffer::take(void *out, size_t n, size_t skip) noexcept -> bool {
+        if (m_underlying == nullptr) {
+            return false;
+        }
+        /* Values usually sit within the first segment: copy straight out of it (pulling up
+         * bytes that are already contiguous is free) rather than walking the chain */
+        if (evbuffer_get_contiguous_space(m_underlying) >= skip + n) {
+            std::memcpy(out, evbuffer_pullup(m_underlying, static_cast<ev_ssize_t>(skip + n)) + skip, n);
+        } else {
+            evbuffer_ptr ptr{};
+            if (evbuffer_get_length(m_underlying) < skip + n
+                    || evbuffer_ptr_set(m_underlying, &ptr, skip, EVBUFFER_PTR_SET) != 0
+                    || evbuffer_copyout_from(m_underlying, &ptr, out, n) != static_cast<ev_ssize_t>(n)) {
+                return false;
+            }
+        }
+        evbuffer_drain(m_underlying, skip + n);
+        return true;
+    }
+
+    auto Buffer::copy_prefix(void *out, size_t n) const noexcept -> size_t {
+        if (m_underlying == nullptr) {
+            return 0;
+        }
+        if (evbuffer_get_contiguous_space(m_underlying) >= n) {
+            std::memcpy(out, evbuffer_pullup(m_underlying, static_cast<ev_ssize_t>(n)), n);
+            return n;
+        }
+        auto copied = evbuffer_copyout(m_underlying, out, n);
+        return copied < 0 ? 0 : static_cast<size_t>(copied);
+    }
+
+    // ---
+    // Moving Data Between Buffers
+    // ---
+
+    auto Buffer::append(Buffer &&other) noexcept -> bool {
+        if (m_underlying == nullptr || other.m_underlying == nullptr || this == &other) {
+            return false;
+        }
+        return evbuffer_add_buffer(m_underlying, other.m_underlying) == 0;
+    }
+
+    auto Buffer::prepend(Buffer &&other) noexcept -> bool {
+        if (m_underlying == nullptr || other.m_underlying == nullptr || this == &other) {
+            return false;
+        }
+        return evbuffer_prepend_buffer(m_underlying, other.m_underlying) == 0;
+    }
+
+    auto Buffer::move_prefix_to(Buffer &dest, size_t n) noexcept -> size_t {
+        if (m_underlying == nullptr || dest.m_underlying == nullptr || this == &dest) {
+            return 0;
+        }
+        n = std::min(n, evbuffer_get_length(m_underlying));
+        int moved = evbuffer_remove_buffer(m_underlying, dest.m_underlying, n);
+        return moved < 0 ? 0 : static_cast<size_t>(moved);
+    }
+
+    // ---
+    // File Descriptor I/O
+    // ---
+
+    namespace {
+        /* Most segments gathered into a single writev, as libevent does */
+        constexpr size_t MaxWriteIovecs = 128;
+        /* Read size when the fd cannot tell us how much is readable */
+        constexpr size_t DefaultRead = 4096;
+    }
+
+    auto Buffer::write_to(int fd, size_t max) noexcept -> int64_t {
+        if (m_underlying == nullptr) {
+            errno = EINVAL;
+            return -1;
+        }
+        auto howmuch = max >= static_cast<size_t>(std::numeric_limits<ev_ssize_t>::max())
+            ? ev_ssize_t(-1) : static_cast<ev_ssize_t>(max);
+        return evbuffer_write_atmost(m_underlying, fd, howmuch);
+    }
+
+    auto Buffer::read_from(int fd, size_t max) noexcept -> int64_t {
+        if (m_underlying == nullptr) {
+            errno = EINVAL;
+            return -1;
+        }
+        /* evbuffer_read() caps every read at 4 KiB, so reserve and readv ourselves */
+        if (max == npos) {
+            int readable = 0;
+            max = ioctl(fd, FIONREAD, &readable) == 0 && readable > 0
+                ? std::clamp(static_cast<size_t>(readable), DefaultRead, MaxRead)
+                : DefaultRead;
+        }
+        if (max == 0) {
+            return 0;
+        }
+
+        auto space = reserve(max);
+        if (space.count == 0) {
+            errno = ENOMEM;
+            return -1;
+        }
+        std::array<iovec, BufferReservation::MaxExtents> vecs{};
+        size_t remaining = max;
+        int n_vecs = 0;
+        for (const auto &extent : space) {
+            if (remaining == 0) {
+                break;
+            }
+            auto len = std::min(remaining, extent.len);
+            vecs[static_cast<size_t>(n_vecs++)] = iovec{extent.bytes, len};
+            remaining -= len;
+        }
+
+        ssize_t n = ::readv(fd, vecs.data(), n_vecs);
+        if (n <= 0) {
+            int saved = errno;
+            m_reserved = BufferReservation{};
+            errno = saved;
+            return n;
+        }
+        (void)commit(static_cast<size_t>(n));
+        return n;
+    }
+
+    auto Buffer::write_batch(int fd, std::initializer_list<Buffer *> buffers, size_t max) noexcept -> int64_t {
+        return write_batch(fd, buffers.begin(), buffers.size(), max);
+    }
+
+    auto Buffer::write_batch(int fd, Buffer *const *buffers, size_t n_buffers, size_t max) noexcept -> int64_t {
+        /* A buffer that may hold sendfile segments can only be written through libevent */
+        size_t first = 0;
+        while (first < n_buffers && buffers[first]->length() == 0) {
+            first++;
+        }
+        if (first < n_buffers && buffers[first]->m_drains_to_fd) {
+            return buffers[first]->write_to(fd, max);
+        }
+
+        std::array<iovec, MaxWriteIovecs> vecs{};
+        size_t n_vecs = 0;
+        size_t gathered = 0;
+        for (size_t i = first; i < n_buffers && n_vecs < vecs.size() && gathered < max; i++) {
+            auto *underlying = buffers[i]->m_underlying;
+            if (underlying == nullptr) {
+                errno = EINVAL;
+                return -1;
+            }
+            if (buffers[i]->m_drains_to_fd) {
+                break;
+            }
+            std::array<evbuffer_iovec, MaxWriteIovecs> segments{};
+            int n = evbuffer_peek(underlying, static_cast<ev_ssize_t>(std::min(max - gathered, evbuffer_get_length(underlying))),
+                                  nullptr, segments.data(), static_cast<int>(vecs.size() - n_vecs));
+            n = std::min(n, static_cast<int>(vecs.size() - n_vecs));
+            for (int j = 0; j < n && gathered < max; j++) {
+                auto len = std::min(segments[static_cast<size_t>(j)].iov_len, max - gathered);
+                vecs[n_vecs++] = iovec{segments[static_cast<size_t>(j)].iov_base, len};
+                gathered += len;
+            }
+        }
+        if (n_vecs == 0) {
+            return 0;
+        }
+
+        ssize_t written = ::writev(fd, vecs.data(), static_cast<int>(n_vecs));
+        if (written <= 0) {
+            return written;
+        }
+        size_t remaining = static_cast<size_t>(written);
+        for (size_t i = first; i < n_buffers && remaining > 0; i++) {
+            auto n = std::min(remaining, buffers[i]->length());
+            buffers[i]->drain(n);
+            remaining -= n;
+        }
+        return written;
+    }
 
     // ---
     // Buffer Read Methods
     // ---
 
-    auto Buffer::length() noexcept -> size_t {
+    auto Buffer::length() const noexcept -> size_t {
         if (m_underlying == nullptr) {
             return 0;
         }
         return evbuffer_get_length(m_underlying);
     }
 
-    auto Buffer::size() noexcept -> size_t {
+    auto Buffer::size() const noexcept -> size_t {
         return length();
     }
 
@@ -101,10 +566,13 @@ namespace pembroke {
             return std::string();
         }
 
-        size_t len = evbuffer_get_length(m_underlying);
-        unsigned char *data = evbuffer_pullup(m_underlying, len);
-
-        return std::string(reinterpret_cast<char *>(data), len);
+        /* Copy segment by segment, there is no need to linearize the buffer first */
+        std::string out;
+        out.reserve(evbuffer_get_length(m_underlying));
+        for (const auto &segment : segments()) {
+            out.append(reinterpret_cast<const char *>(segment.bytes), segment.len);
+        }
+        return out;
     }
 
     auto Buffer::bytes() const noexcept -> ByteSlice {
@@ -119,4 +587,233 @@ namespace pembroke {
             .len = len,
         };
     }
+
+    auto Buffer::segments(size_t limit) const noexcept -> BufferSegments {
+        return BufferSegments(m_underlying, limit);
+    }
+
+    auto Buffer::peek(size_t n) const noexcept -> ByteSlice {
+        if (m_underlying == nullptr || n == 0) {
+            return ByteSlice{nullptr, 0};
+        }
+        evbuffer_iovec vec{};
+        if (evbuffer_peek(m_underlying, -1, nullptr, &vec, 1) < 1) {
+            return ByteSlice{nullptr, 0};
+        }
+        return ByteSlice{static_cast<std::byte *>(vec.iov_base), std::min(n, vec.iov_len)};
+    }
+
+    auto Buffer::view_prefix(size_t n) noexcept -> std::string_view {
+        if (m_underlying == nullptr) {
+            return std::string_view();
+        }
+        n = std::min(n, evbuffer_get_length(m_underlying));
+        if (n == 0) {
+            return std::string_view();
+        }
+
+        // evbuffer_pullup is a no-op when the first segment already holds n bytes
+        unsigned char *data = evbuffer_pullup(m_underlying, static_cast<ev_ssize_t>(n));
+        return std::string_view(reinterpret_cast<char *>(data), n);
+    }
+
+    // ---
+    // Search Functions
+    // ---
+
+    auto Buffer::find(std::string_view pattern, size_t from) const noexcept -> size_t {
+        if (m_underlying == nullptr) {
+            return npos;
+        }
+        size_t total = evbuffer_get_length(m_underlying);
+        if (from > total || pattern.size() > total - from) {
+            return npos;
+        }
+        if (pattern.empty()) {
+            return from;
+        }
+
+        /* Matches within a segment are found by searching the segment itself. Matches that
+         * straddle segments are found by searching a small window: the (up to) m - 1
+         * trailing bytes seen so far followed by the (up to) m - 1 leading bytes of the
+         * next segment. */
+        const size_t m = pattern.size();
+        std::string window;
+        size_t window_start = from;
+        size_t offset = from;
+        for (auto segment : BufferSegments(m_underlying, SIZE_MAX, from)) {
+            const auto *chars = reinterpret_cast<const char *>(segment.bytes);
+            size_t head = std::min(segment.len, m - 1);
+            if (!window.empty()) {
+                window.append(chars, head);
+                auto pos = internal::find(reinterpret_cast<const std::byte *>(window.data()), window.size(), pattern);
+                if (pos != internal::NotFound) {
+                    return window_start + pos;
+                }
+            }
+
+            auto pos = internal::find(segment.bytes, segment.len, pattern);
+            if (pos != internal::NotFound) {
+                return offset + pos;
+            }
+
+            if (segment.len >= m - 1) {
+                window.assign(chars + segment.len - (m - 1), m - 1);
+                window_start = offset + segment.len - (m - 1);
+            } else {
+                if (window.empty()) {
+                    window.assign(chars, segment.len);
+                    window_start = offset;
+                }
+                // the whole (short) segment has been appended, keep the last m - 1 bytes
+                if (window.size() > m - 1) {
+                    size_t excess = window.size() - (m - 1);
+                    window.erase(0, excess);
+                    window_start += excess;
+                }
+            }
+            offset += segment.len;
+        }
+        return npos;
+    }
+
+    auto Buffer::find_any(std::string_view byteset, size_t from) const noexcept -> size_t {
+        if (m_underlying == nullptr || byteset.empty()) {
+            return npos;
+        }
+        if (byteset.size() == 1) {
+            // skip building a set, the single byte case is a plain memchr
+            size_t offset = from;
+            for (auto segment : BufferSegments(m_underlying, SIZE_MAX, from)) {
+                const void *match = std::memchr(segment.bytes, byteset[0], segment.len);
+                if (match != nullptr) {
+                    return offset + static_cast<size_t>(static_cast<const std::byte *>(match) - segment.bytes);
+                }
+                offset += segment.len;
+            }
+            return npos;
+        }
+
+        internal::ByteSet set(byteset);
+        size_t offset = from;
+        for (auto segment : BufferSegments(m_underlying, SIZE_MAX, from)) {
+            auto pos = internal::find_any(segment.bytes, segment.len, set);
+            if (pos != internal::NotFound) {
+                return offset + pos;
+            }
+            offset += segment.len;
+        }
+        return npos;
+    }
+
+    auto Buffer::readln(std::string &line, LineEnding style) noexcept -> bool {
+        if (m_underlying == nullptr) {
+            return false;
+        }
+
+        size_t end = npos;
+        size_t eol_len = 1;
+        switch (style) {
+            case LineEnding::Lf:
+                end = find_any("\n");
+                break;
+            case LineEnding::Nul:
+                end = find_any(std::string_view("\0", 1));
+                break;
+            case LineEnding::CrlfStrict:
+                end = find("\r\n");
+                eol_len = 2;
+                break;
+            case LineEnding::Crlf:
+                // a preceding carriage return is removed along with the line (see below)
+                end = find_any("\n");
+                break;
+            case LineEnding::Any:
+                end = find_any("\r\n");
+                if (end != npos) {
+                    eol_len = 0;
+                    for (auto segment : BufferSegments(m_underlying, SIZE_MAX, end)) {
+                        size_t i = 0;
+                        while (i < segment.len && (segment.bytes[i] == std::byte{'\r'} || segment.bytes[i] == std::byte{'\n'})) {
+                            i++;
+                        }
+                        eol_len += i;
+                        if (i < segment.len) {
+                            break;
+                        }
+                    }
+                }
+                break;
+        }
+        if (end == npos) {
+            return false;
+        }
+
+        line.resize(end);
+        if (end > 0 && evbuffer_copyout(m_underlying, line.data(), end) != static_cast<ev_ssize_t>(end)) {
+            return false;
+        }
+        evbuffer_drain(m_underlying, end + eol_len);
+        if (style == LineEnding::Crlf && !line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return true;
+    }
+
+    void Buffer::drain(size_t n) noexcept {
+        if (m_underlying == nullptr) {
+            return;
+        }
+        evbuffer_drain(m_underlying, n);
+    }
+
+    // ---
+    // Segment Iteration
+    // ---
+
+    static_assert(sizeof(BufferSegmentIterator::Position) == sizeof(evbuffer_ptr),
+                  "BufferSegmentIterator::Position must be able to hold an evbuffer_ptr");
+    static_assert(alignof(BufferSegmentIterator::Position) >= alignof(evbuffer_ptr),
+                  "BufferSegmentIterator::Position must be able to hold an evbuffer_ptr");
+
+    BufferSegmentIterator::BufferSegmentIterator(evbuffer *buffer, size_t limit, size_t start) noexcept
+        : m_buffer(buffer), m_remaining(limit) {
+        if (m_buffer == nullptr || start >= evbuffer_get_length(m_buffer)) {
+            return;
+        }
+        evbuffer_ptr ptr{};
+        if (evbuffer_ptr_set(m_buffer, &ptr, start, EVBUFFER_PTR_SET) != 0) {
+            return;
+        }
+        std::memcpy(&m_position, &ptr, sizeof(ptr));
+        load();
+    }
+
+    auto BufferSegmentIterator::operator++() noexcept -> BufferSegmentIterator & {
+        evbuffer_ptr ptr{};
+        std::memcpy(&ptr, &m_position, sizeof(ptr));
+
+        /* Moving the pointer forward by a whole segment lands on the start of the next chain,
+         * libevent keeps track of the chain so each step is O(1) */
+        m_remaining -= m_current.len;
+        if (m_remaining == 0 || evbuffer_ptr_set(m_buffer, &ptr, m_current.len, EVBUFFER_PTR_ADD) != 0) {
+            m_current = ByteSlice{nullptr, 0};
+            return *this;
+        }
+        std::memcpy(&m_position, &ptr, sizeof(ptr));
+        load();
+        return *this;
+    }
+
+    void BufferSegmentIterator::load() noexcept {
+        evbuffer_ptr ptr{};
+        std::memcpy(&ptr, &m_position, sizeof(ptr));
+
+        evbuffer_iovec vec{};
+        if (m_remaining == 0 || evbuffer_peek(m_buffer, -1, &ptr, &vec, 1) < 1 || vec.iov_len == 0) {
+            m_current = ByteSlice{nullptr, 0};
+            return;
+        }
+        m_current = ByteSlice{static_cast<std::byte *>(vec.iov_base), std::min(vec.iov_len, m_remaining)};
+    }
 }
\ No newline at end of file
@@ -0,0 +1,376 @@
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+extern "C" {
+#include <arpa/inet.h>
+#include <event2/buffer.h>
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#include "pembroke/buffer.hpp"
+#include "pembroke/buffer_pool.hpp"
+
+/*
+ * Cost of reading a multi-megabyte, multi-segment buffer in full: linearizing it
+ * (evbuffer_pullup) to get a single view versus walking its segments in place.
+ */
+
+static constexpr size_t BufferBytes = 4 * 1024 * 1024;
+static constexpr size_t ChunkBytes = 4096;
+
+static auto fill() -> pembroke::Buffer {
+    pembroke::Buffer b;
+    std::string chunk(ChunkBytes, 'x');
+    for (size_t n = 0; n < BufferBytes; n += ChunkBytes) {
+        b.add(chunk);
+    }
+    return b;
+}
+
+static auto checksum(const std::byte *bytes, size_t len) -> size_t {
+    size_t sum = 0;
+    for (size_t i = 0; i < len; i += 64) {
+        sum += static_cast<size_t>(bytes[i]);
+    }
+    return sum;
+}
+
+TEST_CASE("Buffer read: pullup vs segments", "[buffer][segments][benchmark]") {
+    BENCHMARK_ADVANCED("view_str (pullup), 4MiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            b = fill();
+        }
+        meter.measure([&](int i) -> size_t {
+            auto view = buffers[static_cast<size_t>(i)].view_str();
+            return checksum(reinterpret_cast<const std::byte *>(view.data()), view.size());
+        });
+    };
+
+    BENCHMARK_ADVANCED("segments, 4MiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            b = fill();
+        }
+        meter.measure([&](int i) -> size_t {
+            size_t sum = 0;
+            for (auto segment : buffers[static_cast<size_t>(i)].segments()) {
+                sum += checksum(segment.bytes, segment.len);
+            }
+            return sum;
+        });
+    };
+}
+
+TEST_CASE("Buffer write: copy vs reference", "[buffer][reference][benchmark]") {
+    /* One precomputed payload fanned out to many outgoing buffers */
+    static constexpr size_t FanOut = 1000;
+    auto payload = std::make_shared<const std::string>(64 * 1024, 'p');
+
+    BENCHMARK_ADVANCED("add (copy), 64KiB x 1000")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(FanOut);
+        meter.measure([&] {
+            for (auto &b : buffers) {
+                b = pembroke::Buffer();
+                b.add(*payload);
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("add_reference, 64KiB x 1000")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(FanOut);
+        meter.measure([&] {
+            for (auto &b : buffers) {
+                b = pembroke::Buffer();
+                b.add_reference(payload);
+            }
+        });
+    };
+}
+
+TEST_CASE("Buffer write: format + add vs writer", "[buffer][writer][benchmark]") {
+    /* A response-header-sized record, formatted 1000 times per run */
+    static constexpr int Records = 1000;
+
+    BENCHMARK_ADVANCED("fmt::format + add, 1000 records")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        meter.measure([&](int i) {
+            auto &b = buffers[static_cast<size_t>(i)];
+            for (int r = 0; r < Records; r++) {
+                b.add(fmt::format("{}: {} ({}, {})\r\n", "X-Record", r, "value", r * 7));
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("fmt::format_to(writer), 1000 records")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        meter.measure([&](int i) {
+            auto out = buffers[static_cast<size_t>(i)].writer();
+            for (int r = 0; r < Records; r++) {
+                fmt::format_to(out.begin(), "{}: {} ({}, {})\r\n", "X-Record", r, "value", r * 7);
+            }
+        });
+    };
+}
+
+TEST_CASE("Buffer search: find vs evbuffer_search", "[buffer][search][benchmark]") {
+    /* 1MiB of header-like lines in 4KiB segments, with the terminator at the very end */
+    pembroke::Buffer b;
+    std::string chunk;
+    while (chunk.size() < ChunkBytes - 32) {
+        chunk += "X-Header: some value\r\n";
+    }
+    chunk.resize(ChunkBytes, 'x');
+    for (size_t n = 0; n < 1024 * 1024; n += ChunkBytes) {
+        b.add(chunk);
+    }
+    b.add("\r\n\r\n");
+    const size_t expected = b.length() - 4;
+    auto *underlying = b.underlying();
+
+    BENCHMARK("evbuffer_search, 1MiB") {
+        auto ptr = evbuffer_search(underlying, "\r\n\r\n", 4, nullptr);
+        return static_cast<size_t>(ptr.pos) == expected;
+    };
+
+    BENCHMARK("Buffer::find, 1MiB") {
+        return b.find("\r\n\r\n") == expected;
+    };
+
+    BENCHMARK("evbuffer_search (single byte), 1MiB") {
+        auto ptr = evbuffer_search(underlying, "\0", 1, nullptr);
+        return ptr.pos == -1;
+    };
+
+    BENCHMARK("Buffer::find_any (single byte), 1MiB") {
+        return b.find_any(std::string_view("\0", 1)) == pembroke::Buffer::npos;
+    };
+
+    BENCHMARK("Buffer::find_any (3 bytes), 1MiB") {
+        return b.find_any(std::string_view("\0<>", 3)) == pembroke::Buffer::npos;
+    };
+}
+
+TEST_CASE("Buffer search: readln vs evbuffer_readln", "[buffer][readln][benchmark]") {
+    static constexpr int Lines = 10000;
+    std::string line = "X-Header: a typical header line of modest length\r\n";
+
+    BENCHMARK_ADVANCED("evbuffer_readln, 10000 lines")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            for (int i = 0; i < Lines; i++) {
+                b.add(line);
+            }
+        }
+        meter.measure([&](int i) {
+            size_t total = 0;
+            size_t len = 0;
+            char *read = nullptr;
+            while ((read = evbuffer_readln(buffers[static_cast<size_t>(i)].underlying(), &len, EVBUFFER_EOL_CRLF)) != nullptr) {
+                total += len;
+                free(read);  // NOLINT(cppcoreguidelines-no-malloc)
+            }
+            return total;
+        });
+    };
+
+    BENCHMARK_ADVANCED("Buffer::readln, 10000 lines")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            for (int i = 0; i < Lines; i++) {
+                b.add(line);
+            }
+        }
+        meter.measure([&](int i) {
+            size_t total = 0;
+            std::string read;
+            while (buffers[static_cast<size_t>(i)].readln(read)) {
+                total += read.size();
+            }
+            return total;
+        });
+    };
+}
+
+TEST_CASE("Buffer lifetime: new vs pooled", "[buffer][buffer_pool][benchmark]") {
+    /* A request/response pair of small buffers, created and destroyed 1000 times */
+    static constexpr int Requests = 1000;
+    pembroke::BufferPool pool(16);
+
+    BENCHMARK("Buffer(), 1000 request/response pairs") {
+        size_t total = 0;
+        for (int i = 0; i < Requests; i++) {
+            pembroke::Buffer request;
+            pembroke::Buffer response;
+            request.add("GET / HTTP/1.1\r\n\r\n");
+            response.add("HTTP/1.1 200 OK\r\n\r\n");
+            total += request.length() + response.length();
+        }
+        return total;
+    };
+
+    BENCHMARK("BufferPool::acquire(), 1000 request/response pairs") {
+        size_t total = 0;
+        for (int i = 0; i < Requests; i++) {
+            auto request = pool.acquire();
+            auto response = pool.acquire();
+            request.add("GET / HTTP/1.1\r\n\r\n");
+            response.add("HTTP/1.1 200 OK\r\n\r\n");
+            total += request.length() + response.length();
+        }
+        return total;
+    };
+}
+
+TEST_CASE("Buffer binary: typed reads vs hand-rolled", "[buffer][binary][benchmark]") {
+    /* 10000 frames of: u32 id, u16 kind, u32 length, payload */
+    static constexpr int Frames = 10000;
+    const std::string payload = "a modest payload";
+
+    auto fill = [&](pembroke::Buffer &b) {
+        for (uint32_t i = 0; i < Frames; i++) {
+            b.write_be<uint32_t>(i);
+            b.write_be<uint16_t>(static_cast<uint16_t>(i & 0xFFFF));
+            b.write_prefixed<uint32_t>(payload);
+        }
+    };
+
+    BENCHMARK_ADVANCED("pullup + memcpy + ntoh, 10000 frames")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            fill(b);
+        }
+        meter.measure([&](int i) {
+            auto *buf = buffers[static_cast<size_t>(i)].underlying();
+            uint64_t sum = 0;
+            std::string body;
+            for (int f = 0; f < Frames; f++) {
+                uint32_t id = 0;
+                uint16_t kind = 0;
+                uint32_t len = 0;
+                std::memcpy(&id, evbuffer_pullup(buf, 4), 4);
+                evbuffer_drain(buf, 4);
+                std::memcpy(&kind, evbuffer_pullup(buf, 2), 2);
+                evbuffer_drain(buf, 2);
+                std::memcpy(&len, evbuffer_pullup(buf, 4), 4);
+                evbuffer_drain(buf, 4);
+                len = ntohl(len);
+                body.resize(len);
+                evbuffer_remove(buf, body.data(), len);
+                sum += ntohl(id) + ntohs(kind) + body.size();
+            }
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED("read_be + read_prefixed, 10000 frames")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            fill(b);
+        }
+        meter.measure([&](int i) {
+            auto &b = buffers[static_cast<size_t>(i)];
+            uint64_t sum = 0;
+            std::string body;
+            for (int f = 0; f < Frames; f++) {
+                uint32_t id = 0;
+                uint16_t kind = 0;
+                (void)b.read_be(id);
+                (void)b.read_be(kind);
+                (void)b.read_prefixed<uint32_t>(body);
+                sum += id + kind + body.size();
+            }
+            return sum;
+        });
+    };
+}
+
+/*
+ * Writing to a file-descriptor (/dev/null, so only the system calls and copies are
+ * measured): linearizing with view_str() and calling write() versus write_to()'s writev,
+ * and flushing a batch of log lines one write_to() at a time versus a single write_batch().
+ */
+
+TEST_CASE("Buffer io: write vs writev", "[buffer][io][benchmark]") {
+    int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    REQUIRE(fd != -1);
+
+    BENCHMARK_ADVANCED("view_str + write, 4MiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            b = fill();
+        }
+        meter.measure([&](int i) {
+            auto &b = buffers[static_cast<size_t>(i)];
+            auto view = b.view_str();
+            auto n = write(fd, view.data(), view.size());
+            b.drain(static_cast<size_t>(n));
+            return n;
+        });
+    };
+
+    BENCHMARK_ADVANCED("write_to, 4MiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        for (auto &b : buffers) {
+            b = fill();
+        }
+        meter.measure([&](int i) {
+            auto &b = buffers[static_cast<size_t>(i)];
+            int64_t n = 0;
+            while (b.length() > 0) {
+                n += b.write_to(fd);
+            }
+            return n;
+        });
+    };
+
+    static constexpr size_t Lines = 64;
+    auto log_lines = [] {
+        std::vector<pembroke::Buffer> lines(Lines);
+        for (size_t i = 0; i < Lines; i++) {
+            lines[i].add(fmt::format("2020-01-01T00:00:00Z INFO request {} served in {}us\n", i, i * 13));
+        }
+        return lines;
+    };
+
+    BENCHMARK_ADVANCED("write_to each, 64 log lines")(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::vector<pembroke::Buffer>> batches(static_cast<size_t>(meter.runs()));
+        for (auto &batch : batches) {
+            batch = log_lines();
+        }
+        meter.measure([&](int i) {
+            int64_t n = 0;
+            for (auto &line : batches[static_cast<size_t>(i)]) {
+                n += line.write_to(fd);
+            }
+            return n;
+        });
+    };
+
+    BENCHMARK_ADVANCED("write_batch, 64 log lines")(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::vector<pembroke::Buffer>> batches(static_cast<size_t>(meter.runs()));
+        std::vector<std::vector<pembroke::Buffer *>> pointers(batches.size());
+        for (size_t b = 0; b < batches.size(); b++) {
+            batches[b] = log_lines();
+            for (auto &line : batches[b]) {
+                pointers[b].push_back(&line);
+            }
+        }
+        meter.measure([&](int i) {
+            auto &batch = pointers[static_cast<size_t>(i)];
+            return pembroke::Buffer::write_batch(fd, batch.data(), batch.size());
+        });
+    };
+
+    close(fd);
+}
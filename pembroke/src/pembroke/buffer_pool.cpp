@@ -0,0 +1,85 @@
+#include "pembroke/buffer_pool.hpp"
+#include "pembroke/internal/buffer_shelf.hpp"
+
+extern "C" {
+#include <event2/buffer.h>
+#include <event2/buffer_compat.h>
+}
+
+namespace pembroke {
+
+    namespace internal {
+
+        void return_to_shelf(BufferShelf *shelf, evbuffer *buffer) noexcept {
+            shelf->outstanding--;
+            if (shelf->closed) {
+                evbuffer_free(buffer);
+                if (shelf->outstanding == 0) {
+                    delete shelf;
+                }
+                return;
+            }
+
+            shelf->stats.returned++;
+            if (shelf->free.size() >= shelf->capacity) {
+                shelf->stats.discarded++;
+                evbuffer_free(buffer);
+                return;
+            }
+            /* Drop whatever was attached through Buffer::underlying() first, so that draining
+             * neither runs callbacks nor fails on a frozen buffer */
+            evbuffer_setcb(buffer, nullptr, nullptr);
+            evbuffer_unfreeze(buffer, 0);
+            evbuffer_unfreeze(buffer, 1);
+            // releases the contents now, as destroying the buffer would have
+            evbuffer_drain(buffer, evbuffer_get_length(buffer));
+            evbuffer_clear_flags(buffer, EVBUFFER_FLAG_DRAINS_TO_FD);
+            shelf->free.push_back(buffer);
+        }
+
+    }  // namespace internal
+
+    BufferPool::BufferPool(size_t capacity)
+        : m_shelf(new internal::BufferShelf(capacity)) {}
+
+    BufferPool::~BufferPool() noexcept {
+        for (auto *buffer : m_shelf->free) {
+            evbuffer_free(buffer);
+        }
+        m_shelf->free.clear();
+        if (m_shelf->outstanding == 0) {
+            delete m_shelf;
+        } else {
+            // the last outstanding buffer cleans up
+            m_shelf->closed = true;
+        }
+    }
+
+    auto BufferPool::acquire() noexcept -> Buffer {
+        m_shelf->stats.acquired++;
+        evbuffer *buffer = nullptr;
+        if (!m_shelf->free.empty()) {
+            buffer = m_shelf->free.back();
+            m_shelf->free.pop_back();
+            m_shelf->stats.hits++;
+        } else {
+            buffer = evbuffer_new();
+            if (buffer == nullptr) {
+                return Buffer(nullptr, nullptr);
+            }
+        }
+        m_shelf->outstanding++;
+        return Buffer(buffer, m_shelf);
+    }
+
+    auto BufferPool::capacity() const noexcept -> size_t {
+        return m_shelf->capacity;
+    }
+
+    auto BufferPool::stats() const noexcept -> Stats {
+        auto stats = m_shelf->stats;
+        stats.retained = m_shelf->free.size();
+        return stats;
+    }
+
+} // namespace pembroke
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+
+#include <utility>
+#include <vector>
+
+#include "pembroke/buffer_pool.hpp"
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+extern "C" {
+#include <event2/buffer.h>
+}
+
+using pembroke::Buffer;
+using pembroke::BufferPool;
+
+// ---
+// Construction
+// ---
+
+TEST_CASE("Reactor has a buffer pool by default", "[buffer_pool][construction]") {
+    auto r = pembroke::reactor().build();
+    REQUIRE(r->buffer_pool() != nullptr);
+    CHECK(r->buffer_pool()->capacity() == 256);
+
+    auto disabled = pembroke::reactor().buffer_pool(0).build();
+    CHECK(disabled->buffer_pool() == nullptr);
+}
+
+// ---
+// Recycling
+// ---
+
+TEST_CASE("Buffers are recycled through the pool", "[buffer_pool]") {
+    BufferPool pool(4);
+    evbuffer *underlying = nullptr;
+    {
+        auto b = pool.acquire();
+        CHECK(b.pooled());
+        b.add("request data");
+        underlying = b.underlying();
+    }
+    auto stats = pool.stats();
+    CHECK(stats.acquired == 1);
+    CHECK(stats.hits == 0);
+    CHECK(stats.returned == 1);
+    CHECK(stats.retained == 1);
+
+    auto b = pool.acquire();
+    CHECK(b.underlying() == underlying);
+    CHECK(b.length() == 0);
+    stats = pool.stats();
+    CHECK(stats.hits == 1);
+    CHECK(stats.retained == 0);
+    CHECK(stats.hit_rate() == Approx(0.5));
+}
+
+TEST_CASE("Recycling a buffer does not allocate", "[buffer_pool]") {
+    BufferPool pool(4);
+    { auto warm = pool.acquire(); }
+
+    pembroke::LibeventAllocationCounter allocations;
+    for (int i = 0; i < 10; i++) {
+        auto b = pool.acquire();
+        CHECK(b.pooled());
+    }
+    CHECK(allocations.count() == 0);
+    CHECK(pool.stats().hits == 10);
+}
+
+TEST_CASE("The pool keeps at most its capacity", "[buffer_pool]") {
+    BufferPool pool(2);
+    {
+        std::vector<Buffer> buffers;
+        for (int i = 0; i < 5; i++) {
+            buffers.push_back(pool.acquire());
+        }
+    }
+    auto stats = pool.stats();
+    CHECK(stats.returned == 5);
+    CHECK(stats.discarded == 3);
+    CHECK(stats.retained == 2);
+}
+
+TEST_CASE("Moving a pooled buffer moves its pool", "[buffer_pool]") {
+    BufferPool pool(2);
+    auto a = pool.acquire();
+    auto b = std::move(a);
+    CHECK(b.pooled());
+    CHECK_FALSE(a.pooled());  // NOLINT(bugprone-use-after-move)
+
+    // the buffer replaced by move-assignment goes back to the pool
+    b = Buffer();
+    CHECK_FALSE(b.pooled());
+    CHECK(pool.stats().retained == 1);
+}
+
+TEST_CASE("Recycled buffers are reset", "[buffer_pool]") {
+    BufferPool pool(2);
+    int cleanups = 0;
+    int changes = 0;
+    auto count_changes = [](evbuffer *, const evbuffer_cb_info *, void *arg) {
+        (*static_cast<int *>(arg))++;
+    };
+    {
+        auto b = pool.acquire();
+        b.drains_to_fd();
+        b.add_reference("referenced", [&cleanups]() { cleanups++; });
+        REQUIRE(evbuffer_add_cb(b.underlying(), count_changes, &changes) != nullptr);
+        REQUIRE(evbuffer_freeze(b.underlying(), 0) == 0);
+        REQUIRE(evbuffer_freeze(b.underlying(), 1) == 0);
+    }
+    CHECK(cleanups == 1);
+    CHECK(changes == 0);
+
+    auto b = pool.acquire();
+    CHECK(pool.stats().hits == 1);
+    b.add("plain");
+    CHECK(b.str() == "plain");
+    b.drain(b.length());
+    CHECK(b.length() == 0);
+    CHECK(changes == 0);
+}
+
+TEST_CASE("Pooled buffers may outlive their pool", "[buffer_pool]") {
+    Buffer survivor;
+    {
+        BufferPool pool(2);
+        survivor = pool.acquire();
+        { auto returned = pool.acquire(); }
+        survivor.add("still usable");
+    }
+    CHECK(survivor.str() == "still usable");
+}
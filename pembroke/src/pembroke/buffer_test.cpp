@@ -1,8 +1,22 @@
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
 #include "pembroke/buffer.hpp"
 #include "pembroke/internal/test_common.hpp"
 
+extern "C" {
+#include <unistd.h>
+}
+
 
 // ---
 // Basic Construction
@@ -180,6 +194,750 @@ TEST_CASE("reading bytes", "[buffer][read]") {
     }
 }
 
+// ---
+// Referenced Writes
+// ---
+
+TEST_CASE("referenced memory is not copied", "[buffer][write][reference]") {
+    static const std::string payload = "static payload";
+    auto b = pembroke::Buffer();
+    b.add("head:");
+    REQUIRE(b.add_reference(payload));
+    b.add(":tail");
+
+    CHECK(b.str() == "head:static payload:tail");
+    bool found = false;
+    for (auto segment : b.segments()) {
+        found = found || reinterpret_cast<const char *>(segment.bytes) == payload.data();
+    }
+    CHECK(found);
+}
+
+TEST_CASE("reference cleanup runs once the buffer releases the memory", "[buffer][write][reference]") {
+    std::string payload(4096, 'r');
+    int cleanups = 0;
+    {
+        auto b = pembroke::Buffer();
+        REQUIRE(b.add_reference(payload, [&cleanups]() { cleanups++; }));
+        CHECK(b.length() == payload.size());
+
+        // moving the buffer does not release the reference
+        auto moved = std::move(b);
+        CHECK(cleanups == 0);
+        CHECK(moved.str() == payload);
+    }
+    CHECK(cleanups == 1);
+}
+
+TEST_CASE("reference cleanup runs when the reference cannot be added", "[buffer][write][reference]") {
+    auto b = pembroke::Buffer();
+    auto moved = std::move(b);
+    int cleanups = 0;
+    CHECK_FALSE(b.add_reference("data", [&cleanups]() { cleanups++; }));  // NOLINT(bugprone-use-after-move)
+    CHECK(cleanups == 1);
+}
+
+TEST_CASE("a shared payload can be referenced by many buffers", "[buffer][write][reference]") {
+    auto payload = std::make_shared<const std::string>(8192, 's');
+    std::vector<pembroke::Buffer> buffers(10);
+    for (auto &b : buffers) {
+        REQUIRE(b.add_reference(payload));
+    }
+    CHECK(payload.use_count() == 11);
+    for (auto &b : buffers) {
+        CHECK(b.peek(payload->size()).bytes == reinterpret_cast<const std::byte *>(payload->data()));
+        CHECK(b.str() == *payload);
+    }
+
+    buffers.resize(4);
+    CHECK(payload.use_count() == 5);
+    buffers.clear();
+    CHECK(payload.use_count() == 1);
+}
+
+// ---
+// Segmented Reads
+// ---
+
+/* Fill a buffer with enough data that it is stored across several segments */
+static auto segmented_buffer(std::string &expected) -> pembroke::Buffer {
+    auto b = pembroke::Buffer();
+    for (int i = 0; i < 100; i++) {
+        std::string chunk(1000, static_cast<char>('a' + i % 26));
+        b.add(chunk);
+        expected += chunk;
+    }
+    return b;
+}
+
+static auto segment_count(const pembroke::Buffer &b, size_t limit = SIZE_MAX) -> size_t {
+    size_t n = 0;
+    for (auto it = b.segments(limit).begin(); it != b.segments(limit).end(); ++it) {
+        n++;
+    }
+    return n;
+}
+
+TEST_CASE("iterate over an empty buffer's segments", "[buffer][read][segments]") {
+    auto b = pembroke::Buffer();
+    CHECK(segment_count(b) == 0);
+    CHECK(b.peek(10).len == 0);
+    CHECK(b.view_prefix(10).empty());
+}
+
+TEST_CASE("segments cover the whole buffer without copying", "[buffer][read][segments]") {
+    std::string expected;
+    auto b = segmented_buffer(expected);
+    REQUIRE(segment_count(b) > 1);
+
+    std::string joined;
+    for (auto segment : b.segments()) {
+        CHECK(segment.len > 0);
+        joined.append(reinterpret_cast<const char *>(segment.bytes), segment.len);
+    }
+    CHECK(joined == expected);
+
+    // iterating does not linearize the buffer
+    CHECK(segment_count(b) > 1);
+    CHECK(b.str() == expected);
+    CHECK(segment_count(b) > 1);
+}
+
+TEST_CASE("segments can be limited to a prefix", "[buffer][read][segments]") {
+    std::string expected;
+    auto b = segmented_buffer(expected);
+    auto first = *b.segments().begin();
+
+    size_t total = 0;
+    for (auto segment : b.segments(first.len + 10)) {
+        total += segment.len;
+    }
+    CHECK(total == first.len + 10);
+    CHECK(segment_count(b, first.len + 10) == 2);
+    CHECK(segment_count(b, first.len) == 1);
+    CHECK(segment_count(b, 0) == 0);
+}
+
+TEST_CASE("peek returns the start of the first segment", "[buffer][read][segments]") {
+    std::string expected;
+    auto b = segmented_buffer(expected);
+    auto first = *b.segments().begin();
+
+    auto small = b.peek(10);
+    CHECK(small.len == 10);
+    CHECK(small.bytes == first.bytes);
+
+    // never spans segments
+    auto large = b.peek(expected.size());
+    CHECK(large.len == first.len);
+    CHECK(segment_count(b) > 1);
+}
+
+TEST_CASE("view_prefix linearizes only the prefix", "[buffer][read][segments]") {
+    std::string expected;
+    auto b = segmented_buffer(expected);
+    auto segments_before = segment_count(b);
+    auto first = *b.segments().begin();
+
+    // within the first segment: no copy at all
+    CHECK(b.view_prefix(10) == expected.substr(0, 10));
+    CHECK(reinterpret_cast<const std::byte *>(b.view_prefix(10).data()) == first.bytes);
+
+    // across segments: only the prefix is pulled together
+    auto n = first.len + 100;
+    CHECK(b.view_prefix(n) == expected.substr(0, n));
+    CHECK(segment_count(b) > 1);
+    CHECK(segment_count(b) <= segments_before);
+    CHECK(b.str() == expected);
+
+    // larger than the buffer
+    CHECK(b.view_prefix(expected.size() * 2) == expected);
+}
+
+// ---
+// Search
+// ---
+
+/* A buffer holding @p parts, one segment each */
+static auto buffer_of(const std::vector<std::string> &parts) -> pembroke::Buffer {
+    auto b = pembroke::Buffer();
+    for (const auto &part : parts) {
+        auto chunk = pembroke::Buffer();
+        chunk.add(part);
+        b.append(std::move(chunk));
+    }
+    return b;
+}
+
+TEST_CASE("find locates a pattern within a segment", "[buffer][search]") {
+    auto b = pembroke::Buffer();
+    b.add("GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\n");
+
+    CHECK(b.find("\r\n") == 24);
+    CHECK(b.find("\r\n", 25) == 43);
+    CHECK(b.find("\r\n\r\n") == 43);
+    CHECK(b.find("Host") == 26);
+    CHECK(b.find("missing") == pembroke::Buffer::npos);
+    CHECK(b.find("") == 0);
+    CHECK(b.find("GET", 1) == pembroke::Buffer::npos);
+}
+
+TEST_CASE("find locates a pattern straddling segments", "[buffer][search]") {
+    auto b = buffer_of({"header one\r", "\n", "header", " two\r\n\r", "\nbody"});
+    REQUIRE(segment_count(b) == 5);
+
+    CHECK(b.find("\r\n") == 10);
+    CHECK(b.find("\r\n\r\n") == 22);
+    CHECK(b.find("header two") == 12);
+    CHECK(b.find("\r\nheader two\r\n") == 10);
+    CHECK(b.find("body") == 26);
+    CHECK(b.find("\nbody") == 25);
+    CHECK(b.find("\r\n", 11) == 22);
+    CHECK(b.str().find("two\r\n\r\nbo") == b.find("two\r\n\r\nbo"));
+}
+
+TEST_CASE("find agrees with a search of the linearized buffer", "[buffer][search]") {
+    std::string expected;
+    auto b = segmented_buffer(expected);
+    // patterns that straddle every segment boundary of the 1000 byte chunks
+    for (size_t boundary = 1000; boundary < expected.size(); boundary += 1000) {
+        auto pattern = expected.substr(boundary - 3, 7);
+        CHECK(b.find(pattern) == expected.find(pattern));
+    }
+    CHECK(b.find(expected.substr(5, 2500)) == 5);
+}
+
+TEST_CASE("find_any locates the first of a set of bytes", "[buffer][search]") {
+    auto b = buffer_of({"key=value", "; other", "=thing\r\n"});
+    CHECK(b.find_any("=;") == 3);
+    CHECK(b.find_any(";") == 9);
+    CHECK(b.find_any("=", 4) == 16);
+    CHECK(b.find_any("\r\n") == 22);
+    CHECK(b.find_any("!") == pembroke::Buffer::npos);
+    CHECK(b.find_any("") == pembroke::Buffer::npos);
+}
+
+TEST_CASE("readln reads lines terminated by CRLF or LF", "[buffer][search][readln]") {
+    auto b = buffer_of({"first\r", "\nsecond\n", "thi", "rd"});
+    std::string line;
+
+    REQUIRE(b.readln(line));
+    CHECK(line == "first");
+    REQUIRE(b.readln(line));
+    CHECK(line == "second");
+    CHECK_FALSE(b.readln(line));
+    CHECK(b.str() == "third");
+
+    b.add("\r\n");
+    REQUIRE(b.readln(line));
+    CHECK(line == "third");
+    CHECK(b.length() == 0);
+}
+
+TEST_CASE("readln supports each line ending", "[buffer][search][readln]") {
+    std::string line;
+
+    SECTION("CRLF strict") {
+        auto b = buffer_of({"a\nb\r", "\nc"});
+        REQUIRE(b.readln(line, pembroke::LineEnding::CrlfStrict));
+        CHECK(line == "a\nb");
+        CHECK(b.str() == "c");
+    }
+    SECTION("LF") {
+        auto b = buffer_of({"a\r\nb"});
+        REQUIRE(b.readln(line, pembroke::LineEnding::Lf));
+        CHECK(line == "a\r");
+        CHECK(b.str() == "b");
+    }
+    SECTION("NUL") {
+        auto b = pembroke::Buffer();
+        b.add(std::string_view("a\0b", 3));
+        REQUIRE(b.readln(line, pembroke::LineEnding::Nul));
+        CHECK(line == "a");
+        CHECK(b.str() == "b");
+    }
+    SECTION("any") {
+        auto b = buffer_of({"a\r\n", "\n\r", "b\n"});
+        REQUIRE(b.readln(line, pembroke::LineEnding::Any));
+        CHECK(line == "a");
+        CHECK(b.str() == "b\n");
+        REQUIRE(b.readln(line, pembroke::LineEnding::Any));
+        CHECK(line == "b");
+        CHECK(b.length() == 0);
+    }
+    SECTION("empty lines") {
+        auto b = buffer_of({"\r\n\r\n"});
+        REQUIRE(b.readln(line));
+        CHECK(line.empty());
+        REQUIRE(b.readln(line));
+        CHECK(line.empty());
+        CHECK_FALSE(b.readln(line));
+    }
+}
+
+TEST_CASE("drain discards the start of the buffer", "[buffer][search]") {
+    auto b = buffer_of({"abc", "def"});
+    b.drain(4);
+    CHECK(b.str() == "ef");
+    b.drain(100);
+    CHECK(b.length() == 0);
+}
+
+// ---
+// Binary Encoding
+// ---
+
+TEST_CASE("integers are written in the requested byte order", "[buffer][binary]") {
+    auto b = pembroke::Buffer();
+    b.write_be<uint32_t>(0x01020304);
+    b.write_le<uint32_t>(0x01020304);
+    b.write_be<uint16_t>(0x0506);
+    b.write_le<int16_t>(-2);
+    b.write_be<uint8_t>(7);
+    CHECK(b.str() == std::string("\x01\x02\x03\x04\x04\x03\x02\x01\x05\x06\xfe\xff\x07", 13));
+}
+
+TEST_CASE("integers round-trip at every width", "[buffer][binary]") {
+    auto b = pembroke::Buffer();
+    b.write_be<uint8_t>(0xAB);
+    b.write_be<int16_t>(-12345);
+    b.write_le<uint32_t>(0xDEADBEEF);
+    b.write_be<int64_t>(-1234567890123456789);
+    b.write_le<uint64_t>(0x0102030405060708);
+
+    uint8_t u8 = 0;
+    int16_t i16 = 0;
+    uint32_t u32 = 0;
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    REQUIRE(b.read_be(u8));
+    REQUIRE(b.read_be(i16));
+    REQUIRE(b.read_le(u32));
+    REQUIRE(b.read_be(i64));
+    REQUIRE(b.read_le(u64));
+    CHECK(u8 == 0xAB);
+    CHECK(i16 == -12345);
+    CHECK(u32 == 0xDEADBEEF);
+    CHECK(i64 == -1234567890123456789);
+    CHECK(u64 == 0x0102030405060708);
+    CHECK(b.length() == 0);
+}
+
+TEST_CASE("integers are read across segment boundaries", "[buffer][binary]") {
+    auto b = buffer_of({"\x01", "\x02\x03", "\x04\x05"});
+    uint32_t value = 0;
+    REQUIRE(b.read_be(value));
+    CHECK(value == 0x01020304);
+    CHECK(b.length() == 1);
+
+    // too short: the buffer is left untouched
+    CHECK_FALSE(b.read_be(value));
+    CHECK(b.length() == 1);
+}
+
+TEST_CASE("varints round-trip", "[buffer][binary][varint]") {
+    auto b = pembroke::Buffer();
+    std::vector<uint64_t> values = {0, 1, 127, 128, 300, 16383, 16384, UINT32_MAX, UINT64_MAX};
+    for (auto v : values) {
+        b.write_varint(v);
+    }
+    CHECK(b.length() == 1 + 1 + 1 + 2 + 2 + 2 + 3 + 5 + 10);
+    for (auto v : values) {
+        uint64_t read = 0;
+        REQUIRE(b.read_varint(read));
+        CHECK(read == v);
+    }
+    CHECK(b.length() == 0);
+}
+
+TEST_CASE("varints follow LEB128", "[buffer][binary][varint]") {
+    auto b = pembroke::Buffer();
+    b.write_varint(300);
+    CHECK(b.str() == "\xac\x02");
+}
+
+TEST_CASE("incomplete and malformed varints are not read", "[buffer][binary][varint]") {
+    uint64_t value = 0;
+
+    auto incomplete = buffer_of({"\x80", "\x80"});
+    CHECK_FALSE(incomplete.read_varint(value));
+    CHECK(incomplete.length() == 2);
+    incomplete.add("\x01");
+    REQUIRE(incomplete.read_varint(value));
+    CHECK(value == 1U << 14);
+
+    auto too_long = pembroke::Buffer();
+    too_long.add(std::string(10, '\xff') + "\x01");
+    CHECK_FALSE(too_long.read_varint(value));
+    CHECK(too_long.length() == 11);
+}
+
+TEST_CASE("length-prefixed values round-trip", "[buffer][binary][prefixed]") {
+    auto b = pembroke::Buffer();
+    std::string large(1000, 'L');
+    REQUIRE(b.write_prefixed("varint"));
+    REQUIRE(b.write_prefixed<uint16_t>("u16"));
+    REQUIRE(b.write_prefixed<uint32_t>(large));
+    REQUIRE(b.write_prefixed(""));
+    CHECK_FALSE(b.write_prefixed<uint8_t>(large));
+
+    std::string out;
+    REQUIRE(b.read_prefixed(out));
+    CHECK(out == "varint");
+    REQUIRE(b.read_prefixed<uint16_t>(out));
+    CHECK(out == "u16");
+    auto moved = pembroke::Buffer();
+    REQUIRE(b.read_prefixed<uint32_t>(moved));
+    CHECK(moved.str() == large);
+    REQUIRE(b.read_prefixed(out));
+    CHECK(out.empty());
+    CHECK(b.length() == 0);
+}
+
+TEST_CASE("incomplete length-prefixed values are not read", "[buffer][binary][prefixed]") {
+    auto b = pembroke::Buffer();
+    b.write_be<uint32_t>(10);
+    b.add("short");
+
+    std::string out = "unchanged";
+    CHECK_FALSE(b.read_prefixed<uint32_t>(out));
+    CHECK(out == "unchanged");
+    CHECK(b.length() == 9);
+
+    b.add("-done");
+    REQUIRE(b.read_prefixed<uint32_t>(out));
+    CHECK(out == "short-done");
+}
+
+// ---
+// In-Place Writes
+// ---
+
+TEST_CASE("reserved space is written in place and committed", "[buffer][write][reserve]") {
+    auto b = pembroke::Buffer();
+    b.add("head:");
+
+    auto space = b.reserve(64, 1);
+    REQUIRE(space.count == 1);
+    REQUIRE(space.extents[0].len >= 64);
+    std::memcpy(space.extents[0].bytes, "in place", 8);
+    CHECK(b.length() == 5);  // nothing is added until committed
+
+    REQUIRE(b.commit(8));
+    CHECK(b.str() == "head:in place");
+    CHECK_FALSE(b.commit(0));  // the reservation has been used
+}
+
+TEST_CASE("reserved space may span several extents", "[buffer][write][reserve]") {
+    auto b = pembroke::Buffer();
+    b.add(std::string(1000, 'x'));
+
+    std::string expected(5000, '\0');
+    for (size_t i = 0; i < expected.size(); i++) {
+        expected[i] = static_cast<char>('a' + i % 26);
+    }
+
+    auto space = b.reserve(expected.size());
+    REQUIRE(space.count >= 1);
+    REQUIRE(space.size() >= expected.size());
+    size_t written = 0;
+    for (const auto &extent : space) {
+        auto n = std::min(extent.len, expected.size() - written);
+        std::memcpy(extent.bytes, expected.data() + written, n);
+        written += n;
+    }
+    REQUIRE(b.commit(written));
+    CHECK(b.str() == std::string(1000, 'x') + expected);
+}
+
+TEST_CASE("committing more than was reserved fails", "[buffer][write][reserve]") {
+    auto b = pembroke::Buffer();
+    CHECK_FALSE(b.commit(1));
+
+    auto space = b.reserve(16);
+    CHECK_FALSE(b.commit(space.size() + 1));
+    CHECK(b.length() == 0);
+}
+
+TEST_CASE("writer formats straight into the buffer", "[buffer][write][writer]") {
+    auto b = pembroke::Buffer();
+    b.add("head:");
+    {
+        auto out = b.writer();
+        fmt::format_to(out.begin(), "{} {} {:.2f}", 42, "answer", 3.14159);
+        out.put('!');
+    }
+    CHECK(b.str() == "head:42 answer 3.14!");
+}
+
+TEST_CASE("writer spills across chunks", "[buffer][write][writer]") {
+    auto b = pembroke::Buffer();
+    std::string expected;
+    {
+        auto out = b.writer(16);
+        for (int i = 0; i < 1000; i++) {
+            fmt::format_to(out.begin(), "line {}\n", i);
+            expected += fmt::format("line {}\n", i);
+        }
+        out.write("done");
+        expected += "done";
+
+        out.flush();
+        CHECK(b.str() == expected);
+        out.write("!");
+    }
+    CHECK(b.str() == expected + "!");
+}
+
+// ---
+// Moving Data Between Buffers
+// ---
+
+/* The start of every segment of a buffer, to check that data was moved rather than copied */
+static auto segment_starts(const pembroke::Buffer &b) -> std::vector<const std::byte *> {
+    std::vector<const std::byte *> starts;
+    for (auto segment : b.segments()) {
+        starts.push_back(segment.bytes);
+    }
+    return starts;
+}
+
+TEST_CASE("append moves all segments without copying", "[buffer][move_data]") {
+    std::string expected;
+    auto src = segmented_buffer(expected);
+    auto starts = segment_starts(src);
+
+    auto dest = pembroke::Buffer();
+    dest.add("head:");
+    {
+        pembroke::LibeventAllocationCounter allocations;
+        REQUIRE(dest.append(std::move(src)));
+        CHECK(allocations.count() == 0);
+    }
+
+    CHECK(src.length() == 0);  // NOLINT(bugprone-use-after-move)
+    CHECK(dest.str() == "head:" + expected);
+    auto moved = segment_starts(dest);
+    CHECK(std::vector<const std::byte *>(moved.end() - static_cast<ptrdiff_t>(starts.size()), moved.end()) == starts);
+}
+
+TEST_CASE("prepend moves all segments without copying", "[buffer][move_data]") {
+    std::string expected;
+    auto src = segmented_buffer(expected);
+    auto starts = segment_starts(src);
+
+    auto dest = pembroke::Buffer();
+    dest.add(":tail");
+    {
+        pembroke::LibeventAllocationCounter allocations;
+        REQUIRE(dest.prepend(std::move(src)));
+        CHECK(allocations.count() == 0);
+    }
+
+    CHECK(src.length() == 0);  // NOLINT(bugprone-use-after-move)
+    CHECK(dest.str() == expected + ":tail");
+    auto moved = segment_starts(dest);
+    CHECK(std::vector<const std::byte *>(moved.begin(), moved.begin() + static_cast<ptrdiff_t>(starts.size())) == starts);
+}
+
+TEST_CASE("move_prefix_to moves whole segments without copying", "[buffer][move_data]") {
+    std::string expected;
+    auto src = segmented_buffer(expected);
+    auto starts = segment_starts(src);
+    REQUIRE(starts.size() > 2);
+
+    /* Exactly the first two segments */
+    size_t n = 0;
+    auto it = src.segments().begin();
+    n += it->len;
+    ++it;
+    n += it->len;
+
+    auto dest = pembroke::Buffer();
+    CHECK(src.move_prefix_to(dest, n) == n);
+    CHECK(dest.str() == expected.substr(0, n));
+    CHECK(src.str() == expected.substr(n));
+    CHECK(segment_starts(dest) == std::vector<const std::byte *>(starts.begin(), starts.begin() + 2));
+    CHECK(segment_starts(src).front() == starts[2]);
+}
+
+TEST_CASE("move_prefix_to splits a segment", "[buffer][move_data]") {
+    auto src = pembroke::Buffer();
+    src.add("GET / HTTP/1.1\r\n\r\nGET /next");
+    auto dest = pembroke::Buffer();
+
+    CHECK(src.move_prefix_to(dest, 18) == 18);
+    CHECK(dest.str() == "GET / HTTP/1.1\r\n\r\n");
+    CHECK(src.str() == "GET /next");
+
+    // more than is available
+    CHECK(src.move_prefix_to(dest, 100) == 9);
+    CHECK(src.length() == 0);
+    CHECK(dest.length() == 27);
+}
+
+TEST_CASE("moving data to or from an invalid buffer fails", "[buffer][move_data]") {
+    auto a = pembroke::Buffer();
+    a.add("data");
+    auto moved_from = pembroke::Buffer();
+    auto c = std::move(moved_from);
+
+    CHECK_FALSE(a.append(std::move(moved_from)));  // NOLINT(bugprone-use-after-move)
+    CHECK_FALSE(a.append(std::move(a)));           // NOLINT(bugprone-use-after-move)
+    CHECK(a.move_prefix_to(moved_from, 2) == 0);
+    CHECK(a.move_prefix_to(a, 2) == 0);
+    CHECK(a.str() == "data");
+}
+
+// ---
+// File Descriptor I/O
+// ---
+
+/* Read everything currently readable from @p fd */
+static auto drain_fd(int fd) -> std::string {
+    auto b = pembroke::Buffer();
+    while (b.read_from(fd) > 0) {}
+    return b.str();
+}
+
+TEST_CASE("write_to writes every segment and drains the buffer", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    std::string expected;
+    auto b = segmented_buffer(expected);
+    REQUIRE(segment_count(b) > 1);
+
+    size_t written = 0;
+    std::string received;
+    while (b.length() > 0) {
+        auto n = b.write_to(sockets.left());
+        REQUIRE(n > 0);
+        written += static_cast<size_t>(n);
+        received += drain_fd(sockets.right());
+    }
+    CHECK(written == expected.size());
+    CHECK(received == expected);
+}
+
+TEST_CASE("write_to honors its limit", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    auto b = pembroke::Buffer();
+    b.add("hello, world");
+
+    CHECK(b.write_to(sockets.left(), 5) == 5);
+    CHECK(b.str() == ", world");
+    CHECK(drain_fd(sockets.right()) == "hello");
+}
+
+TEST_CASE("write_to leaves the unwritten bytes after a short write", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    auto b = pembroke::Buffer();
+    std::string payload(4 * 1024 * 1024, 'x');
+    b.add(payload);
+
+    auto n = b.write_to(sockets.left());
+    REQUIRE(n > 0);
+    CHECK(static_cast<size_t>(n) < payload.size());
+    CHECK(b.length() == payload.size() - static_cast<size_t>(n));
+
+    /* The socket is full until the peer reads */
+    while (b.write_to(sockets.left()) > 0) {}
+    CHECK((errno == EAGAIN || errno == EWOULDBLOCK));
+    CHECK(b.length() > 0);
+}
+
+TEST_CASE("read_from reads into the end of the buffer", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    std::string payload(100 * 1000, 'r');
+    REQUIRE(write(sockets.left(), payload.data(), payload.size()) > 0);
+
+    auto b = pembroke::Buffer();
+    b.add("head:");
+    CHECK(b.read_from(sockets.right(), 10) == 10);
+    CHECK(b.str() == "head:" + payload.substr(0, 10));
+
+    /* Without a limit a single read takes everything readable (more than libevent's 4 KiB) */
+    auto n = b.read_from(sockets.right());
+    CHECK(n > 4096);
+    CHECK(b.length() == 15 + static_cast<size_t>(n));
+}
+
+TEST_CASE("read_from reports end of file and would-block", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    auto b = pembroke::Buffer();
+    b.add("untouched");
+
+    CHECK(b.read_from(sockets.right()) == -1);
+    CHECK((errno == EAGAIN || errno == EWOULDBLOCK));
+    CHECK(b.str() == "untouched");
+
+    sockets.close_left();
+    CHECK(b.read_from(sockets.right()) == 0);
+    CHECK(b.str() == "untouched");
+}
+
+TEST_CASE("I/O on a moved-from buffer fails", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    auto b = pembroke::Buffer();
+    auto c = std::move(b);
+
+    CHECK(b.write_to(sockets.left()) == -1);  // NOLINT(bugprone-use-after-move)
+    CHECK(b.read_from(sockets.right()) == -1);
+    CHECK(errno == EINVAL);
+}
+
+TEST_CASE("write_batch writes several buffers in order", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    auto header = pembroke::Buffer();
+    header.add("HTTP/1.1 200 OK\r\n\r\n");
+    auto empty = pembroke::Buffer();
+    std::string expected_body;
+    auto body = segmented_buffer(expected_body);
+
+    auto n = pembroke::Buffer::write_batch(sockets.left(), {&header, &empty, &body});
+    REQUIRE(n > 0);
+    CHECK(header.length() == 0);
+    std::string received = drain_fd(sockets.right());
+    CHECK(received.size() == static_cast<size_t>(n));
+
+    while (body.length() > 0) {
+        REQUIRE(pembroke::Buffer::write_batch(sockets.left(), {&header, &empty, &body}) > 0);
+        received += drain_fd(sockets.right());
+    }
+    CHECK(received == "HTTP/1.1 200 OK\r\n\r\n" + expected_body);
+}
+
+TEST_CASE("write_batch honors its limit across buffers", "[buffer][io]") {
+    pembroke::SocketPair sockets;
+    auto a = pembroke::Buffer();
+    a.add("first,");
+    auto b = pembroke::Buffer();
+    b.add("second");
+
+    CHECK(pembroke::Buffer::write_batch(sockets.left(), {&a, &b}, 9) == 9);
+    CHECK(a.length() == 0);
+    CHECK(b.str() == "ond");
+    CHECK(drain_fd(sockets.right()) == "first,sec");
+
+    CHECK(pembroke::Buffer::write_batch(sockets.left(), {&a}) == 0);
+}
+
+TEST_CASE("write_batch writes a drains-to-fd buffer on its own", "[buffer][io][file_segment]") {
+    pembroke::SocketPair sockets;
+    pembroke::TempFile file("file contents");
+    auto head = pembroke::Buffer();
+    head.add("head:");
+    auto file_body = pembroke::Buffer();
+    file_body.drains_to_fd();
+    REQUIRE(file_body.add_file(file.path()));
+
+    /* The batch stops short of the file... */
+    CHECK(pembroke::Buffer::write_batch(sockets.left(), {&head, &file_body}) == 5);
+    CHECK(file_body.length() == 13);
+    /* ...which is then sent by libevent */
+    CHECK(pembroke::Buffer::write_batch(sockets.left(), {&head, &file_body}) == 13);
+    CHECK(drain_fd(sockets.right()) == "head:file contents");
+}
+
 // ---
 // Move Testing
 // ---
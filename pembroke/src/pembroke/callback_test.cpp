@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "pembroke/callback.hpp"
+#include "pembroke/reactor.hpp"
+#include "pembroke/event/delayed.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke;
+
+// ---
+// Construction
+// ---
+
+TEST_CASE("Callback is move-only", "[callback][construction]") {
+    CHECK_FALSE(std::is_copy_constructible_v<Callback>);
+    CHECK_FALSE(std::is_copy_assignable_v<Callback>);
+    CHECK(std::is_nothrow_move_constructible_v<Callback>);
+    CHECK(std::is_nothrow_move_assignable_v<Callback>);
+}
+
+TEST_CASE("Callback accepts callables that fit inline", "[callback][construction]") {
+    CHECK(std::is_constructible_v<Callback, void (*)()>);
+    CHECK(std::is_constructible_v<Callback, std::function<void()>>);
+    CHECK_FALSE(Callback{});
+
+    int x = 0;
+    Callback from_lambda{[&x]() -> void { x += 1; }};
+    CHECK(from_lambda);
+}
+
+// ---
+// Invocation
+// ---
+
+TEST_CASE("Callback invokes stored callable", "[callback][execution]") {
+    int x = 0;
+    Callback cb{[&x]() -> void { x += 1; }};
+    cb();
+    cb();
+    CHECK(x == 2);
+}
+
+TEST_CASE("Callback forwards arguments and return values", "[callback][execution]") {
+    InplaceCallback<int(int, std::string &&)> cb{[](int a, std::string &&s) -> int {
+        return a + static_cast<int>(s.size());
+    }};
+    CHECK(cb(1, "abc") == 4);
+}
+
+TEST_CASE("Callback supports mutable lambdas", "[callback][execution]") {
+    InplaceCallback<int()> cb{[n = 0]() mutable -> int { return ++n; }};
+    CHECK(cb() == 1);
+    CHECK(cb() == 2);
+}
+
+// ---
+// Ownership
+// ---
+
+TEST_CASE("Callback moves and destroys its callable", "[callback][ownership]") {
+    auto counter = std::make_shared<int>(0);
+    Callback c1{[counter]() -> void { *counter += 1; }};
+    CHECK(counter.use_count() == 2);
+
+    Callback c2{std::move(c1)};
+    CHECK_FALSE(c1);  // NOLINT(bugprone-use-after-move)
+    CHECK(counter.use_count() == 2);
+
+    c2();
+    CHECK(*counter == 1);
+
+    Callback c3;
+    c3 = std::move(c2);
+    c3();
+    CHECK(*counter == 2);
+
+    c3.reset();
+    CHECK_FALSE(c3);
+    CHECK(counter.use_count() == 1);
+}
+
+TEST_CASE("Callback with larger capacity holds larger captures", "[callback][ownership]") {
+    struct Big { char bytes[96]; };
+    Big big{};
+    big.bytes[95] = 7;
+
+    InplaceCallback<int(), sizeof(Big)> cb{[big]() -> int { return big.bytes[95]; }};
+    CHECK(cb() == 7);
+}
+
+// ---
+// Events
+// ---
+
+TEST_CASE("Events store typical callbacks inline", "[callback][event]") {
+    int x = 0;
+    std::string label = "event";
+
+    /* Storing a callable that fits is a placement-new into the callback, there is no
+     * allocation that could fail */
+    auto f = [&x, &label, ptr = &x]() -> void { *ptr += static_cast<int>(label.size()); };
+    CHECK(std::is_nothrow_constructible_v<Callback, decltype(f)>);
+
+    auto r = reactor().build();
+    auto delayed = event::DelayedEvent(0us, f);
+    CHECK(r->register_event(delayed));
+    CHECK(r->tick());
+    CHECK(x == 5);
+}
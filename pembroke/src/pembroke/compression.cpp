@@ -0,0 +1,272 @@
+#include "pembroke/compression.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <zlib.h>
+}
+
+namespace pembroke {
+
+    namespace {
+
+        /* zlib selects the framing through the window bits */
+        auto window_bits(CompressionFormat format) noexcept -> int {
+            switch (format) {
+                case CompressionFormat::Gzip:
+                    return MAX_WBITS + 16;
+                case CompressionFormat::Deflate:
+                    return MAX_WBITS;
+                case CompressionFormat::Raw:
+                    return -MAX_WBITS;
+            }
+            return MAX_WBITS;
+        }
+
+        auto clamp_uint(size_t n) noexcept -> uInt {
+            return static_cast<uInt>(std::min<size_t>(n, UINT_MAX));
+        }
+
+        /* Point the stream at the first segment of @p in (if any), returning its length */
+        auto next_input(z_stream &stream, Buffer *in) noexcept -> size_t {
+            auto segment = in == nullptr ? ByteSlice{nullptr, 0} : in->peek(Buffer::npos);
+            stream.next_in = reinterpret_cast<Bytef *>(segment.bytes);
+            stream.avail_in = clamp_uint(segment.len);
+            return stream.avail_in;
+        }
+
+        /* Point the stream at (at most @p limit bytes of) fresh output space at the end of
+         * @p out, returning its length or 0 if it cannot be reserved */
+        auto next_output(z_stream &stream, Buffer &out, size_t chunk, size_t limit) noexcept -> size_t {
+            auto space = out.reserve(std::min(chunk, limit), 1);
+            if (space.count == 0) {
+                return 0;
+            }
+            stream.next_out = reinterpret_cast<Bytef *>(space.extents[0].bytes);
+            stream.avail_out = clamp_uint(std::min(space.extents[0].len, limit));
+            return stream.avail_out;
+        }
+
+    } // namespace
+
+    // ---
+    // Compressor
+    // ---
+
+    Compressor::Compressor(CompressionFormat format, int level, size_t chunk)
+        : m_chunk(chunk) {
+        if (level != DefaultLevel && (level < Z_NO_COMPRESSION || level > Z_BEST_COMPRESSION)) {
+            throw ConfigurationException("Compression level must be between 0 and 9");
+        }
+        if (chunk == 0) {
+            throw ConfigurationException("Compression chunk size must be positive");
+        }
+        m_stream = new z_stream{};
+        if (deflateInit2(m_stream, level, Z_DEFLATED, window_bits(format), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            delete m_stream;
+            throw ConfigurationException("Unable to initialize compression stream");
+        }
+    }
+
+    Compressor::Compressor(Compressor &&other) noexcept
+        : m_stream(std::exchange(other.m_stream, nullptr)),
+          m_chunk(other.m_chunk),
+          m_finished(other.m_finished) {}
+
+    auto Compressor::operator=(Compressor &&other) noexcept -> Compressor & {
+        if (this != &other) {
+            if (m_stream != nullptr) {
+                deflateEnd(m_stream);
+                delete m_stream;
+            }
+            m_stream = std::exchange(other.m_stream, nullptr);
+            m_chunk = other.m_chunk;
+            m_finished = other.m_finished;
+        }
+        return *this;
+    }
+
+    Compressor::~Compressor() noexcept {
+        if (m_stream != nullptr) {
+            deflateEnd(m_stream);
+            delete m_stream;
+        }
+    }
+
+    auto Compressor::compress(Buffer &in, Buffer &out) noexcept -> bool {
+        return run(&in, out, Z_NO_FLUSH);
+    }
+
+    auto Compressor::flush(Buffer &out) noexcept -> bool {
+        return run(nullptr, out, Z_SYNC_FLUSH);
+    }
+
+    auto Compressor::finish(Buffer &out) noexcept -> bool {
+        if (m_finished) {
+            return true;
+        }
+        return run(nullptr, out, Z_FINISH);
+    }
+
+    auto Compressor::run(Buffer *in, Buffer &out, int flush) noexcept -> bool {
+        if (m_stream == nullptr) {
+            return false;
+        }
+        if (m_finished) {
+            pembroke::logger::warn("Unable to compress into a finished stream, reset it first");
+            return false;
+        }
+
+        for (;;) {
+            size_t input = next_input(*m_stream, in);
+            if (flush == Z_NO_FLUSH && input == 0) {
+                return true;
+            }
+            size_t space = next_output(*m_stream, out, m_chunk, Buffer::npos);
+            if (space == 0) {
+                pembroke::logger::warn("Unable to reserve space for compressed output");
+                return false;
+            }
+
+            int rc = deflate(m_stream, flush);
+            (void)out.commit(space - m_stream->avail_out);
+            if (in != nullptr) {
+                in->drain(input - m_stream->avail_in);
+            }
+
+            if (rc == Z_STREAM_END) {
+                m_finished = true;
+                return true;
+            }
+            if (rc == Z_STREAM_ERROR) {
+                pembroke::logger::warn("Compression stream is in an inconsistent state");
+                return false;
+            }
+            /* A flush is complete once deflate stops filling the output space it is given
+             * (Z_BUF_ERROR: there was nothing left to flush) */
+            if (flush != Z_NO_FLUSH && flush != Z_FINISH && (m_stream->avail_out != 0 || rc == Z_BUF_ERROR)) {
+                return true;
+            }
+        }
+    }
+
+    void Compressor::reset() noexcept {
+        if (m_stream != nullptr) {
+            deflateReset(m_stream);
+        }
+        m_finished = false;
+    }
+
+    auto Compressor::total_in() const noexcept -> uint64_t {
+        return m_stream == nullptr ? 0 : m_stream->total_in;
+    }
+
+    auto Compressor::total_out() const noexcept -> uint64_t {
+        return m_stream == nullptr ? 0 : m_stream->total_out;
+    }
+
+    // ---
+    // Decompressor
+    // ---
+
+    Decompressor::Decompressor(CompressionFormat format, size_t chunk)
+        : m_chunk(chunk) {
+        if (chunk == 0) {
+            throw ConfigurationException("Decompression chunk size must be positive");
+        }
+        m_stream = new z_stream{};
+        if (inflateInit2(m_stream, window_bits(format)) != Z_OK) {
+            delete m_stream;
+            throw ConfigurationException("Unable to initialize decompression stream");
+        }
+    }
+
+    Decompressor::Decompressor(Decompressor &&other) noexcept
+        : m_stream(std::exchange(other.m_stream, nullptr)),
+          m_chunk(other.m_chunk),
+          m_finished(other.m_finished),
+          m_full(other.m_full) {}
+
+    auto Decompressor::operator=(Decompressor &&other) noexcept -> Decompressor & {
+        if (this != &other) {
+            if (m_stream != nullptr) {
+                inflateEnd(m_stream);
+                delete m_stream;
+            }
+            m_stream = std::exchange(other.m_stream, nullptr);
+            m_chunk = other.m_chunk;
+            m_finished = other.m_finished;
+            m_full = other.m_full;
+        }
+        return *this;
+    }
+
+    Decompressor::~Decompressor() noexcept {
+        if (m_stream != nullptr) {
+            inflateEnd(m_stream);
+            delete m_stream;
+        }
+    }
+
+    auto Decompressor::decompress(Buffer &in, Buffer &out, size_t max_output) noexcept -> bool {
+        if (m_stream == nullptr) {
+            return false;
+        }
+
+        size_t produced = 0;
+        while (!m_finished && produced < max_output) {
+            size_t input = next_input(*m_stream, &in);
+            /* inflate may hold back output once the space it was given is full, so keep
+             * going after the input runs out until it stops filling the space */
+            if (input == 0 && !m_full) {
+                break;
+            }
+            size_t space = next_output(*m_stream, out, m_chunk, max_output - produced);
+            if (space == 0) {
+                pembroke::logger::warn("Unable to reserve space for decompressed output");
+                return false;
+            }
+
+            int rc = inflate(m_stream, Z_NO_FLUSH);
+            size_t written = space - m_stream->avail_out;
+            (void)out.commit(written);
+            in.drain(input - m_stream->avail_in);
+            produced += written;
+            m_full = m_stream->avail_out == 0;
+
+            if (rc == Z_STREAM_END) {
+                m_finished = true;
+            } else if (rc == Z_BUF_ERROR) {
+                break;
+            } else if (rc != Z_OK) {
+                pembroke::logger::warn(fmt::format("Unable to decompress stream: {}",
+                                                   m_stream->msg != nullptr ? m_stream->msg : zError(rc)));
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Decompressor::reset() noexcept {
+        if (m_stream != nullptr) {
+            inflateReset(m_stream);
+        }
+        m_finished = false;
+        m_full = false;
+    }
+
+    auto Decompressor::total_in() const noexcept -> uint64_t {
+        return m_stream == nullptr ? 0 : m_stream->total_in;
+    }
+
+    auto Decompressor::total_out() const noexcept -> uint64_t {
+        return m_stream == nullptr ? 0 : m_stream->total_out;
+    }
+
+} // namespace pembroke
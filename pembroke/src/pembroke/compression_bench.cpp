@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+#include "pembroke/buffer.hpp"
+#include "pembroke/compression.hpp"
+
+extern "C" {
+#include <zlib.h>
+}
+
+/*
+ * Gzipping a large, segmented payload: flattening it into a string and compressing that in
+ * one shot, versus streaming the buffer's segments through a Compressor.
+ */
+
+static constexpr size_t Lines = 64 * 1024;
+
+static auto payload() -> pembroke::Buffer {
+    pembroke::Buffer b;
+    for (size_t i = 0; i < Lines; i++) {
+        b.add("GET /static/" + std::to_string(i * 7919 % 1000) + ".css HTTP/1.1 200 " + std::to_string(i) + "\n");
+    }
+    return b;
+}
+
+/* The flattening path: str() the buffer, deflate it into a string, add that to the output */
+static void gzip_flat(pembroke::Buffer &in, pembroke::Buffer &out) {
+    auto flat = in.str();
+    in.drain(flat.size());
+
+    z_stream stream{};
+    REQUIRE(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    std::string compressed(deflateBound(&stream, flat.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(flat.data());
+    stream.avail_in = static_cast<uInt>(flat.size());
+    stream.next_out = reinterpret_cast<Bytef *>(compressed.data());
+    stream.avail_out = static_cast<uInt>(compressed.size());
+    REQUIRE(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+    compressed.resize(stream.total_out);
+    deflateEnd(&stream);
+    out.add(compressed);
+}
+
+TEST_CASE("Buffer compression: flatten vs stream", "[compression][benchmark]") {
+    size_t bytes = payload().length();
+
+    BENCHMARK_ADVANCED("str() + deflate, " + std::to_string(bytes / 1024) + "KiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> inputs(static_cast<size_t>(meter.runs()));
+        for (auto &in : inputs) {
+            in = payload();
+        }
+        meter.measure([&](int i) {
+            pembroke::Buffer out;
+            gzip_flat(inputs[static_cast<size_t>(i)], out);
+            return out.length();
+        });
+    };
+
+    BENCHMARK_ADVANCED("Compressor, " + std::to_string(bytes / 1024) + "KiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> inputs(static_cast<size_t>(meter.runs()));
+        for (auto &in : inputs) {
+            in = payload();
+        }
+        meter.measure([&](int i) {
+            pembroke::Buffer out;
+            pembroke::Compressor gzip;
+            gzip.compress(inputs[static_cast<size_t>(i)], out);
+            gzip.finish(out);
+            return out.length();
+        });
+    };
+}
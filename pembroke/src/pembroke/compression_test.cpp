@@ -0,0 +1,266 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "pembroke/compression.hpp"
+#include "pembroke/reactor.hpp"
+
+extern "C" {
+#include <zlib.h>
+}
+
+using pembroke::Buffer;
+using pembroke::CompressionFormat;
+using pembroke::Compressor;
+using pembroke::Decompressor;
+
+static auto buffer_of(std::string_view data) -> Buffer {
+    Buffer b;
+    b.add(data);
+    return b;
+}
+
+/* Text that compresses well, long enough to span several segments */
+static auto segmented_text(std::string &expected, size_t lines = 2000) -> Buffer {
+    Buffer b;
+    for (size_t i = 0; i < lines; i++) {
+        auto line = "line " + std::to_string(i) + ": the quick brown fox jumps over the lazy dog\n";
+        expected += line;
+        b.add(line);
+    }
+    return b;
+}
+
+static auto compress_all(const std::string &data, CompressionFormat format) -> Buffer {
+    Compressor c(format);
+    auto in = buffer_of(data);
+    Buffer out;
+    REQUIRE(c.compress(in, out));
+    REQUIRE(c.finish(out));
+    return out;
+}
+
+static auto decompress_all(Buffer &in, CompressionFormat format) -> std::string {
+    Decompressor d(format);
+    Buffer out;
+    REQUIRE(d.decompress(in, out));
+    CHECK(d.finished());
+    return out.str();
+}
+
+// ---
+// Construction
+// ---
+
+TEST_CASE("Compressors reject invalid configuration", "[compression][construction]") {
+    CHECK_THROWS_AS(Compressor(CompressionFormat::Gzip, 10), pembroke::ConfigurationException);
+    CHECK_THROWS_AS(Compressor(CompressionFormat::Gzip, -2), pembroke::ConfigurationException);
+    CHECK_THROWS_AS(Compressor(CompressionFormat::Gzip, 6, 0), pembroke::ConfigurationException);
+    CHECK_THROWS_AS(Decompressor(CompressionFormat::Gzip, 0), pembroke::ConfigurationException);
+    CHECK_NOTHROW(Compressor(CompressionFormat::Raw, 0));
+    CHECK_NOTHROW(Compressor(CompressionFormat::Deflate, 9));
+}
+
+// ---
+// Round Trips
+// ---
+
+TEST_CASE("Compressed buffers round trip in every format", "[compression]") {
+    auto format = GENERATE(CompressionFormat::Gzip, CompressionFormat::Deflate, CompressionFormat::Raw);
+
+    std::string expected;
+    auto in = segmented_text(expected);
+    Compressor c(format);
+    Buffer compressed;
+    REQUIRE(c.compress(in, compressed));
+    REQUIRE(c.finish(compressed));
+
+    CHECK(in.length() == 0);
+    CHECK(c.finished());
+    CHECK(c.total_in() == expected.size());
+    CHECK(c.total_out() == compressed.length());
+    CHECK(compressed.length() < expected.size() / 4);
+
+    CHECK(decompress_all(compressed, format) == expected);
+    CHECK(compressed.length() == 0);
+}
+
+TEST_CASE("Compressed output is readable by zlib", "[compression]") {
+    std::string expected;
+    auto in = segmented_text(expected, 100);
+    auto compressed = compress_all(in.str(), CompressionFormat::Deflate);
+
+    auto bytes = compressed.str();
+    std::string out(expected.size(), '\0');
+    uLongf out_len = out.size();
+    REQUIRE(uncompress(reinterpret_cast<Bytef *>(out.data()), &out_len,
+                       reinterpret_cast<const Bytef *>(bytes.data()), bytes.size()) == Z_OK);
+    CHECK(out == expected);
+
+    auto gzip = compress_all(expected, CompressionFormat::Gzip).str();
+    REQUIRE(gzip.size() > 2);
+    CHECK(static_cast<uint8_t>(gzip[0]) == 0x1f);
+    CHECK(static_cast<uint8_t>(gzip[1]) == 0x8b);
+}
+
+TEST_CASE("Compressors stream input across calls", "[compression]") {
+    Compressor c;
+    Decompressor d;
+    Buffer compressed;
+    Buffer restored;
+    std::string expected;
+
+    for (int i = 0; i < 50; i++) {
+        std::string chunk;
+        auto in = segmented_text(chunk, 100);
+        expected += chunk;
+        REQUIRE(c.compress(in, compressed));
+        CHECK(in.length() == 0);
+
+        /* Decompress as we go, a byte at a time for the first chunk */
+        if (i == 0) {
+            while (compressed.length() > 0) {
+                Buffer one;
+                REQUIRE(compressed.move_prefix_to(one, 1) == 1);
+                REQUIRE(d.decompress(one, restored));
+                CHECK(one.length() == 0);
+            }
+        } else {
+            REQUIRE(d.decompress(compressed, restored));
+        }
+    }
+    REQUIRE(c.finish(compressed));
+    REQUIRE(d.decompress(compressed, restored));
+    CHECK(d.finished());
+    CHECK(restored.str() == expected);
+}
+
+TEST_CASE("Compressors can be reset for another stream", "[compression]") {
+    Compressor c(CompressionFormat::Deflate);
+    Decompressor d(CompressionFormat::Deflate);
+
+    for (const std::string text : {"first stream", "second stream"}) {
+        auto in = buffer_of(text);
+        Buffer compressed;
+        Buffer out;
+        REQUIRE(c.compress(in, compressed));
+        REQUIRE(c.finish(compressed));
+        REQUIRE(d.decompress(compressed, out));
+        CHECK(d.finished());
+        CHECK(out.str() == text);
+
+        /* A finished stream refuses more input until it is reset */
+        auto more = buffer_of("more");
+        CHECK_FALSE(c.compress(more, compressed));
+        c.reset();
+        d.reset();
+        CHECK_FALSE(c.finished());
+        CHECK_FALSE(d.finished());
+    }
+}
+
+TEST_CASE("Moved compressors keep their stream", "[compression]") {
+    Compressor c(CompressionFormat::Raw);
+    auto in = buffer_of("moved");
+    Buffer compressed;
+    REQUIRE(c.compress(in, compressed));
+
+    Compressor moved(std::move(c));
+    REQUIRE(moved.finish(compressed));
+    CHECK_FALSE(c.finish(compressed));
+
+    Decompressor d(CompressionFormat::Raw);
+    Decompressor other(std::move(d));
+    Buffer out;
+    REQUIRE(other.decompress(compressed, out));
+    CHECK(out.str() == "moved");
+}
+
+// ---
+// Flush Points
+// ---
+
+TEST_CASE("Flushing makes all input so far decompressible", "[compression]") {
+    Compressor c;
+    Decompressor d;
+    Buffer compressed;
+    Buffer restored;
+
+    auto in = buffer_of("a message that has to reach the peer now");
+    REQUIRE(c.compress(in, compressed));
+    REQUIRE(c.flush(compressed));
+    REQUIRE(d.decompress(compressed, restored));
+    CHECK(restored.str() == "a message that has to reach the peer now");
+    CHECK_FALSE(d.finished());
+
+    /* Flushing again with nothing new is harmless */
+    REQUIRE(c.flush(compressed));
+    REQUIRE(d.decompress(compressed, restored));
+    CHECK(restored.length() == 40);
+
+    auto rest = buffer_of(" and the rest");
+    REQUIRE(c.compress(rest, compressed));
+    REQUIRE(c.finish(compressed));
+    REQUIRE(d.decompress(compressed, restored));
+    CHECK(d.finished());
+    CHECK(restored.str() == "a message that has to reach the peer now and the rest");
+}
+
+// ---
+// Decompression
+// ---
+
+TEST_CASE("Decompression output can be bounded", "[compression]") {
+    /* 1MiB of zeros compresses to about 1KiB */
+    auto compressed = compress_all(std::string(1024 * 1024, '\0'), CompressionFormat::Gzip);
+    Decompressor d(CompressionFormat::Gzip, 4096);
+    Buffer out;
+
+    REQUIRE(d.decompress(compressed, out, 10000));
+    CHECK(out.length() == 10000);
+    CHECK_FALSE(d.finished());
+
+    size_t calls = 1;
+    while (!d.finished()) {
+        Buffer chunk;
+        REQUIRE(d.decompress(compressed, chunk, 64 * 1024));
+        CHECK(chunk.length() <= 64 * 1024);
+        out.append(std::move(chunk));
+        REQUIRE(++calls < 100);
+    }
+    CHECK(out.length() == 1024 * 1024);
+    CHECK(d.total_out() == 1024 * 1024);
+    CHECK(compressed.length() == 0);
+}
+
+TEST_CASE("Decompression stops at the end of the stream", "[compression]") {
+    auto compressed = compress_all("payload", CompressionFormat::Deflate);
+    compressed.add("trailing bytes");
+
+    Decompressor d(CompressionFormat::Deflate);
+    Buffer out;
+    REQUIRE(d.decompress(compressed, out));
+    CHECK(d.finished());
+    CHECK(out.str() == "payload");
+    CHECK(compressed.str() == "trailing bytes");
+
+    /* Nothing more is consumed once finished */
+    REQUIRE(d.decompress(compressed, out));
+    CHECK(compressed.str() == "trailing bytes");
+}
+
+TEST_CASE("Corrupt streams fail to decompress", "[compression]") {
+    auto compressed = compress_all("a perfectly good payload", CompressionFormat::Gzip).str();
+    compressed[compressed.size() - 6] ^= 0x55;  // corrupt the checksum
+
+    Decompressor d(CompressionFormat::Gzip);
+    auto in = buffer_of(compressed);
+    Buffer out;
+    CHECK_FALSE(d.decompress(in, out));
+
+    Decompressor garbage(CompressionFormat::Deflate);
+    auto junk = buffer_of("this is not a zlib stream");
+    CHECK_FALSE(garbage.decompress(junk, out));
+}
@@ -1,5 +1,6 @@
 #include "pembroke/event/delayed.hpp"
 
+#include "pembroke/reactor.hpp"
 #include "pembroke/internal/logging.hpp"
 #include "pembroke/internal/util.hpp"
 
@@ -14,43 +15,94 @@ namespace pembroke::event {
     }
 
     DelayedEvent::DelayedEvent(DelayedEvent &&event) noexcept 
-        : m_delay(event.m_delay),
+        : Event(event),
+          m_delay(event.m_delay),
+          m_deadline(event.m_deadline),
           m_callback(std::move(event.m_callback)),
           m_timer_event(event.m_timer_event),
-          m_canceled(event.m_canceled) {
+          m_canceled(event.m_canceled),
+          m_wheel_entry(std::move(event.m_wheel_entry)),
+          m_use_timing_wheel(event.m_use_timing_wheel) {
         event.m_timer_event = nullptr;
+        m_wheel_entry.rebind(this);
     }
 
     auto DelayedEvent::operator=(DelayedEvent &&event) noexcept -> DelayedEvent& {
+        Event::operator=(event);
         m_delay = event.m_delay;
+        m_deadline = event.m_deadline;
         m_callback = std::move(event.m_callback);
         m_timer_event = event.m_timer_event;
         m_canceled = event.m_canceled;
+        m_wheel_entry = std::move(event.m_wheel_entry);
+        m_wheel_entry.rebind(this);
+        m_use_timing_wheel = event.m_use_timing_wheel;
 
         event.m_timer_event = nullptr;
         return *this;
     }
 
+    auto DelayedEvent::use_timing_wheel(bool val) noexcept -> DelayedEvent & {
+        m_use_timing_wheel = val;
+        return *this;
+    }
 
-    [[nodiscard]]
-    auto DelayedEvent::register_event(event_base &base) noexcept -> bool {
+    auto DelayedEvent::registrable() noexcept -> bool {
         // If we have canceled before registration, fail registration
         if (m_canceled) {
             pembroke::logger::warn("Attempting to register cancled timer-event");
             return false;
         }
 
-        if (m_timer_event != nullptr) {
+        if (m_timer_event != nullptr || m_wheel_entry.scheduled()) {
             pembroke::logger::error("Attempting to register a timer-event twice. "
                 "Create a new event or use a ScheduledEvent");
             return false;
         }
+        return true;
+    }
 
-        timeval tv = internal::to_timeval(m_delay);
+    [[nodiscard]]
+    auto DelayedEvent::register_event(Reactor &reactor) noexcept -> bool {
+        auto *wheel = reactor.timing_wheel();
+        if (!registrable()) {
+            return false;
+        }
+        if (m_instrumentation != nullptr) {
+            m_deadline = std::chrono::steady_clock::now() + m_delay;
+        }
+        if (!m_use_timing_wheel || wheel == nullptr) {
+            return add_timer(base_of(reactor), reactor.common_timeout(m_delay));
+        }
+        return wheel->schedule(m_wheel_entry, m_delay);
+    }
+
+    [[nodiscard]]
+    auto DelayedEvent::register_event(event_base &base) noexcept -> bool {
+        if (!registrable()) {
+            return false;
+        }
+        return add_timer(base, nullptr);
+    }
+
+    auto DelayedEvent::add_timer(event_base &base, const timeval *common) noexcept -> bool {
         m_timer_event = evtimer_new(&base, DelayedEvent::run_timer_cb, this);
-        int ret = evtimer_add(m_timer_event, &tv);
+        if (m_timer_event == nullptr) {
+            return false;
+        }
+        if (!apply_priority(m_timer_event)) {
+            pembroke::logger::warn("Unable to set priority of delayed-event");
+            event_free(m_timer_event);
+            m_timer_event = nullptr;
+            return false;
+        }
 
-        return ret == 0;
+        /* A common-timeout handle stands in for the timeval itself */
+        if (common != nullptr) {
+            return evtimer_add(m_timer_event, common) == 0;
+        }
+        timeval tv = internal::to_timeval(m_delay);
+        return evtimer_add(m_timer_event, &tv) == 0;
     }
 
     auto DelayedEvent::cancel() noexcept -> bool {
@@ -68,6 +120,7 @@ namespace pembroke::event {
             event_free(m_timer_event);
             m_timer_event = nullptr;
         }
+        m_wheel_entry.cancel();
 
         // always set internal canceled flag
         m_canceled = true;
@@ -79,9 +132,22 @@ namespace pembroke::event {
         ASSERT_RELEASE(cb != nullptr, "Timer event called with null timer object");
         auto *self = static_cast<DelayedEvent *>(cb);
         if (self->m_timer_event != nullptr) {
-            self->m_callback();
-            self->close_timer();
+            self->fire();
+        }
+    }
+
+    void DelayedEvent::run_wheel_cb(void *cb) noexcept {
+        ASSERT_RELEASE(cb != nullptr, "Timing wheel entry expired with null timer object");
+        auto *self = static_cast<DelayedEvent *>(cb);
+        self->fire();
+    }
+
+    void DelayedEvent::fire() noexcept {
+        if (m_instrumentation != nullptr) {
+            m_instrumentation->timer_fired(std::chrono::steady_clock::now() - m_deadline);
         }
+        run_callback(m_callback, CallbackKind::Delayed);
+        close_timer();
     }
 
 } // namespace pembroke::event
\ No newline at end of file
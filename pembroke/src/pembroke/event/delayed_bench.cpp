@@ -0,0 +1,46 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/event/delayed.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke::event;
+
+/*
+ * Register + cancel throughput for large numbers of live timeouts sharing a single
+ * duration, on libevent's timer heap versus a common-timeout queue declared with
+ * ReactorBuilder::common_timeout().
+ */
+
+static constexpr size_t LiveTimeouts = 100000;
+static constexpr auto IdleTimeout = 30s;
+
+static void register_cancel(pembroke::Reactor &r, std::vector<std::unique_ptr<DelayedEvent>> &live) {
+    for (auto &e : live) {
+        e = std::make_unique<DelayedEvent>(IdleTimeout, []() -> void {});
+        (void)r.register_event(*e);
+    }
+    for (auto &e : live) {
+        (void)e->cancel();
+    }
+}
+
+TEST_CASE("Timeout register/cancel: heap vs common timeout", "[event][delayed][benchmark]") {
+    auto heap = pembroke::reactor().build();
+    auto common = pembroke::reactor().common_timeout(IdleTimeout).build();
+    std::vector<std::unique_ptr<DelayedEvent>> live(LiveTimeouts);
+
+    BENCHMARK("heap, 100k register + cancel") {
+        register_cancel(*heap, live);
+        return live.size();
+    };
+
+    BENCHMARK("common timeout, 100k register + cancel") {
+        register_cancel(*common, live);
+        return live.size();
+    };
+}
@@ -2,9 +2,11 @@
 
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "pembroke/reactor.hpp"
 #include "pembroke/event/delayed.hpp"
+#include "pembroke/internal/test_common.hpp"
 
 using namespace std::chrono_literals;
 using namespace pembroke::event;
@@ -82,4 +84,44 @@ TEST_CASE("Cancel a scheduled, delayed event before registration", "[event][dela
     std::this_thread::sleep_for(10ms);
     CHECK(r->tick());
     CHECK(x == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Delayed events with a common timeout run in order", "[event][delayed][common_timeout]") {
+    auto r = pembroke::reactor().common_timeout(5ms).build();
+    std::vector<int> order;
+
+    REQUIRE(r->common_timeout(5ms) != nullptr);
+    CHECK(r->common_timeout(6ms) == nullptr);
+
+    auto first = DelayedEvent(5ms, [&]() -> void { order.push_back(1); });
+    CHECK(r->register_event(first));
+    CHECK(pembroke::on_common_timeout(*r, &first, r->common_timeout(5ms)));
+    std::this_thread::sleep_for(1ms);
+    auto second = DelayedEvent(5ms, [&]() -> void { order.push_back(2); });
+    CHECK(r->register_event(second));
+    auto third = DelayedEvent(5ms, [&]() -> void { order.push_back(3); });
+    CHECK(r->register_event(third));
+
+    auto done = DelayedEvent(30ms, [&]() -> void { CHECK(r->stop()); });
+    CHECK(r->register_event(done));
+    CHECK_FALSE(pembroke::on_common_timeout(*r, &done, r->common_timeout(5ms)));
+    CHECK(r->run_blocking());
+
+    CHECK(order == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("Cancel a delayed event with a common timeout", "[event][delayed][common_timeout]") {
+    auto r = pembroke::reactor().common_timeout(1ms).build();
+    auto x = 0;
+
+    auto event = DelayedEvent(1ms, [&]() -> void {
+        x += 1;
+    });
+    CHECK(r->register_event(event));
+    CHECK(pembroke::on_common_timeout(*r, &event, r->common_timeout(1ms)));
+    CHECK(event.cancel());
+
+    std::this_thread::sleep_for(10ms);
+    CHECK(r->tick());
+    CHECK(x == 0);
+}
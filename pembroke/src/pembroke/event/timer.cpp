@@ -1,5 +1,8 @@
 #include "pembroke/event/timer.hpp"
 
+#include <algorithm>
+
+#include "pembroke/reactor.hpp"
 #include "pembroke/internal/logging.hpp"
 #include "pembroke/internal/util.hpp"
 
@@ -14,47 +17,184 @@ namespace pembroke::event {
     }
 
     TimerEvent::TimerEvent (TimerEvent &&event) noexcept
-        : m_initial_delay(event.m_initial_delay),
+        : Event(event),
+          m_initial_delay(event.m_initial_delay),
           m_interval(event.m_interval),
           m_callback(std::move(event.m_callback)),
           m_timer_event(event.m_timer_event),
           m_canceled(event.m_canceled),
-          m_first_run(event.m_first_run) {
+          m_first_run(event.m_first_run),
+          m_wheel_entry(std::move(event.m_wheel_entry)),
+          m_wheel(event.m_wheel),
+          m_common_interval(event.m_common_interval),
+          m_use_timing_wheel(event.m_use_timing_wheel),
+          m_fixed_rate(event.m_fixed_rate),
+          m_missed_policy(event.m_missed_policy),
+          m_deadline(event.m_deadline),
+          m_lateness(event.m_lateness) {
 
         event.m_timer_event = nullptr;
+        m_wheel_entry.rebind(this);
     }
 
     auto TimerEvent::operator=(TimerEvent &&event) noexcept -> TimerEvent& {
+        Event::operator=(event);
         m_initial_delay = event.m_initial_delay;
         m_interval = event.m_interval;
         m_callback = std::move(event.m_callback);
         m_timer_event = event.m_timer_event;
         m_canceled = event.m_canceled;
         m_first_run = event.m_first_run;
+        m_wheel_entry = std::move(event.m_wheel_entry);
+        m_wheel_entry.rebind(this);
+        m_wheel = event.m_wheel;
+        m_common_interval = event.m_common_interval;
+        m_use_timing_wheel = event.m_use_timing_wheel;
+        m_fixed_rate = event.m_fixed_rate;
+        m_missed_policy = event.m_missed_policy;
+        m_deadline = event.m_deadline;
+        m_lateness = event.m_lateness;
 
         event.m_timer_event = nullptr;
         return *this;
     }
 
-    [[nodiscard]]
-    auto TimerEvent::register_event(event_base &base) noexcept -> bool {
+    auto TimerEvent::use_timing_wheel(bool val) noexcept -> TimerEvent & {
+        m_use_timing_wheel = val;
+        return *this;
+    }
+
+    auto TimerEvent::fixed_rate(MissedPolicy policy) noexcept -> TimerEvent & {
+        m_fixed_rate = true;
+        m_missed_policy = policy;
+        return *this;
+    }
+
+    auto TimerEvent::lateness() const noexcept -> duration {
+        return m_lateness;
+    }
+
+    auto TimerEvent::registrable() noexcept -> bool {
         // If we have canceled before registration, fail registration
         if (m_canceled) {
             pembroke::logger::warn("Attempting to register cancled timer-event");
             return false;
         }
 
-        if (m_timer_event != nullptr) {
+        /* The libevent timer is kept (un-pending) between firings, so only a pending
+         * timer counts as registered */
+        bool pending = m_timer_event != nullptr && evtimer_pending(m_timer_event, nullptr) != 0;
+        if (pending || m_wheel_entry.scheduled()) {
             pembroke::logger::error("Attempting to register a timer-event twice. "
                 "Create a new event or use a ScheduledEvent");
             return false;
         }
+        return true;
+    }
+
+    [[nodiscard]]
+    auto TimerEvent::register_event(Reactor &reactor) noexcept -> bool {
+        if (!registrable()) {
+            return false;
+        }
+
+        auto *wheel = reactor.timing_wheel();
+        auto delay = m_first_run ? m_initial_delay : m_interval;
+        m_deadline = std::chrono::steady_clock::now() + delay;
+        if (m_use_timing_wheel && wheel != nullptr) {
+            m_wheel = wheel;
+            return wheel->schedule(m_wheel_entry, delay);
+        }
+
+        if (!attach(base_of(reactor))) {
+            return false;
+        }
+        /* fixed-rate delays are computed from deadlines and will not match exactly */
+        m_common_interval = m_fixed_rate ? nullptr : reactor.common_timeout(m_interval);
+        return arm(delay, reactor.common_timeout(delay));
+    }
+
+    [[nodiscard]]
+    auto TimerEvent::register_event(event_base &base) noexcept -> bool {
+        if (!registrable()) {
+            return false;
+        }
+        if (!attach(base)) {
+            return false;
+        }
+
+        auto delay = m_first_run ? m_initial_delay : m_interval;
+        m_deadline = std::chrono::steady_clock::now() + delay;
+        m_common_interval = nullptr;
+        return arm(delay);
+    }
+
+    auto TimerEvent::attach(event_base &base) noexcept -> bool {
+        /* The event is allocated once and then re-used for every firing (and
+         * re-assigned rather than re-allocated if registered on another base) */
+        if (m_timer_event == nullptr) {
+            m_timer_event = evtimer_new(&base, TimerEvent::run_timer_cb, this);
+            if (m_timer_event == nullptr) {
+                return false;
+            }
+        } else if (event_get_base(m_timer_event) != &base) {
+            evtimer_assign(m_timer_event, &base, TimerEvent::run_timer_cb, this);
+        }
+
+        if (!apply_priority(m_timer_event)) {
+            pembroke::logger::warn("Unable to set priority of timer-event");
+            return false;
+        }
+        return true;
+    }
 
-        timeval tv = internal::to_timeval(m_first_run ? m_initial_delay : m_interval);
-        m_timer_event = evtimer_new(&base, TimerEvent::run_timer_cb, this);
-        int ret = evtimer_add(m_timer_event, &tv);
+    auto TimerEvent::arm(duration delay, const timeval *common) noexcept -> bool {
+        /* libevent computes timeouts from the time cached at the start of the loop
+         * iteration, refresh it so that time spent in callbacks is accounted for */
+        event_base_update_cache_time(event_get_base(m_timer_event));
+        if (common != nullptr) {
+            return evtimer_add(m_timer_event, common) == 0;
+        }
+        timeval tv = internal::to_timeval(delay);
+        return evtimer_add(m_timer_event, &tv) == 0;
+    }
 
-        return ret == 0;
+    void TimerEvent::start_firing() noexcept {
+        auto late = std::chrono::steady_clock::now() - m_deadline;
+        m_lateness = std::max(no_delay, std::chrono::duration_cast<duration>(late));
+        if (m_instrumentation != nullptr) {
+            m_instrumentation->timer_fired(late);
+        }
+    }
+
+    auto TimerEvent::next_delay() noexcept -> duration {
+        auto now = std::chrono::steady_clock::now();
+        if (!m_fixed_rate) {
+            m_deadline = now + m_interval;
+            return m_interval;
+        }
+
+        auto next = m_deadline + m_interval;
+        if (next > now || m_interval <= no_delay) {
+            m_deadline = next;
+            return std::max(no_delay, std::chrono::duration_cast<duration>(next - now));
+        }
+
+        // At least one deadline has been missed entirely
+        auto behind = std::chrono::duration_cast<duration>(now - next);
+        auto missed = behind / m_interval;  // whole periods missed after `next`
+        switch (m_missed_policy) {
+        case MissedPolicy::Skip:
+            m_deadline = next + (missed + 1) * m_interval;
+            return std::chrono::duration_cast<duration>(m_deadline - now);
+        case MissedPolicy::Coalesce:
+            m_deadline = next + missed * m_interval;
+            return no_delay;
+        case MissedPolicy::CatchUp:
+        default:
+            m_deadline = next;
+            return no_delay;
+        }
     }
 
     auto TimerEvent::cancel() noexcept -> bool {
@@ -73,6 +213,7 @@ namespace pembroke::event {
             event_free(m_timer_event);
             m_timer_event = nullptr;
         }
+        m_wheel_entry.cancel();
         return ret;
     }
 
@@ -85,21 +226,42 @@ namespace pembroke::event {
             return;
         }
 
-        self->m_callback();
+        self->start_firing();
+        self->run_callback(self->m_callback, CallbackKind::Timer);
+        self->m_first_run = false;
+
+        /* The callback may have canceled (freeing the timer) or re-registered the timer,
+         * in which case there is nothing left to do */
+        if (self->m_canceled || self->m_timer_event == nullptr
+                || evtimer_pending(self->m_timer_event, nullptr) != 0) {
+            return;
+        }
 
-        /* Capture base of current timer. Assume that we can re-register on
-         * the same base. */
-        auto *base = event_get_base(self->m_timer_event);
+        /* Re-arm the same (now non-pending) event for the next iteration. This does
+         * not touch the heap, so a repeating timer never allocates after its first
+         * registration. */
+        auto delay = self->next_delay();
+        auto ret = self->arm(delay, delay == self->m_interval ? self->m_common_interval : nullptr);
+        ASSERT_DEBUG(ret, "Failed to update timer event on the reactor");
+    }
 
-        // Perform cleanup for current timer
-        self->close_timer();
+    void TimerEvent::run_wheel_cb(void *cb) noexcept {
+        ASSERT_RELEASE(cb != nullptr, "Timing wheel entry expired with null timer object");
+        auto *self = static_cast<TimerEvent *>(cb);
+        if (self->m_canceled) {
+            return;
+        }
+
+        self->start_firing();
+        self->run_callback(self->m_callback, CallbackKind::Timer);
         self->m_first_run = false;
-        self->m_canceled = false;
 
-        // Register next iterations of the timer
-        ASSERT_DEBUG(base != nullptr, "Attempting to register timer on inactive event base");
-        auto ret = self->register_event(*base);
-        ASSERT_DEBUG(ret, "Failed to update timer event on the reactor");
+        /* The callback may have canceled (or re-registered) the timer */
+        if (self->m_canceled || self->m_wheel_entry.scheduled()) {
+            return;
+        }
+        auto ret = self->m_wheel->schedule(self->m_wheel_entry, self->next_delay());
+        ASSERT_DEBUG(ret, "Failed to update timer event on the timing wheel");
     }
 
-} // namespace pembroke::event
\ No newline at end of file
+} // namespace pembroke::event
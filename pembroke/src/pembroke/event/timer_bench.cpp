@@ -0,0 +1,58 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/event/timer.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke::event;
+
+/*
+ * Cost of repeating-timer firings (callback + re-arm) and the number of libevent
+ * heap allocations they perform, which should be zero. The instrumented variant shows
+ * the overhead of timing every callback and tick.
+ */
+
+static constexpr int FiringsPerRun = 10000;
+
+TEST_CASE("TimerEvent firing", "[event][timer][benchmark]") {
+    auto r = pembroke::reactor().build();
+    auto x = 0;
+
+    auto event = TimerEvent(0us, 0us, [&]() -> void {
+        if (++x % FiringsPerRun == 0) {
+            (void)r->stop();
+        }
+    });
+    REQUIRE(r->register_event(event));
+
+    pembroke::LibeventAllocationCounter allocations;
+    BENCHMARK("zero-interval timer, 10k firings") {
+        return r->run_blocking();
+    };
+
+    INFO("firings: " << x << ", libevent allocations: " << allocations.count());
+    CHECK(allocations.count() == 0);
+}
+
+TEST_CASE("TimerEvent firing, instrumented", "[event][timer][instrumentation][benchmark]") {
+    auto r = pembroke::reactor().instrument().build();
+    auto x = 0;
+
+    auto event = TimerEvent(0us, 0us, [&]() -> void {
+        if (++x % FiringsPerRun == 0) {
+            (void)r->stop();
+        }
+    });
+    REQUIRE(r->register_event(event));
+
+    BENCHMARK("zero-interval timer, 10k firings, instrumented") {
+        return r->run_blocking();
+    };
+
+    auto snap = r->instrumentation()->snapshot();
+    INFO("callback p50: " << snap.callbacks_of(pembroke::CallbackKind::Timer).percentile(50).count() << "ns");
+    CHECK(snap.callbacks_of(pembroke::CallbackKind::Timer).count() == static_cast<uint64_t>(x));
+}
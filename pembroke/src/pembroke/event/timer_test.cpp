@@ -3,10 +3,13 @@
 #include <chrono>
 #include <iostream>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "pembroke/logging.hpp"
 #include "pembroke/reactor.hpp"
 #include "pembroke/event/timer.hpp"
+#include "pembroke/internal/test_common.hpp"
 
 using namespace std::chrono_literals;
 using namespace pembroke::event;
@@ -115,4 +118,166 @@ TEST_CASE("Cancel a scheduled, delayed timer before registration", "[event][dela
     CHECK(r->tick());
     CHECK(x == 0);
     CHECK(event.canceled());
-}
\ No newline at end of file
+}
+
+TEST_CASE("Cancel a timer from within its own callback", "[event][timer][execution]") {
+    auto r = pembroke::reactor().build();
+    auto x = 0;
+
+    TimerEvent *self = nullptr;
+    auto event = TimerEvent(0us, 10us, [&]() -> void {
+        x += 1;
+        CHECK(self->cancel());
+    });
+    self = &event;
+    CHECK(r->register_event(event));
+
+    CHECK(r->tick());
+    std::this_thread::sleep_for(10ms);
+    CHECK(r->tick());
+
+    CHECK(event.canceled());
+    CHECK(x == 1);
+}
+
+TEST_CASE("Repeating timer does not allocate after first registration", "[event][timer][allocation]") {
+    auto r = pembroke::reactor().build();
+    auto x = 0;
+
+    auto event = TimerEvent(0us, 0us, [&]() -> void {
+        x += 1;
+        if (x == 1 || x == 101) {
+            CHECK(r->stop());
+        }
+    });
+    CHECK(r->register_event(event));
+
+    // warm-up: first registration and firing may allocate
+    CHECK(r->run_blocking());
+    CHECK(x == 1);
+
+    pembroke::LibeventAllocationCounter allocations;
+    CHECK(r->run_blocking());
+    CHECK(x == 101);
+    CHECK(allocations.count() == 0);
+}
+
+// ---
+// Fixed-Rate Timers
+// ---
+
+/* Run a fixed-rate timer whose first callback blocks for `first_run`, stopping after
+ * `firings` runs and recording each run's start time and lateness */
+static auto run_fixed_rate(MissedPolicy policy, pembroke::duration interval,
+                           pembroke::duration first_run, size_t firings)
+    -> std::pair<std::vector<std::chrono::steady_clock::time_point>, std::vector<pembroke::duration>> {
+    auto r = pembroke::reactor().build();
+    std::vector<std::chrono::steady_clock::time_point> starts;
+    std::vector<pembroke::duration> lateness;
+
+    TimerEvent *self = nullptr;
+    auto event = TimerEvent(0us, interval, [&]() -> void {
+        starts.push_back(std::chrono::steady_clock::now());
+        lateness.push_back(self->lateness());
+        if (starts.size() == 1) {
+            std::this_thread::sleep_for(first_run);
+        }
+        if (starts.size() == firings) {
+            CHECK(r->stop());
+        }
+    });
+    self = &event;
+    event.fixed_rate(policy);
+    CHECK(r->register_event(event));
+    CHECK(r->run_blocking());
+
+    return {starts, lateness};
+}
+
+TEST_CASE("Fixed-rate timer does not drift with callback duration", "[event][timer][fixed_rate]") {
+    auto r = pembroke::reactor().build();
+    std::vector<std::chrono::steady_clock::time_point> starts;
+
+    auto event = TimerEvent(0us, 20ms, [&]() -> void {
+        starts.push_back(std::chrono::steady_clock::now());
+        std::this_thread::sleep_for(10ms);
+        if (starts.size() == 6) {
+            CHECK(r->stop());
+        }
+    });
+    event.fixed_rate();
+    CHECK(r->register_event(event));
+    CHECK(r->run_blocking());
+
+    // A fixed-delay timer would take 5 * 30ms
+    auto elapsed = starts.back() - starts.front();
+    CHECK(elapsed >= 95ms);
+    CHECK(elapsed < 140ms);
+}
+
+TEST_CASE("Fixed-rate timer skips missed periods", "[event][timer][fixed_rate]") {
+    auto [starts, lateness] = run_fixed_rate(MissedPolicy::Skip, 50ms, 175ms, 2);
+
+    // the deadlines at 50, 100 and 150ms are dropped, next run is on schedule at 200ms
+    CHECK(starts[1] - starts[0] >= 195ms);
+    CHECK(lateness[1] < 25ms);
+}
+
+TEST_CASE("Fixed-rate timer coalesces missed periods", "[event][timer][fixed_rate]") {
+    auto [starts, lateness] = run_fixed_rate(MissedPolicy::Coalesce, 50ms, 175ms, 3);
+
+    // a single immediate run for the 150ms deadline, then back on schedule at 200ms
+    CHECK(starts[1] - starts[0] < 195ms);
+    CHECK(lateness[1] >= 20ms);
+    CHECK(lateness[1] < 50ms);
+    CHECK(starts[2] - starts[0] >= 195ms);
+}
+
+TEST_CASE("Fixed-rate timer catches up on missed periods", "[event][timer][fixed_rate]") {
+    auto [starts, lateness] = run_fixed_rate(MissedPolicy::CatchUp, 50ms, 175ms, 4);
+
+    // runs for the 50, 100 and 150ms deadlines happen back-to-back
+    CHECK(lateness[1] >= 120ms);
+    CHECK(lateness[2] >= 70ms);
+    CHECK(lateness[3] >= 20ms);
+    CHECK(starts[3] - starts[1] < 25ms);
+}
+
+TEST_CASE("Timer reports lateness of each firing", "[event][timer][fixed_rate]") {
+    auto r = pembroke::reactor().build();
+    pembroke::duration observed = -1us;
+
+    TimerEvent *self = nullptr;
+    auto event = TimerEvent(1ms, 1ms, [&]() -> void {
+        observed = self->lateness();
+        CHECK(r->stop());
+    });
+    self = &event;
+    CHECK(r->register_event(event));
+
+    // block past the deadline before the loop gets a chance to run it
+    std::this_thread::sleep_for(20ms);
+    CHECK(r->run_blocking());
+    CHECK(observed >= 15ms);
+}
+
+TEST_CASE("Timer repeats on a common timeout", "[event][timer][common_timeout]") {
+    auto r = pembroke::reactor().common_timeout(1ms).build();
+    auto x = 0;
+    REQUIRE(r->common_timeout(1ms) != nullptr);
+    CHECK(r->common_timeout(2ms) == nullptr);
+
+    auto event = TimerEvent(1ms, 1ms, [&]() -> void {
+        x += 1;
+        if (x == 5) {
+            CHECK(r->stop());
+        }
+    });
+    CHECK(r->register_event(event));
+    CHECK(pembroke::on_common_timeout(*r, &event, r->common_timeout(1ms)));
+    CHECK(r->run_blocking());
+    CHECK(x == 5);
+
+    /* Re-armed on the common timeout after every run */
+    CHECK(pembroke::on_common_timeout(*r, &event, r->common_timeout(1ms)));
+}
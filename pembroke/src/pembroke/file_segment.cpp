@@ -0,0 +1,146 @@
+#include "pembroke/file_segment.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+extern "C" {
+#include <event2/buffer.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+namespace pembroke {
+
+    // ---
+    // File Segment
+    // ---
+
+    auto FileSegment::open(const std::string &path, int64_t offset, int64_t length) noexcept -> FileSegment {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            pembroke::logger::warn(fmt::format("Unable to open file {}: {}", path, std::strerror(errno)));
+            return FileSegment();
+        }
+        return adopt(fd, offset, length);
+    }
+
+    auto FileSegment::adopt(int fd, int64_t offset, int64_t length) noexcept -> FileSegment {
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || offset < 0 || offset > st.st_size) {
+            pembroke::logger::warn(fmt::format("Unable to create file segment at offset {} of fd {}", offset, fd));
+            close(fd);
+            return FileSegment();
+        }
+        if (length < 0 || length > st.st_size - offset) {
+            length = st.st_size - offset;
+        }
+
+        auto *segment = evbuffer_file_segment_new(fd, offset, length, EVBUF_FS_CLOSE_ON_FREE);
+        if (segment == nullptr) {
+            pembroke::logger::warn(fmt::format("Unable to create file segment for fd {}", fd));
+            close(fd);
+            return FileSegment();
+        }
+
+        FileSegment fs;
+        fs.m_segment = segment;
+        fs.m_length = length;
+        return fs;
+    }
+
+    FileSegment::FileSegment(FileSegment &&other) noexcept
+        : m_segment(std::exchange(other.m_segment, nullptr)),
+          m_length(std::exchange(other.m_length, 0)) {}
+
+    auto FileSegment::operator=(FileSegment &&other) noexcept -> FileSegment & {
+        if (this != &other) {
+            if (m_segment != nullptr) {
+                evbuffer_file_segment_free(m_segment);
+            }
+            m_segment = std::exchange(other.m_segment, nullptr);
+            m_length = std::exchange(other.m_length, 0);
+        }
+        return *this;
+    }
+
+    FileSegment::~FileSegment() noexcept {
+        if (m_segment != nullptr) {
+            // only drops our reference, buffers holding the segment keep it open
+            evbuffer_file_segment_free(m_segment);
+        }
+    }
+
+    // ---
+    // File Segment Cache
+    // ---
+
+    FileSegmentCache::FileSegmentCache(size_t capacity) noexcept
+        : m_capacity(capacity) {}
+
+    auto FileSegmentCache::get(const std::string &path) noexcept -> const FileSegment * {
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0) {
+            pembroke::logger::warn(fmt::format("Unable to stat file {}: {}", path, std::strerror(errno)));
+            evict(path);
+            return nullptr;
+        }
+
+        auto it = m_entries.find(path);
+        if (it != m_entries.end()) {
+            auto &entry = it->second;
+            if (entry.device == st.st_dev && entry.inode == st.st_ino && entry.size == st.st_size
+                    && entry.mtime.tv_sec == st.st_mtim.tv_sec && entry.mtime.tv_nsec == st.st_mtim.tv_nsec) {
+                m_order.splice(m_order.begin(), m_order, entry.position);
+                return &entry.segment;
+            }
+            evict(path);
+        }
+
+        auto segment = FileSegment::open(path);
+        if (!segment) {
+            return nullptr;
+        }
+
+        while (!m_order.empty() && m_entries.size() >= m_capacity) {
+            m_entries.erase(m_order.back());
+            m_order.pop_back();
+        }
+        m_order.push_front(path);
+        auto [inserted, _] = m_entries.emplace(path, Entry{
+            std::move(segment),
+            static_cast<uint64_t>(st.st_dev),
+            static_cast<uint64_t>(st.st_ino),
+            static_cast<int64_t>(st.st_size),
+            st.st_mtim,
+            m_order.begin(),
+        });
+        return &inserted->second.segment;
+    }
+
+    void FileSegmentCache::evict(const std::string &path) noexcept {
+        auto it = m_entries.find(path);
+        if (it == m_entries.end()) {
+            return;
+        }
+        m_order.erase(it->second.position);
+        m_entries.erase(it);
+    }
+
+    void FileSegmentCache::clear() noexcept {
+        m_entries.clear();
+        m_order.clear();
+    }
+
+    auto FileSegmentCache::size() const noexcept -> size_t {
+        return m_entries.size();
+    }
+
+    auto FileSegmentCache::capacity() const noexcept -> size_t {
+        return m_capacity;
+    }
+
+} // namespace pembroke
@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pembroke/buffer.hpp"
+#include "pembroke/file_segment.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+extern "C" {
+#include <unistd.h>
+}
+
+/*
+ * Serving a static file: reading it into memory and copying it into each response buffer,
+ * versus adding the (cached) file segment to each response.
+ */
+
+static constexpr size_t FileBytes = 16 * 1024 * 1024;
+static constexpr size_t Responses = 32;
+
+/* The copy path: read the whole file, then copy it into the buffer */
+static void add_copy(pembroke::Buffer &b, const std::string &path) {
+    std::string contents(FileBytes, '\0');
+    FILE *f = fopen(path.c_str(), "r");
+    REQUIRE(f != nullptr);
+    REQUIRE(fread(contents.data(), 1, contents.size(), f) == contents.size());
+    fclose(f);
+    b.add(contents);
+}
+
+static auto resident_bytes() -> size_t {
+    size_t pages = 0;
+    size_t resident = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f == nullptr) {
+        return 0;
+    }
+    if (fscanf(f, "%zu %zu", &pages, &resident) != 2) {
+        resident = 0;
+    }
+    fclose(f);
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+TEST_CASE("Buffer file: copy vs file segment", "[file_segment][benchmark]") {
+    pembroke::TempFile file(std::string(FileBytes, 'f'));
+    pembroke::FileSegmentCache cache(4);
+
+    BENCHMARK_ADVANCED("read + add (copy), 16MiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        meter.measure([&](int i) {
+            add_copy(buffers[static_cast<size_t>(i)], file.path());
+        });
+    };
+
+    BENCHMARK_ADVANCED("add_file (cached segment), 16MiB")(Catch::Benchmark::Chronometer meter) {
+        std::vector<pembroke::Buffer> buffers(static_cast<size_t>(meter.runs()));
+        meter.measure([&](int i) {
+            return buffers[static_cast<size_t>(i)].add_file(*cache.get(file.path()));
+        });
+    };
+
+    /* Memory held by a backlog of queued responses that have not been sent yet */
+    {
+        auto before = resident_bytes();
+        std::vector<pembroke::Buffer> queued(Responses);
+        for (auto &b : queued) {
+            add_copy(b, file.path());
+        }
+        WARN("copy: " << Responses << " queued 16MiB responses add "
+             << (resident_bytes() - before) / (1024 * 1024) << "MiB resident");
+    }
+    {
+        auto before = resident_bytes();
+        std::vector<pembroke::Buffer> queued(Responses);
+        for (auto &b : queued) {
+            b.drains_to_fd();
+            b.add_file(*cache.get(file.path()));
+        }
+        WARN("file segment: " << Responses << " queued 16MiB responses add "
+             << (resident_bytes() - before) / (1024 * 1024) << "MiB resident");
+    }
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pembroke/buffer.hpp"
+#include "pembroke/file_segment.hpp"
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+using pembroke::Buffer;
+using pembroke::FileSegment;
+using pembroke::FileSegmentCache;
+using pembroke::TempFile;
+
+// ---
+// File Segments
+// ---
+
+TEST_CASE("FileSegment of a missing file is invalid", "[file_segment]") {
+    auto segment = FileSegment::open("/nonexistent/pembroke-file");
+    CHECK_FALSE(segment);
+    CHECK(segment.underlying() == nullptr);
+
+    auto b = Buffer();
+    CHECK_FALSE(b.add_file(segment));
+    CHECK_FALSE(b.add_file("/nonexistent/pembroke-file"));
+    CHECK(b.length() == 0);
+}
+
+TEST_CASE("FileSegment covers the requested range of the file", "[file_segment]") {
+    TempFile file("0123456789");
+    CHECK(FileSegment::open(file.path()).length() == 10);
+    CHECK(FileSegment::open(file.path(), 4).length() == 6);
+    CHECK(FileSegment::open(file.path(), 4, 3).length() == 3);
+    CHECK(FileSegment::open(file.path(), 4, 100).length() == 6);
+    CHECK_FALSE(FileSegment::open(file.path(), 11));
+}
+
+TEST_CASE("Buffer reads the contents of a file segment", "[file_segment][buffer]") {
+    std::string contents(100 * 1024, 'f');
+    contents += "end";
+    TempFile file(contents);
+
+    auto b = Buffer();
+    b.add("head:");
+    REQUIRE(b.add_file(file.path()));
+    CHECK(b.length() == contents.size() + 5);
+    CHECK(b.str() == "head:" + contents);
+
+    auto part = Buffer();
+    REQUIRE(part.add_file(file.path(), static_cast<int64_t>(contents.size()) - 3));
+    CHECK(part.str() == "end");
+}
+
+TEST_CASE("A file segment can be added to many buffers and outlive its handle", "[file_segment][buffer]") {
+    TempFile file("shared file contents");
+    std::vector<Buffer> buffers(5);
+    {
+        auto segment = FileSegment::open(file.path());
+        REQUIRE(segment);
+        for (auto &b : buffers) {
+            REQUIRE(b.add_file(segment, 7, 4));
+        }
+    }
+    for (auto &b : buffers) {
+        CHECK(b.str() == "file");
+    }
+}
+
+// ---
+// File Segment Cache
+// ---
+
+TEST_CASE("Reactor has a file segment cache by default", "[file_segment][cache]") {
+    auto r = pembroke::reactor().build();
+    REQUIRE(r->file_segments() != nullptr);
+    CHECK(r->file_segments()->capacity() == 64);
+
+    auto disabled = pembroke::reactor().file_segment_cache(0).build();
+    CHECK(disabled->file_segments() == nullptr);
+}
+
+TEST_CASE("FileSegmentCache reuses segments of unchanged files", "[file_segment][cache]") {
+    TempFile file("cached");
+    FileSegmentCache cache(4);
+
+    const auto *first = cache.get(file.path());
+    REQUIRE(first != nullptr);
+    auto *underlying = first->underlying();
+    const auto *second = cache.get(file.path());
+    REQUIRE(second != nullptr);
+    CHECK(second->underlying() == underlying);
+    CHECK(cache.size() == 1);
+
+    auto b = Buffer();
+    REQUIRE(b.add_file(*second));
+    CHECK(b.str() == "cached");
+}
+
+TEST_CASE("FileSegmentCache re-opens modified and replaced files", "[file_segment][cache]") {
+    TempFile file("before");
+    FileSegmentCache cache(4);
+    REQUIRE(cache.get(file.path()) != nullptr);
+
+    SECTION("modified in place") {
+        file.write("after, and longer");
+    }
+    SECTION("replaced") {
+        TempFile replacement("after!");
+        REQUIRE(std::rename(replacement.path().c_str(), file.path().c_str()) == 0);
+    }
+
+    const auto *segment = cache.get(file.path());
+    REQUIRE(segment != nullptr);
+    auto b = Buffer();
+    REQUIRE(b.add_file(*segment));
+    CHECK(b.str().rfind("after", 0) == 0);
+    CHECK(cache.size() == 1);
+}
+
+TEST_CASE("FileSegmentCache evicts the least recently used file", "[file_segment][cache]") {
+    TempFile a("a"), b("b"), c("c");
+    FileSegmentCache cache(2);
+
+    REQUIRE(cache.get(a.path()) != nullptr);
+    REQUIRE(cache.get(b.path()) != nullptr);
+    auto *a_segment = cache.get(a.path())->underlying();  // a is now most recent
+    REQUIRE(cache.get(c.path()) != nullptr);              // evicts b
+    CHECK(cache.size() == 2);
+    CHECK(cache.get(a.path())->underlying() == a_segment);
+
+    cache.evict(a.path());
+    CHECK(cache.size() == 1);
+    cache.clear();
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("FileSegmentCache does not cache missing files", "[file_segment][cache]") {
+    FileSegmentCache cache(2);
+    CHECK(cache.get("/nonexistent/pembroke-file") == nullptr);
+    CHECK(cache.size() == 0);
+}
@@ -0,0 +1,151 @@
+#include "pembroke/instrumentation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pembroke {
+
+    // ---
+    // HISTOGRAM
+    // ---
+
+    /* Single-writer increment: a plain load/store pair avoids the locked read-modify-write
+     * of fetch_add while still being safe to read concurrently */
+    static inline void bump(std::atomic<uint64_t> &a, uint64_t by) noexcept {
+        a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    auto Histogram::bucket_of(uint64_t value) noexcept -> size_t {
+        value = std::min(value, MaxValue);
+        if (value < SubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        /* Above the linear range each power of two is split into HalfSubBuckets buckets:
+         * keep the top SubBucketBits bits of the value and drop the rest */
+        auto msb = static_cast<unsigned>(63 - __builtin_clzll(value));
+        unsigned shift = msb - SubBucketBits + 1;
+        auto mantissa = static_cast<size_t>(value >> shift);
+        return SubBuckets + (shift - 1) * HalfSubBuckets + (mantissa - HalfSubBuckets);
+    }
+
+    auto Histogram::bucket_max(size_t index) noexcept -> uint64_t {
+        if (index < SubBuckets) {
+            return index;
+        }
+        size_t k = index - SubBuckets;
+        auto shift = static_cast<unsigned>(k / HalfSubBuckets + 1);
+        uint64_t mantissa = HalfSubBuckets + k % HalfSubBuckets;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    void Histogram::record(std::chrono::nanoseconds value) noexcept {
+        auto v = static_cast<uint64_t>(std::max<int64_t>(0, value.count()));
+        bump(m_counts[bucket_of(v)], 1);
+        bump(m_count, 1);
+        bump(m_sum, v);
+        if (v < m_min.load(std::memory_order_relaxed)) {
+            m_min.store(v, std::memory_order_relaxed);
+        }
+        if (v > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(v, std::memory_order_relaxed);
+        }
+    }
+
+    auto Histogram::snapshot() const -> HistogramSnapshot {
+        HistogramSnapshot snap;
+        snap.m_counts.resize(BucketCount);
+        uint64_t total = 0;
+        for (size_t i = 0; i < BucketCount; i++) {
+            snap.m_counts[i] = m_counts[i].load(std::memory_order_relaxed);
+            total += snap.m_counts[i];
+        }
+        /* Buckets are copied one at a time while the reactor keeps recording, so derive the
+         * count from the buckets themselves to keep percentiles self-consistent */
+        snap.m_count = total;
+        snap.m_sum = m_sum.load(std::memory_order_relaxed);
+        snap.m_max = m_max.load(std::memory_order_relaxed);
+        auto min = m_min.load(std::memory_order_relaxed);
+        snap.m_min = (total == 0 || min == UINT64_MAX) ? 0 : min;
+        return snap;
+    }
+
+    auto HistogramSnapshot::count() const noexcept -> uint64_t {
+        return m_count;
+    }
+
+    auto HistogramSnapshot::min() const noexcept -> std::chrono::nanoseconds {
+        return std::chrono::nanoseconds(m_min);
+    }
+
+    auto HistogramSnapshot::max() const noexcept -> std::chrono::nanoseconds {
+        return std::chrono::nanoseconds(m_max);
+    }
+
+    auto HistogramSnapshot::mean() const noexcept -> std::chrono::nanoseconds {
+        if (m_count == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        return std::chrono::nanoseconds(m_sum / m_count);
+    }
+
+    auto HistogramSnapshot::percentile(double p) const noexcept -> std::chrono::nanoseconds {
+        if (m_count == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        p = std::clamp(p, 0.0, 100.0);
+        auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(m_count))));
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < m_counts.size(); i++) {
+            seen += m_counts[i];
+            if (seen >= rank) {
+                auto v = std::clamp(Histogram::bucket_max(i), m_min, m_max);
+                return std::chrono::nanoseconds(v);
+            }
+        }
+        return std::chrono::nanoseconds(m_max);
+    }
+
+    // ---
+    // INSTRUMENTATION
+    // ---
+
+    auto Instrumentation::Snapshot::callbacks_of(CallbackKind kind) const noexcept -> const HistogramSnapshot & {
+        return callbacks[static_cast<size_t>(kind)];
+    }
+
+    auto Instrumentation::snapshot() const -> Snapshot {
+        Snapshot snap;
+        snap.ticks = m_ticks.snapshot();
+        for (size_t i = 0; i < CallbackKinds; i++) {
+            snap.callbacks[i] = m_callbacks[i].snapshot();
+        }
+        snap.timer_lateness = m_timer_lateness.snapshot();
+        return snap;
+    }
+
+    auto Instrumentation::callback_started() noexcept -> clock::time_point {
+        auto now = clock::now();
+        if (!m_in_tick) {
+            m_in_tick = true;
+            m_tick_start = now;
+        }
+        return now;
+    }
+
+    void Instrumentation::callback_finished(CallbackKind kind, clock::time_point start) noexcept {
+        m_callbacks[static_cast<size_t>(kind)].record(clock::now() - start);
+    }
+
+    void Instrumentation::timer_fired(std::chrono::nanoseconds lateness) noexcept {
+        m_timer_lateness.record(lateness);
+    }
+
+    void Instrumentation::tick_finished() noexcept {
+        if (m_in_tick) {
+            m_ticks.record(clock::now() - m_tick_start);
+            m_in_tick = false;
+        }
+    }
+
+} // namespace pembroke
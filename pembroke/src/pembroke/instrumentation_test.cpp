@@ -0,0 +1,149 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "pembroke/instrumentation.hpp"
+#include "pembroke/reactor.hpp"
+#include "pembroke/event/delayed.hpp"
+#include "pembroke/event/timer.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke;
+using namespace pembroke::event;
+
+// ---
+// Histogram
+// ---
+
+TEST_CASE("Histogram buckets are contiguous and bounded", "[instrumentation][histogram]") {
+    for (uint64_t v = 0; v < 1000000; v += 7) {
+        auto i = Histogram::bucket_of(v);
+        REQUIRE(Histogram::bucket_max(i) >= v);
+        if (i > 0) {
+            REQUIRE(Histogram::bucket_max(i - 1) < v);
+        }
+    }
+    CHECK(Histogram::bucket_of(Histogram::MaxValue) == Histogram::BucketCount - 1);
+    CHECK(Histogram::bucket_of(UINT64_MAX) == Histogram::BucketCount - 1);
+}
+
+TEST_CASE("Histogram reports percentiles within its precision", "[instrumentation][histogram]") {
+    Histogram h;
+    for (int64_t v = 1; v <= 10000; v++) {
+        h.record(std::chrono::nanoseconds(v));
+    }
+    auto snap = h.snapshot();
+
+    CHECK(snap.count() == 10000);
+    CHECK(snap.min() == 1ns);
+    CHECK(snap.max() == 10000ns);
+    CHECK(snap.mean() == 5000ns);
+    CHECK(snap.percentile(50).count() == Approx(5000).epsilon(0.04));
+    CHECK(snap.percentile(99).count() == Approx(9900).epsilon(0.04));
+    CHECK(snap.percentile(100) == 10000ns);
+}
+
+TEST_CASE("Empty histogram snapshot", "[instrumentation][histogram]") {
+    Histogram h;
+    auto snap = h.snapshot();
+    CHECK(snap.count() == 0);
+    CHECK(snap.min() == 0ns);
+    CHECK(snap.max() == 0ns);
+    CHECK(snap.percentile(50) == 0ns);
+}
+
+// ---
+// Reactor Instrumentation
+// ---
+
+TEST_CASE("Reactors are not instrumented by default", "[instrumentation][reactor]") {
+    CHECK(reactor().build()->instrumentation() == nullptr);
+    CHECK(reactor().instrument().build()->instrumentation() != nullptr);
+}
+
+TEST_CASE("Instrumented reactor times callbacks by kind", "[instrumentation][reactor]") {
+    auto r = reactor().instrument().build();
+    int timer_runs = 0;
+
+    auto delayed = DelayedEvent(1ms, [&]() -> void { std::this_thread::sleep_for(2ms); });
+    auto timer = TimerEvent(1ms, [&]() -> void {
+        if (++timer_runs == 3) {
+            CHECK(r->stop());
+        }
+    });
+    CHECK(r->register_event(delayed));
+    CHECK(r->register_event(timer));
+    CHECK(r->post([]() -> void {}));
+    CHECK(r->run_blocking());
+
+    auto snap = r->instrumentation()->snapshot();
+    CHECK(snap.callbacks_of(CallbackKind::Delayed).count() == 1);
+    CHECK(snap.callbacks_of(CallbackKind::Delayed).max() >= 2ms);
+    CHECK(snap.callbacks_of(CallbackKind::Timer).count() == 3);
+    CHECK(snap.callbacks_of(CallbackKind::Task).count() == 1);
+    CHECK(snap.timer_lateness.count() == 4);
+    CHECK(snap.ticks.count() >= 1);
+    CHECK(snap.ticks.max() >= 2ms);
+}
+
+TEST_CASE("Instrumented reactor does not lose a stop between ticks", "[instrumentation][reactor]") {
+    auto r = reactor().instrument().build();
+
+    /* Requested before the loop runs, as a stop from another thread may land between two
+     * ticks of run_blocking() */
+    CHECK(r->stop());
+    CHECK(r->run_blocking());
+
+    /* ... and honoured once only */
+    int runs = 0;
+    auto done = DelayedEvent(1ms, [&]() -> void {
+        runs++;
+        CHECK(r->stop());
+    });
+    CHECK(r->register_event(done));
+    CHECK(r->run_blocking());
+    CHECK(runs == 1);
+}
+
+TEST_CASE("Instrumented reactor records ticks of tick()", "[instrumentation][reactor]") {
+    auto r = reactor().instrument().build();
+    auto event = DelayedEvent(0s, []() -> void { std::this_thread::sleep_for(1ms); });
+    CHECK(r->register_event(event));
+
+    CHECK(r->tick());
+    CHECK(r->tick());  // nothing ran, no tick recorded
+
+    auto snap = r->instrumentation()->snapshot();
+    CHECK(snap.ticks.count() == 1);
+    CHECK(snap.ticks.min() >= 1ms);
+}
+
+TEST_CASE("Instrumentation snapshot from another thread", "[instrumentation][reactor]") {
+    auto r = reactor().instrument().build();
+    auto *instrumentation = r->instrumentation();
+    std::atomic<bool> done{false};
+
+    auto timer = TimerEvent(0us, 100us, [&]() -> void {
+        if (done) {
+            CHECK(r->stop());
+        }
+    });
+    CHECK(r->register_event(timer));
+
+    bool monotonic = true;
+    std::thread reader([&]() -> void {
+        uint64_t last = 0;
+        for (int i = 0; i < 50; i++) {
+            auto count = instrumentation->snapshot().callbacks_of(CallbackKind::Timer).count();
+            monotonic = monotonic && count >= last;
+            last = count;
+            std::this_thread::sleep_for(100us);
+        }
+        done = true;
+    });
+    CHECK(r->run_blocking());
+    reader.join();
+    CHECK(monotonic);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "pembroke/buffer_pool.hpp"
+#include "pembroke/libevent/forward_decls.hpp"
+
+namespace pembroke::internal {
+
+    /**
+     * @brief
+     * The state of a BufferPool, shared with the Buffers it hands out. A pool may be
+     * destroyed while its buffers are still alive, in which case the shelf outlives it until
+     * the last of them is destroyed (and buffers returned to it are simply freed).
+     */
+    struct BufferShelf {
+        std::vector<evbuffer *> free;
+        size_t capacity;
+        /* Buffers handed out and not yet returned */
+        size_t outstanding = 0;
+        /* Set once the owning pool has been destroyed */
+        bool closed = false;
+        BufferPool::Stats stats{};
+
+        explicit BufferShelf(size_t capacity) : capacity(capacity) {
+            free.reserve(capacity);
+        }
+    };
+
+    /**
+     * @brief Hand an evbuffer back to the shelf it was taken from. The evbuffer is drained
+     *        and kept for reuse, or freed if the shelf is full or closed.
+     */
+    void return_to_shelf(BufferShelf *shelf, evbuffer *buffer) noexcept;
+
+}  // namespace pembroke::internal
@@ -0,0 +1,238 @@
+#include "pembroke/internal/byte_search.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PEMBROKE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace pembroke::internal {
+
+    ByteSet::ByteSet(std::string_view bytes) noexcept {
+        for (char c : bytes) {
+            auto byte = static_cast<uint8_t>(c);
+            if (m_table[byte]) {
+                continue;
+            }
+            m_table[byte] = true;
+            if (m_count < SimdBytes) {
+                m_bytes[m_count] = byte;
+            }
+            m_count++;
+        }
+    }
+
+    namespace kernels {
+
+        // ---
+        // Scalar
+        // ---
+
+        auto find_scalar(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t {
+            auto pos = std::string_view(reinterpret_cast<const char *>(data), len).find(pattern);
+            return pos == std::string_view::npos ? NotFound : pos;
+        }
+
+        auto find_any_scalar(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t {
+            if (set.size() == 1) {
+                const void *match = std::memchr(data, set.bytes()[0], len);
+                return match == nullptr ? NotFound : static_cast<size_t>(static_cast<const std::byte *>(match) - data);
+            }
+            for (size_t i = 0; i < len; i++) {
+                if (set.contains(static_cast<uint8_t>(data[i]))) {
+                    return i;
+                }
+            }
+            return NotFound;
+        }
+
+#ifdef PEMBROKE_X86_SIMD
+
+        auto has_sse2() noexcept -> bool {
+            static const bool supported = __builtin_cpu_supports("sse2");
+            return supported;
+        }
+
+        auto has_avx2() noexcept -> bool {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        /*
+         * Substring search (for patterns of at least 2 bytes) filters candidate positions a
+         * block at a time: a position can only match if both its first byte and the byte
+         * pattern.size() - 1 later match the pattern's first and last bytes. Only those
+         * candidates are compared in full. The remainder that does not fill a block is
+         * searched with the scalar kernel.
+         */
+
+        // ---
+        // SSE2
+        // ---
+
+        __attribute__((target("sse2")))
+        auto find_sse2(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t {
+            const size_t m = pattern.size();
+            if (m < 2 || len < m) {
+                return find_scalar(data, len, pattern);
+            }
+            const auto *p = reinterpret_cast<const char *>(data);
+            const __m128i first = _mm_set1_epi8(pattern[0]);
+            const __m128i last = _mm_set1_epi8(pattern[m - 1]);
+
+            size_t i = 0;
+            for (; i + m - 1 + 16 <= len; i += 16) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + m - 1));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+                while (mask != 0) {
+                    auto bit = static_cast<size_t>(__builtin_ctz(mask));
+                    if (std::memcmp(p + i + bit + 1, pattern.data() + 1, m - 2) == 0) {
+                        return i + bit;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+            auto pos = find_scalar(data + i, len - i, pattern);
+            return pos == NotFound ? NotFound : i + pos;
+        }
+
+        __attribute__((target("sse2")))
+        auto find_any_sse2(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t {
+            if (set.size() == 0 || set.size() > ByteSet::SimdBytes) {
+                return find_any_scalar(data, len, set);
+            }
+            const auto *p = reinterpret_cast<const char *>(data);
+            __m128i needles[ByteSet::SimdBytes];
+            for (size_t j = 0; j < set.size(); j++) {
+                needles[j] = _mm_set1_epi8(static_cast<char>(set.bytes()[j]));
+            }
+
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                __m128i eq = _mm_cmpeq_epi8(block, needles[0]);
+                for (size_t j = 1; j < set.size(); j++) {
+                    eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, needles[j]));
+                }
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+                if (mask != 0) {
+                    return i + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+            auto pos = find_any_scalar(data + i, len - i, set);
+            return pos == NotFound ? NotFound : i + pos;
+        }
+
+        // ---
+        // AVX2
+        // ---
+
+        __attribute__((target("avx2")))
+        auto find_avx2(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t {
+            const size_t m = pattern.size();
+            if (m < 2 || len < m) {
+                return find_scalar(data, len, pattern);
+            }
+            const auto *p = reinterpret_cast<const char *>(data);
+            const __m256i first = _mm256_set1_epi8(pattern[0]);
+            const __m256i last = _mm256_set1_epi8(pattern[m - 1]);
+
+            size_t i = 0;
+            for (; i + m - 1 + 32 <= len; i += 32) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i + m - 1));
+                auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                    _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+                while (mask != 0) {
+                    auto bit = static_cast<size_t>(__builtin_ctz(mask));
+                    if (std::memcmp(p + i + bit + 1, pattern.data() + 1, m - 2) == 0) {
+                        return i + bit;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+            auto pos = find_sse2(data + i, len - i, pattern);
+            return pos == NotFound ? NotFound : i + pos;
+        }
+
+        __attribute__((target("avx2")))
+        auto find_any_avx2(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t {
+            if (set.size() == 0 || set.size() > ByteSet::SimdBytes) {
+                return find_any_scalar(data, len, set);
+            }
+            const auto *p = reinterpret_cast<const char *>(data);
+            __m256i needles[ByteSet::SimdBytes];
+            for (size_t j = 0; j < set.size(); j++) {
+                needles[j] = _mm256_set1_epi8(static_cast<char>(set.bytes()[j]));
+            }
+
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                __m256i eq = _mm256_cmpeq_epi8(block, needles[0]);
+                for (size_t j = 1; j < set.size(); j++) {
+                    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(block, needles[j]));
+                }
+                auto mask = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+                if (mask != 0) {
+                    return i + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+            auto pos = find_any_sse2(data + i, len - i, set);
+            return pos == NotFound ? NotFound : i + pos;
+        }
+
+#else
+
+        auto has_sse2() noexcept -> bool { return false; }
+        auto has_avx2() noexcept -> bool { return false; }
+
+        auto find_sse2(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t {
+            return find_scalar(data, len, pattern);
+        }
+        auto find_avx2(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t {
+            return find_scalar(data, len, pattern);
+        }
+        auto find_any_sse2(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t {
+            return find_any_scalar(data, len, set);
+        }
+        auto find_any_avx2(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t {
+            return find_any_scalar(data, len, set);
+        }
+
+#endif
+
+    }  // namespace kernels
+
+    // ---
+    // Dispatch
+    // ---
+
+    auto find(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t {
+        if (kernels::has_avx2()) {
+            return kernels::find_avx2(data, len, pattern);
+        }
+        if (kernels::has_sse2()) {
+            return kernels::find_sse2(data, len, pattern);
+        }
+        return kernels::find_scalar(data, len, pattern);
+    }
+
+    auto find_any(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t {
+        // memchr is already vectorized for the single byte case
+        if (set.size() == 1) {
+            return kernels::find_any_scalar(data, len, set);
+        }
+        if (kernels::has_avx2()) {
+            return kernels::find_any_avx2(data, len, set);
+        }
+        if (kernels::has_sse2()) {
+            return kernels::find_any_sse2(data, len, set);
+        }
+        return kernels::find_any_scalar(data, len, set);
+    }
+
+}  // namespace pembroke::internal
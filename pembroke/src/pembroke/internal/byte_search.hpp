@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace pembroke::internal {
+
+    /* Returned by the search functions when there is no match */
+    constexpr size_t NotFound = SIZE_MAX;
+
+    /**
+     * @brief A set of bytes to search for with find_any(). Sets of up to SimdBytes bytes are
+     *        compared with SIMD kernels, larger sets fall back to a table lookup per byte.
+     */
+    class ByteSet {
+    public:
+        static constexpr size_t SimdBytes = 8;
+
+    private:
+        std::array<bool, 256> m_table{};
+        std::array<uint8_t, SimdBytes> m_bytes{};
+        size_t m_count = 0;
+
+    public:
+        explicit ByteSet(std::string_view bytes) noexcept;
+
+        [[nodiscard]]
+        auto contains(uint8_t byte) const noexcept -> bool {
+            return m_table[byte];
+        }
+
+        /** @brief Number of distinct bytes in the set */
+        [[nodiscard]]
+        auto size() const noexcept -> size_t {
+            return m_count;
+        }
+
+        /** @brief The bytes of the set, valid if size() <= SimdBytes */
+        [[nodiscard]]
+        auto bytes() const noexcept -> const std::array<uint8_t, SimdBytes> & {
+            return m_bytes;
+        }
+    };
+
+    /**
+     * @brief Offset of the first occurrence of @p pattern in the @p len bytes at @p data, or
+     *        NotFound. Uses the widest kernel supported by the CPU (AVX2, SSE2, scalar).
+     */
+    [[nodiscard]]
+    auto find(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t;
+
+    /** @brief Offset of the first byte in @p set in the @p len bytes at @p data, or NotFound */
+    [[nodiscard]]
+    auto find_any(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t;
+
+    /* The individual kernels, exposed for testing and benchmarks. The SIMD kernels must only
+     * be called if the CPU supports them (see has_sse2(), has_avx2()). */
+    namespace kernels {
+        [[nodiscard]] auto has_sse2() noexcept -> bool;
+        [[nodiscard]] auto has_avx2() noexcept -> bool;
+
+        [[nodiscard]] auto find_scalar(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t;
+        [[nodiscard]] auto find_sse2(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t;
+        [[nodiscard]] auto find_avx2(const std::byte *data, size_t len, std::string_view pattern) noexcept -> size_t;
+
+        [[nodiscard]] auto find_any_scalar(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t;
+        [[nodiscard]] auto find_any_sse2(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t;
+        [[nodiscard]] auto find_any_avx2(const std::byte *data, size_t len, const ByteSet &set) noexcept -> size_t;
+    }
+
+}  // namespace pembroke::internal
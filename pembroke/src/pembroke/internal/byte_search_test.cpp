@@ -0,0 +1,92 @@
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "pembroke/internal/byte_search.hpp"
+
+using namespace pembroke::internal;
+
+static auto as_bytes(const std::string &s) -> const std::byte * {
+    return reinterpret_cast<const std::byte *>(s.data());
+}
+
+/* Random text over a small alphabet, so that partial matches are common */
+static auto random_text(size_t len, std::mt19937 &rng) -> std::string {
+    std::uniform_int_distribution<int> dist(0, 3);
+    std::string text(len, 'a');
+    for (auto &c : text) {
+        c = static_cast<char>('a' + dist(rng));
+    }
+    return text;
+}
+
+// ---
+// ByteSet
+// ---
+
+TEST_CASE("ByteSet holds distinct bytes", "[byte_search]") {
+    ByteSet set("\r\n\r");
+    CHECK(set.size() == 2);
+    CHECK(set.contains('\r'));
+    CHECK(set.contains('\n'));
+    CHECK_FALSE(set.contains('a'));
+}
+
+// ---
+// Kernels
+// ---
+
+TEST_CASE("find kernels agree with the scalar search", "[byte_search]") {
+    std::mt19937 rng(42);
+    std::vector<std::string> patterns = {"a", "ab", "abc", "dcba", "abcdabcdab", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+        auto text = random_text(len, rng);
+        for (const auto &pattern : patterns) {
+            for (size_t start = 0; start < std::min<size_t>(len, 40); start++) {
+                auto expected = kernels::find_scalar(as_bytes(text) + start, len - start, pattern);
+                if (kernels::has_sse2()) {
+                    CHECK(kernels::find_sse2(as_bytes(text) + start, len - start, pattern) == expected);
+                }
+                if (kernels::has_avx2()) {
+                    CHECK(kernels::find_avx2(as_bytes(text) + start, len - start, pattern) == expected);
+                }
+                CHECK(find(as_bytes(text) + start, len - start, pattern) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("find kernels report a missing pattern", "[byte_search]") {
+    std::string text(1000, 'a');
+    CHECK(find(as_bytes(text), text.size(), "ab") == NotFound);
+    CHECK(find(as_bytes(text), text.size(), "b") == NotFound);
+    text.back() = 'b';
+    CHECK(find(as_bytes(text), text.size(), "ab") == 998);
+}
+
+TEST_CASE("find_any kernels agree with the scalar search", "[byte_search]") {
+    std::mt19937 rng(7);
+    std::vector<std::string> sets = {"d", "cd", "\r\n", "xyzd", "qrstuvwd", "abcdefghijklmnop"};
+
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+        std::string text(len, 'a');
+        for (size_t i = 0; i < len; i++) {
+            // mostly 'a', occasionally one of the searched-for bytes
+            text[i] = (rng() % 50 == 0) ? "dcxq\r\n"[rng() % 6] : 'a';
+        }
+        for (const auto &bytes : sets) {
+            ByteSet set(bytes);
+            auto expected = kernels::find_any_scalar(as_bytes(text), len, set);
+            if (kernels::has_sse2()) {
+                CHECK(kernels::find_any_sse2(as_bytes(text), len, set) == expected);
+            }
+            if (kernels::has_avx2()) {
+                CHECK(kernels::find_any_avx2(as_bytes(text), len, set) == expected);
+            }
+            CHECK(find_any(as_bytes(text), len, set) == expected);
+        }
+    }
+}
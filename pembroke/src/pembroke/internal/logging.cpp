@@ -1,16 +1,18 @@
 #include "pembroke/logging.hpp"
 #include "pembroke/internal/logging.hpp"
 
+#include <utility>
+
 namespace pembroke::logger {
 
     /**
      * @brief Global log handler (default initialized to a no_op handler)
      */
-    static std::function<void(Level, std::string_view)> _log_handler = 
+    static Handler _log_handler =
         [](Level /*unused*/, std::string_view /*unused*/) -> void {};
 
-    void register_handler(const std::function<void(Level, std::string_view)> &f) {
-        _log_handler = f;
+    void register_handler(Handler f) {
+        _log_handler = std::move(f);
     }
 
     void trace(const std::string_view msg) {
@@ -0,0 +1,81 @@
+#include "pembroke/internal/task_queue.hpp"
+
+#include <cstdint>
+
+namespace pembroke::internal {
+
+    static auto next_power_of_two(size_t n) noexcept -> size_t {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1U;
+        }
+        return p;
+    }
+
+    TaskQueue::TaskQueue(size_t capacity)
+        : m_cells(std::make_unique<Cell[]>(next_power_of_two(capacity == 0 ? 1 : capacity))),
+          m_mask(next_power_of_two(capacity == 0 ? 1 : capacity) - 1) {
+        for (size_t i = 0; i <= m_mask; i++) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    auto TaskQueue::capacity() const noexcept -> size_t {
+        return m_mask + 1;
+    }
+
+    auto TaskQueue::push(Callback &&task) noexcept -> bool {
+        Cell *cell = nullptr;
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // the consumer has not yet freed this cell: the queue is full
+                return false;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->task = std::move(task);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    auto TaskQueue::drain(size_t max, Instrumentation *instrumentation) noexcept -> size_t {
+        size_t ran = 0;
+        while (ran < max) {
+            Cell *cell = &m_cells[m_dequeue_pos & m_mask];
+            if (cell->seq.load(std::memory_order_acquire) != m_dequeue_pos + 1) {
+                break;
+            }
+
+            /* Run the task in place, there is no need to move it out of the cell as
+             * producers cannot touch it until its sequence number is bumped. */
+            if (instrumentation == nullptr) {
+                cell->task();
+            } else {
+                auto start = instrumentation->callback_started();
+                cell->task();
+                instrumentation->callback_finished(CallbackKind::Task, start);
+            }
+            cell->task.reset();
+            cell->seq.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+            m_dequeue_pos++;
+            ran++;
+        }
+        return ran;
+    }
+
+    auto TaskQueue::ready() const noexcept -> bool {
+        const Cell *cell = &m_cells[m_dequeue_pos & m_mask];
+        return cell->seq.load(std::memory_order_acquire) == m_dequeue_pos + 1;
+    }
+
+} // namespace pembroke::internal
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "pembroke/callback.hpp"
+#include "pembroke/instrumentation.hpp"
+
+namespace pembroke::internal {
+
+    /* Assumed cache-line size, used to keep producer and consumer state apart */
+    constexpr size_t CacheLineSize = 64;
+
+    /**
+     * @brief
+     * Bounded, lock-free, multi-producer/single-consumer queue of Callbacks.
+     *
+     * Based on Dmitry Vyukov's bounded queue: every cell carries a sequence number that
+     * tells producers whether the cell is free and the consumer whether it is filled, so
+     * a push is a single CAS on the enqueue position and neither side ever allocates.
+     *
+     * @note Only one thread may call pop()/drain() at a time.
+     */
+    class TaskQueue {
+        struct Cell {
+            std::atomic<size_t> seq;
+            Callback task;
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        size_t m_mask;
+
+        alignas(CacheLineSize) std::atomic<size_t> m_enqueue_pos{0};
+        alignas(CacheLineSize) size_t m_dequeue_pos{0};
+
+    public:
+        /**
+         * @brief Construct a queue able to hold at least @p capacity tasks. The capacity
+         *        is rounded up to the next power of two.
+         */
+        explicit TaskQueue(size_t capacity);
+
+        TaskQueue(const TaskQueue &) = delete;
+        TaskQueue(TaskQueue &&) = delete;
+        auto operator=(const TaskQueue &) -> TaskQueue & = delete;
+        auto operator=(TaskQueue &&) -> TaskQueue & = delete;
+        ~TaskQueue() = default;
+
+        /** @brief Number of tasks the queue can hold */
+        [[nodiscard]]
+        auto capacity() const noexcept -> size_t;
+
+        /**
+         * @brief Push a task onto the queue. Safe to call from any thread.
+         * @returns False if the queue is full, in which case @p task is left untouched.
+         */
+        [[nodiscard]]
+        auto push(Callback &&task) noexcept -> bool;
+
+        /**
+         * @brief Run up to @p max queued tasks (in FIFO order) on the calling thread, timing
+         *        each one with @p instrumentation if given.
+         * @returns The number of tasks that were run
+         */
+        auto drain(size_t max, Instrumentation *instrumentation = nullptr) noexcept -> size_t;
+
+        /** @brief True if there is at least one task ready to be drained */
+        [[nodiscard]]
+        auto ready() const noexcept -> bool;
+    };
+
+} // namespace pembroke::internal
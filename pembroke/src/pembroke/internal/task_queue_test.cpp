@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pembroke/internal/task_queue.hpp"
+
+using namespace pembroke::internal;
+
+// ---
+// TaskQueue
+// ---
+
+TEST_CASE("task queue rounds capacity up to a power of two", "[task_queue]") {
+    CHECK(TaskQueue(1).capacity() == 1);
+    CHECK(TaskQueue(3).capacity() == 4);
+    CHECK(TaskQueue(1024).capacity() == 1024);
+}
+
+TEST_CASE("task queue runs tasks in FIFO order", "[task_queue]") {
+    TaskQueue q(8);
+    std::vector<int> order;
+
+    for (int i = 0; i < 5; i++) {
+        CHECK(q.push(pembroke::Callback([&order, i]() -> void { order.push_back(i); })));
+    }
+    CHECK(q.ready());
+    CHECK(q.drain(100) == 5);
+    CHECK_FALSE(q.ready());
+    CHECK(order == std::vector<int>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("task queue rejects pushes when full", "[task_queue]") {
+    TaskQueue q(4);
+    int x = 0;
+    for (int i = 0; i < 4; i++) {
+        CHECK(q.push(pembroke::Callback([&x]() -> void { x += 1; })));
+    }
+    CHECK_FALSE(q.push(pembroke::Callback([&x]() -> void { x += 1; })));
+
+    CHECK(q.drain(1) == 1);
+    CHECK(q.push(pembroke::Callback([&x]() -> void { x += 1; })));
+    CHECK(q.drain(100) == 4);
+    CHECK(x == 5);
+}
+
+TEST_CASE("task queue drains from multiple producers", "[task_queue]") {
+    constexpr int Producers = 4;
+    constexpr int PerProducer = 10000;
+
+    TaskQueue q(256);
+    std::atomic<bool> done{false};
+    int total = 0;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < Producers; p++) {
+        producers.emplace_back([&]() -> void {
+            for (int i = 0; i < PerProducer; i++) {
+                while (!q.push(pembroke::Callback([&total]() -> void { total += 1; }))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::thread consumer([&]() -> void {
+        while (!done.load() || q.ready()) {
+            q.drain(q.capacity());
+        }
+    });
+
+    for (auto &t : producers) {
+        t.join();
+    }
+    done = true;
+    consumer.join();
+
+    CHECK(total == Producers * PerProducer);
+}
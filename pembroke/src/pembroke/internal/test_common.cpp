@@ -1,9 +1,20 @@
 #include "pembroke/internal/test_common.hpp"
 
 #include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
 #include <random>
 #include <vector>
 
+extern "C" {
+#include <event2/event.h>
+#include <event2/event_struct.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
 namespace pembroke {
 
     auto test_stream_logger() noexcept -> std::tuple<
@@ -48,4 +59,111 @@ namespace pembroke {
         }
     }
 
-}  // namespace pembroke
\ No newline at end of file
+    // ---
+    // Libevent Allocation Counting
+    // ---
+
+    static std::atomic<size_t> libevent_allocations{0};
+
+    static auto counting_malloc(size_t sz) -> void * {
+        libevent_allocations.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(sz);
+    }
+
+    static auto counting_realloc(void *ptr, size_t sz) -> void * {
+        libevent_allocations.fetch_add(1, std::memory_order_relaxed);
+        return std::realloc(ptr, sz);
+    }
+
+    static void counting_free(void *ptr) {
+        std::free(ptr);
+    }
+
+    /* Memory allocated before or after the counter is alive is still allocated with
+     * the system malloc, so swapping these functions in and out is safe. */
+    LibeventAllocationCounter::LibeventAllocationCounter() noexcept {
+        libevent_allocations = 0;
+        event_set_mem_functions(counting_malloc, counting_realloc, counting_free);
+    }
+
+    LibeventAllocationCounter::~LibeventAllocationCounter() noexcept {
+        event_set_mem_functions(nullptr, nullptr, nullptr);
+    }
+
+    auto LibeventAllocationCounter::count() const noexcept -> size_t {
+        return libevent_allocations.load(std::memory_order_relaxed);
+    }
+
+    TempFile::TempFile(std::string_view contents) {
+        std::string path = "/tmp/pembroke-test-XXXXXX";
+        int fd = mkstemp(path.data());
+        REQUIRE(fd != -1);
+        close(fd);
+        m_path = path;
+        write(contents);
+    }
+
+    TempFile::~TempFile() noexcept {
+        unlink(m_path.c_str());
+    }
+
+    void TempFile::write(std::string_view contents) {
+        FILE *f = fopen(m_path.c_str(), "w");
+        REQUIRE(f != nullptr);
+        REQUIRE(fwrite(contents.data(), 1, contents.size(), f) == contents.size());
+        fclose(f);
+    }
+
+    auto on_common_timeout(Reactor &r, const void *arg, const timeval *common) -> bool {
+        /* Captures the reactor's event_base */
+        class BaseCapture final : public Event {
+        public:
+            event_base *base = nullptr;
+
+            auto register_event(event_base &b) noexcept -> bool override {
+                base = &b;
+                return true;
+            }
+        };
+        BaseCapture capture;
+        REQUIRE(r.register_event(capture));
+
+        struct Search {
+            const void *arg;
+            const event *found = nullptr;
+        } search{arg};
+        event_base_foreach_event(capture.base, [](const event_base *, const event *ev, void *s) -> int {
+            auto *search = static_cast<Search *>(s);
+            if (event_get_callback_arg(ev) == search->arg) {
+                search->found = ev;
+                return 1;
+            }
+            return 0;
+        }, &search);
+
+        /* libevent keeps a common timeout's index in the bits of tv_usec above the
+         * microseconds, in the handle and in the expiry of every event added with it */
+        constexpr long MicrosecondsMask = 0x000fffff;
+        return common != nullptr && search.found != nullptr
+            && evtimer_pending(const_cast<event *>(search.found), nullptr) != 0
+            && (search.found->ev_timeout.tv_usec & ~MicrosecondsMask) == (common->tv_usec & ~MicrosecondsMask);
+    }
+
+    SocketPair::SocketPair() {
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, m_fds) == 0);
+    }
+
+    SocketPair::~SocketPair() noexcept {
+        for (int fd : m_fds) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+    }
+
+    void SocketPair::close_left() noexcept {
+        close(m_fds[0]);
+        m_fds[0] = -1;
+    }
+
+}  // namespace pembroke
@@ -5,9 +5,11 @@
  * be useful, it is an internal header that is not subject to any sort of semantic
  * versioning or breaking-change expectations you might have. Use at your own risk.
  */
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <sstream>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <unordered_map>
@@ -15,6 +17,7 @@
 #include <catch2/catch.hpp>
 
 #include "pembroke/logging.hpp"
+#include "pembroke/reactor.hpp"
 
 namespace pembroke {
 
@@ -26,4 +29,97 @@ namespace pembroke {
 
     void trample_stack() noexcept;
 
+    /** @brief Tick @p r until @p done returns true, failing the test if it takes over 5 seconds */
+    template<typename F>
+    void tick_until(Reactor &r, F done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!done()) {
+            REQUIRE(std::chrono::steady_clock::now() < deadline);
+            REQUIRE(r.tick());
+        }
+    }
+
+    /**
+     * @brief True if the pending libevent timer on @p r whose callback argument is @p arg (the
+     *        pembroke event that owns it) was added with the common timeout @p common, rather
+     *        than on libevent's timer heap.
+     */
+    [[nodiscard]]
+    auto on_common_timeout(Reactor &r, const void *arg, const timeval *common) -> bool;
+
+    /**
+     * @brief RAII helper that counts libevent's heap allocations (malloc/realloc) for as
+     *        long as it is alive, by installing counting memory functions into libevent.
+     * @note Counting is process-wide, only one counter should be alive at a time.
+     */
+    class LibeventAllocationCounter {
+    public:
+        LibeventAllocationCounter() noexcept;
+        ~LibeventAllocationCounter() noexcept;
+
+        LibeventAllocationCounter(const LibeventAllocationCounter &) = delete;
+        LibeventAllocationCounter(LibeventAllocationCounter &&) = delete;
+        auto operator=(const LibeventAllocationCounter &) -> LibeventAllocationCounter & = delete;
+        auto operator=(LibeventAllocationCounter &&) -> LibeventAllocationCounter & = delete;
+
+        /** @brief Number of allocations made by libevent since construction */
+        [[nodiscard]]
+        auto count() const noexcept -> size_t;
+    };
+
+    /**
+     * @brief RAII helper for a file with the given contents in the system's temporary
+     *        directory, removed on destruction.
+     */
+    class TempFile {
+        std::string m_path;
+
+    public:
+        explicit TempFile(std::string_view contents);
+        ~TempFile() noexcept;
+
+        TempFile(const TempFile &) = delete;
+        TempFile(TempFile &&) = delete;
+        auto operator=(const TempFile &) -> TempFile & = delete;
+        auto operator=(TempFile &&) -> TempFile & = delete;
+
+        /** @brief Replace the contents of the file (in place, keeping its inode) */
+        void write(std::string_view contents);
+
+        [[nodiscard]]
+        auto path() const noexcept -> const std::string & {
+            return m_path;
+        }
+    };
+
+    /**
+     * @brief RAII helper for a connected pair of non-blocking unix stream sockets, closed
+     *        on destruction.
+     */
+    class SocketPair {
+        int m_fds[2] = {-1, -1};
+
+    public:
+        SocketPair();
+        ~SocketPair() noexcept;
+
+        SocketPair(const SocketPair &) = delete;
+        SocketPair(SocketPair &&) = delete;
+        auto operator=(const SocketPair &) -> SocketPair & = delete;
+        auto operator=(SocketPair &&) -> SocketPair & = delete;
+
+        [[nodiscard]]
+        auto left() const noexcept -> int {
+            return m_fds[0];
+        }
+
+        [[nodiscard]]
+        auto right() const noexcept -> int {
+            return m_fds[1];
+        }
+
+        /** @brief Close one end, the other end then reads end of file */
+        void close_left() noexcept;
+    };
+
 } // namespace pembroke
\ No newline at end of file
@@ -1,5 +1,13 @@
 #include "pembroke/internal/util.hpp"
 
+#include <string_view>
+
+extern "C" {
+#include <event2/event.h>
+#include <event2/util.h>
+#include <netinet/in.h>
+}
+
 namespace pembroke::internal {
 
     template<>
@@ -10,4 +18,52 @@ namespace pembroke::internal {
         };
     }
 
-} // namespace pembroke::internal
\ No newline at end of file
+    auto priority_queue(event_base *base, int priority) noexcept -> int {
+        int queues = event_base_get_npriorities(base);
+        if (queues <= 1) {
+            return priority <= 0 ? 0 : -1;
+        }
+        int priorities = queues - 1;
+        if (priority < 0) {
+            priority = priorities / 2;
+        }
+        if (priority >= priorities) {
+            return -1;
+        }
+        return priority < TickFastQueue ? priority : priority + 1;
+    }
+
+    auto set_priority(::event *ev, int priority) noexcept -> bool {
+        int queue = priority_queue(event_get_base(ev), priority);
+        if (queue < 0) {
+            return false;
+        }
+        return event_priority_set(ev, queue) == 0;
+    }
+
+    auto parse_address(const std::string &address, sockaddr_storage &addr, socklen_t &len) noexcept -> bool {
+        /* evutil_parse_sockaddr_port() rejects an explicit port 0, but leaves the port 0 when
+         * it is omitted, so "host:0" is parsed as just "host" */
+        std::string_view host = address;
+        if (host.size() > 2 && host.substr(host.size() - 2) == ":0") {
+            host.remove_suffix(2);
+        }
+        int parsed_len = sizeof(addr);
+        if (evutil_parse_sockaddr_port(std::string(host).c_str(), reinterpret_cast<sockaddr *>(&addr), &parsed_len) != 0) {
+            return false;
+        }
+        len = static_cast<socklen_t>(parsed_len);
+        return true;
+    }
+
+    auto port_of(const sockaddr_storage &addr) noexcept -> uint16_t {
+        if (addr.ss_family == AF_INET) {
+            return ntohs(reinterpret_cast<const sockaddr_in *>(&addr)->sin_port);
+        }
+        if (addr.ss_family == AF_INET6) {
+            return ntohs(reinterpret_cast<const sockaddr_in6 *>(&addr)->sin6_port);
+        }
+        return 0;
+    }
+
+} // namespace pembroke::internal
@@ -2,13 +2,16 @@
 
 #include <cstdlib>
 #include <chrono>
+#include <string>
 #include <fmt/format.h>
 
 extern "C" {
+#include <sys/socket.h>
 #include <sys/time.h>
 }
 
 #include "pembroke/internal/logging.hpp"
+#include "pembroke/libevent/forward_decls.hpp"
 
 /*
  * This file defines some common utilities that are useful to pembroke
@@ -39,6 +42,36 @@ namespace pembroke::internal {
     template<>
     auto to_timeval(const std::chrono::duration<long, std::micro> &cd) -> timeval;
 
+    /* Reactors with more than one priority give libevent an extra queue, just below the top
+     * priority, that only holds the event ending a Reactor::tick_fast(). Reactor priority
+     * 0 is libevent's queue 0 and reactor priority p > 0 is queue p + 1. */
+    constexpr int TickFastQueue = 1;
+
+    /**
+     * @brief The libevent queue of (reactor) @p priority on @p base. A negative priority
+     *        selects the middle priority.
+     * @returns -1 if the priority is out of range for @p base
+     */
+    auto priority_queue(event_base *base, int priority) noexcept -> int;
+
+    /**
+     * @brief Set the (reactor) priority of a non-active libevent event, mapping it to the
+     *        libevent queue. A negative priority selects the middle priority.
+     * @returns False if the priority is out of range for the event's base
+     */
+    auto set_priority(::event *ev, int priority) noexcept -> bool;
+
+    /**
+     * @brief Parse a socket address (`"host:port"`, `"[ipv6]:port"`), much like
+     *        `evutil_parse_sockaddr_port()` but also accepting port 0 (any free port).
+     * @param len The length of the parsed address
+     * @returns False if @p address cannot be parsed
+     */
+    auto parse_address(const std::string &address, sockaddr_storage &addr, socklen_t &len) noexcept -> bool;
+
+    /** @brief The port of an IPv4 or IPv6 address, or 0 for any other family */
+    auto port_of(const sockaddr_storage &addr) noexcept -> uint16_t;
+
 }  // namespace pembroke::internal
 
 
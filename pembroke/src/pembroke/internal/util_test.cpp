@@ -59,4 +59,20 @@ TEST_CASE("create timeval with min and micros mix", "[util][timeval]") {
 
     CHECK(tv.tv_sec == 60 * 5);
     CHECK(tv.tv_usec == 30000);
-}
\ No newline at end of file
+}
+
+TEST_CASE("parse addresses with and without a port", "[util][address]") {
+    sockaddr_storage addr{};
+    socklen_t len = 0;
+
+    REQUIRE(internal::parse_address("127.0.0.1:8080", addr, len));
+    CHECK(addr.ss_family == AF_INET);
+    CHECK(internal::port_of(addr) == 8080);
+
+    /* port 0 (any free port) is rejected by libevent, but not here */
+    REQUIRE(internal::parse_address("[::1]:0", addr, len));
+    CHECK(addr.ss_family == AF_INET6);
+    CHECK(internal::port_of(addr) == 0);
+
+    CHECK_FALSE(internal::parse_address("not an address", addr, len));
+}
@@ -0,0 +1,9 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+/*
+ * This file only exists in order to define the "main" benchmark function
+ * so that other benchmark files do not need to worry about setting up a
+ * main/benchmark-runner. Benchmarking support is enabled for the whole
+ * target via CATCH_CONFIG_ENABLE_BENCHMARKING (see CMakeLists.txt).
+ */
@@ -0,0 +1,399 @@
+#include "pembroke/net/connection.hpp"
+
+#include <cerrno>
+#include <atomic>
+#include <cstring>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <event2/util.h>
+#include <sys/socket.h>
+}
+
+namespace pembroke::net {
+
+    // ---
+    // Construction
+    // ---
+
+    auto Connection::open(event_base &base, Reactor *reactor, int fd, int priority) noexcept -> Connection {
+        auto *bev = bufferevent_socket_new(&base, fd, BEV_OPT_CLOSE_ON_FREE);
+        if (bev == nullptr) {
+            pembroke::logger::warn(fmt::format("Unable to create connection for fd {}", fd));
+            if (fd != -1) {
+                evutil_closesocket(fd);
+            }
+            return Connection();
+        }
+        int queue = internal::priority_queue(&base, priority);
+        if (queue > 0) {
+            bufferevent_priority_set(bev, queue);
+        }
+
+        Connection c;
+        c.m_bev = bev;
+        c.m_input = Buffer::borrow(bufferevent_get_input(bev));
+        c.m_output = Buffer::borrow(bufferevent_get_output(bev));
+        c.m_reactor = reactor;
+        c.m_instrumentation = reactor == nullptr ? nullptr : reactor->instrumentation();
+        c.bind();
+        bufferevent_enable(bev, EV_READ | EV_WRITE);
+        return c;
+    }
+
+    auto Connection::connect(Reactor &reactor, const std::string &address) noexcept -> Connection {
+        sockaddr_storage addr{};
+        int len = sizeof(addr);
+        if (evutil_parse_sockaddr_port(address.c_str(), reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+            pembroke::logger::warn(fmt::format("Unable to parse address {}", address));
+            return Connection();
+        }
+
+        auto c = open(*reactor.m_base, &reactor, -1, Event::DefaultPriority);
+        if (c && bufferevent_socket_connect(c.m_bev, reinterpret_cast<sockaddr *>(&addr), len) != 0) {
+            pembroke::logger::warn(fmt::format("Unable to connect to {}: {}", address, std::strerror(errno)));
+            c.close();
+        }
+        return c;
+    }
+
+    auto Connection::adopt(Reactor &reactor, int fd) noexcept -> Connection {
+        if (evutil_make_socket_nonblocking(fd) != 0) {
+            pembroke::logger::warn(fmt::format("Unable to make fd {} non-blocking", fd));
+            evutil_closesocket(fd);
+            return Connection();
+        }
+        return open(*reactor.m_base, &reactor, fd, Event::DefaultPriority);
+    }
+
+    Connection::Connection(Connection &&other) noexcept
+        : m_bev(std::exchange(other.m_bev, nullptr)),
+          m_input(std::move(other.m_input)),
+          m_output(std::move(other.m_output)),
+          m_reactor(other.m_reactor),
+          m_instrumentation(other.m_instrumentation),
+          m_on_read(std::move(other.m_on_read)),
+          m_on_write(std::move(other.m_on_write)),
+          m_on_close(std::move(other.m_on_close)),
+          m_on_backpressure(std::move(other.m_on_backpressure)),
+          m_input_cb(std::exchange(other.m_input_cb, nullptr)),
+          m_output_cb(std::exchange(other.m_output_cb, nullptr)),
+          m_low_watermark(other.m_low_watermark),
+          m_high_watermark(other.m_high_watermark),
+          m_congested(std::exchange(other.m_congested, false)),
+          m_input_limit(other.m_input_limit),
+          m_input_full(std::exchange(other.m_input_full, false)),
+          m_reading_paused(std::exchange(other.m_reading_paused, false)) {
+        other.move_running(this);
+        bind();
+    }
+
+    auto Connection::operator=(Connection &&other) noexcept -> Connection & {
+        if (this != &other) {
+            close();
+            move_running(nullptr);
+            other.move_running(this);
+            m_bev = std::exchange(other.m_bev, nullptr);
+            m_input = std::move(other.m_input);
+            m_output = std::move(other.m_output);
+            m_reactor = other.m_reactor;
+            m_instrumentation = other.m_instrumentation;
+            m_on_read = std::move(other.m_on_read);
+            m_on_write = std::move(other.m_on_write);
+            m_on_close = std::move(other.m_on_close);
+            m_on_backpressure = std::move(other.m_on_backpressure);
+            m_input_cb = std::exchange(other.m_input_cb, nullptr);
+            m_output_cb = std::exchange(other.m_output_cb, nullptr);
+            m_low_watermark = other.m_low_watermark;
+            m_high_watermark = other.m_high_watermark;
+            m_congested = std::exchange(other.m_congested, false);
+            m_input_limit = other.m_input_limit;
+            m_input_full = std::exchange(other.m_input_full, false);
+            m_reading_paused = std::exchange(other.m_reading_paused, false);
+            bind();
+        }
+        return *this;
+    }
+
+    Connection::~Connection() noexcept {
+        close();
+        move_running(nullptr);
+    }
+
+    void Connection::bind() noexcept {
+        if (m_bev == nullptr) {
+            return;
+        }
+        bufferevent_setcb(m_bev, Connection::read_cb, Connection::write_cb, Connection::event_cb, this);
+
+        auto *input = bufferevent_get_input(m_bev);
+        auto *output = bufferevent_get_output(m_bev);
+        if (m_input_cb != nullptr) {
+            evbuffer_remove_cb_entry(input, m_input_cb);
+        }
+        if (m_output_cb != nullptr) {
+            evbuffer_remove_cb_entry(output, m_output_cb);
+        }
+        m_input_cb = evbuffer_add_cb(input, Connection::buffer_cb, this);
+        m_output_cb = evbuffer_add_cb(output, Connection::buffer_cb, this);
+    }
+
+    // ---
+    // Configuration
+    // ---
+
+    auto Connection::on_read(ConnectionCallback callback) noexcept -> Connection & {
+        m_on_read = std::move(callback);
+        return *this;
+    }
+
+    auto Connection::on_write(ConnectionCallback callback) noexcept -> Connection & {
+        m_on_write = std::move(callback);
+        return *this;
+    }
+
+    auto Connection::on_close(CloseCallback callback) noexcept -> Connection & {
+        m_on_close = std::move(callback);
+        return *this;
+    }
+
+    auto Connection::idle_timeout(duration read_timeout, duration write_timeout) noexcept -> bool {
+        if (m_bev == nullptr) {
+            return false;
+        }
+        timeval read_tv{};
+        timeval write_tv{};
+        auto timeout_of = [this](duration timeout, timeval &tv) -> const timeval * {
+            if (timeout <= no_delay) {
+                return nullptr;
+            }
+            if (m_reactor != nullptr) {
+                if (const auto *common = m_reactor->common_timeout(timeout)) {
+                    return common;
+                }
+            }
+            tv = internal::to_timeval(timeout);
+            return &tv;
+        };
+        return bufferevent_set_timeouts(m_bev, timeout_of(read_timeout, read_tv), timeout_of(write_timeout, write_tv)) == 0;
+    }
+
+    // ---
+    // Flow Control
+    // ---
+
+    auto Connection::output_watermarks(size_t low, size_t high) noexcept -> bool {
+        if (m_bev == nullptr || low > high) {
+            return false;
+        }
+        m_low_watermark = low;
+        m_high_watermark = high;
+        /* Takes the current state silently, the callback only reports crossings */
+        if (high == 0) {
+            m_congested = false;
+        } else if (m_output.length() >= high) {
+            m_congested = true;
+        } else if (m_output.length() <= low) {
+            m_congested = false;
+        }
+        return true;
+    }
+
+    auto Connection::on_backpressure(BackpressureCallback callback) noexcept -> Connection & {
+        m_on_backpressure = std::move(callback);
+        return *this;
+    }
+
+    auto Connection::input_limit(size_t max) noexcept -> bool {
+        if (m_bev == nullptr) {
+            return false;
+        }
+        /* Enforced here rather than with libevent's read high-watermark, which in 2.1 keeps
+         * re-running the read callback (and the loop with it) until the input is consumed */
+        m_input_limit = max;
+        update_input_limit();
+        return true;
+    }
+
+    void Connection::pause_reading() noexcept {
+        m_reading_paused = true;
+        if (m_bev != nullptr) {
+            bufferevent_disable(m_bev, EV_READ);
+        }
+    }
+
+    void Connection::resume_reading() noexcept {
+        m_reading_paused = false;
+        if (m_bev != nullptr && !m_input_full) {
+            bufferevent_enable(m_bev, EV_READ);
+        }
+    }
+
+    void Connection::update_input_limit() noexcept {
+        bool full = m_input_limit != 0 && m_input.length() >= m_input_limit;
+        if (full == m_input_full) {
+            return;
+        }
+        m_input_full = full;
+        if (full) {
+            bufferevent_disable(m_bev, EV_READ);
+        } else if (!m_reading_paused) {
+            bufferevent_enable(m_bev, EV_READ);
+        }
+    }
+
+    // ---
+    // Lifetime
+    // ---
+
+    void Connection::close() noexcept {
+        if (m_bev == nullptr) {
+            return;
+        }
+        /* Whatever is left is released with the bufferevent, without running the buffer callbacks */
+        if (m_reactor != nullptr) {
+            auto &gauge = m_reactor->m_buffered_bytes;
+            gauge.store(gauge.load(std::memory_order_relaxed) - buffered(), std::memory_order_relaxed);
+        }
+        evbuffer_remove_cb_entry(bufferevent_get_input(m_bev), m_input_cb);
+        evbuffer_remove_cb_entry(bufferevent_get_output(m_bev), m_output_cb);
+        m_input_cb = nullptr;
+        m_output_cb = nullptr;
+        m_congested = false;
+        m_input_full = false;
+
+        // safe from within the bufferevent's own callbacks, libevent defers the release
+        bufferevent_free(m_bev);
+        m_bev = nullptr;
+        m_input = Buffer::borrow(nullptr);
+        m_output = Buffer::borrow(nullptr);
+    }
+
+    auto Connection::release(Buffer &input, Buffer &output) noexcept -> int {
+        if (m_bev == nullptr) {
+            return -1;
+        }
+        int fd = bufferevent_getfd(m_bev);
+        /* The bufferevent freezes the front of its output, only it may drain the buffer */
+        evbuffer_unfreeze(m_output.underlying(), 1);
+        input.append(std::move(m_input));
+        output.append(std::move(m_output));
+        /* Detached, so that freeing the bufferevent does not close it */
+        bufferevent_setfd(m_bev, -1);
+        close();
+        return fd;
+    }
+
+    auto Connection::fd() const noexcept -> int {
+        return m_bev == nullptr ? -1 : bufferevent_getfd(m_bev);
+    }
+
+    // ---
+    // Callbacks
+    // ---
+
+    template<typename F, typename... Args>
+    void Connection::run_owned(F Connection::*callback, Args &&...args) noexcept {
+        if (!(this->*callback)) {
+            return;
+        }
+        auto taken = std::move(this->*callback);
+        RunningCallback running{this, m_running};
+        m_running = &running;
+        run_callback(taken, *this, std::forward<Args>(args)...);
+
+        auto *self = running.connection;
+        if (self == nullptr) {
+            return;
+        }
+        self->m_running = running.outer;
+        if (!(self->*callback)) {
+            self->*callback = std::move(taken);
+        }
+    }
+
+    void Connection::move_running(Connection *to) noexcept {
+        for (auto *running = m_running; running != nullptr; running = running->outer) {
+            running->connection = to;
+        }
+        if (to != nullptr) {
+            to->m_running = m_running;
+        }
+        m_running = nullptr;
+    }
+
+    void Connection::read_cb(bufferevent * /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Connection read callback called with null connection");
+        auto *self = static_cast<Connection *>(arg);
+        self->update_input_limit();
+        self->run_owned(&Connection::m_on_read);
+    }
+
+    void Connection::write_cb(bufferevent * /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Connection write callback called with null connection");
+        auto *self = static_cast<Connection *>(arg);
+        self->run_owned(&Connection::m_on_write);
+    }
+
+    void Connection::event_cb(bufferevent * /*unused*/, short what, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Connection event callback called with null connection");
+        auto *self = static_cast<Connection *>(arg);
+        if ((what & BEV_EVENT_CONNECTED) != 0) {
+            return;
+        }
+
+        CloseReason reason = CloseReason::Error;
+        if ((what & BEV_EVENT_TIMEOUT) != 0) {
+            reason = CloseReason::Timeout;
+        } else if ((what & BEV_EVENT_EOF) != 0) {
+            reason = CloseReason::Eof;
+        }
+
+        int error = errno;
+        self->close();
+        errno = error;
+
+        /* Taken out of the connection first, the callback runs once and may destroy it */
+        auto on_close = std::move(self->m_on_close);
+        if (on_close) {
+            self->run_callback(on_close, *self, reason);
+        }
+    }
+
+    void Connection::buffer_cb(evbuffer *buffer, const evbuffer_cb_info *info, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Connection buffer callback called with null connection");
+        auto *self = static_cast<Connection *>(arg);
+        if (self->m_reactor != nullptr) {
+            /* Only ever written from the reactor's thread, no need for an atomic add */
+            auto &gauge = self->m_reactor->m_buffered_bytes;
+            gauge.store(gauge.load(std::memory_order_relaxed) + info->n_added - info->n_deleted, std::memory_order_relaxed);
+        }
+        if (buffer != self->m_output.underlying()) {
+            if (self->m_input_full && info->n_deleted > 0) {
+                self->update_input_limit();
+            }
+            return;
+        }
+        if (self->m_high_watermark == 0) {
+            return;
+        }
+
+        size_t length = info->orig_size + info->n_added - info->n_deleted;
+        if (!self->m_congested && length >= self->m_high_watermark) {
+            self->m_congested = true;
+        } else if (self->m_congested && length <= self->m_low_watermark) {
+            self->m_congested = false;
+        } else {
+            return;
+        }
+        bool congested = self->m_congested;
+        self->run_owned(&Connection::m_on_backpressure, congested);
+    }
+
+} // namespace pembroke::net
@@ -0,0 +1,374 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/net/connection.hpp"
+#include "pembroke/net/listener.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+extern "C" {
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+using namespace std::chrono_literals;
+using pembroke::net::CloseReason;
+using pembroke::net::Connection;
+using pembroke::net::Listener;
+
+// ---
+// Construction
+// ---
+
+TEST_CASE("Default and failed connections are closed", "[net][connection][construction]") {
+    auto r = pembroke::reactor().build();
+
+    Connection c;
+    CHECK_FALSE(c);
+    CHECK(c.fd() == -1);
+    CHECK(c.underlying() == nullptr);
+    CHECK_FALSE(c.idle_timeout(10ms));
+    c.close();
+
+    CHECK_FALSE(Connection::connect(*r, "not an address"));
+    CHECK_FALSE(Connection::adopt(*r, -1));
+}
+
+TEST_CASE("Adopted sockets become connections", "[net][connection]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+
+    auto c = Connection::adopt(*r, dup(pair.left()));
+    REQUIRE(c);
+    std::string received;
+    c.on_read([&](Connection &conn) {
+        received += conn.input().str();
+        conn.input().drain(conn.input().length());
+    });
+
+    REQUIRE(write(pair.right(), "ping", 4) == 4);
+    tick_until(*r, [&] { return received == "ping"; });
+
+    bool written = false;
+    c.on_write([&](Connection &) { written = true; });
+    c.output().add("pong");
+    tick_until(*r, [&] { return written; });
+
+    char buf[8] = {};
+    REQUIRE(read(pair.right(), buf, sizeof(buf)) == 4);
+    CHECK(std::string(buf, 4) == "pong");
+}
+
+// ---
+// Echo
+// ---
+
+TEST_CASE("Connections exchange data with a listener", "[net][connection][listener]") {
+    auto r = pembroke::reactor().build();
+    std::optional<Connection> server;
+    Listener listener("127.0.0.1:0", [&](Connection &&c) {
+        server.emplace(std::move(c));
+        server->on_read([](Connection &conn) {
+            conn.output().append(std::move(conn.input()));
+        });
+    });
+    REQUIRE(r->register_event(listener));
+    REQUIRE(listener.port() != 0);
+
+    auto client = Connection::connect(*r, "127.0.0.1:" + std::to_string(listener.port()));
+    REQUIRE(client);
+    std::string echoed;
+    client.on_read([&](Connection &conn) {
+        echoed += conn.input().str();
+        conn.input().drain(conn.input().length());
+    });
+
+    /* Large enough to take several reads and writes */
+    std::string expected;
+    for (int i = 0; i < 20000; i++) {
+        expected += "message " + std::to_string(i) + "\n";
+    }
+    client.output().add(expected);
+    tick_until(*r, [&] { return echoed.size() == expected.size(); });
+    CHECK(echoed == expected);
+    REQUIRE(server.has_value());
+    CHECK(server->fd() != -1);
+}
+
+// ---
+// Closing
+// ---
+
+TEST_CASE("The close callback reports the peer closing", "[net][connection]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+
+    auto c = Connection::adopt(*r, dup(pair.left()));
+    std::optional<CloseReason> reason;
+    int closes = 0;
+    c.on_close([&](Connection &conn, CloseReason why) {
+        CHECK_FALSE(conn);
+        reason = why;
+        closes++;
+    });
+
+    shutdown(pair.right(), SHUT_WR);
+    tick_until(*r, [&] { return reason.has_value(); });
+    CHECK(*reason == CloseReason::Eof);
+    CHECK_FALSE(c);
+    CHECK(c.input().length() == 0);
+
+    CHECK(r->tick());
+    CHECK(closes == 1);
+}
+
+TEST_CASE("Idle connections time out", "[net][connection]") {
+    auto r = pembroke::reactor().common_timeout(20ms).build();
+    pembroke::SocketPair pair;
+
+    auto c = Connection::adopt(*r, dup(pair.left()));
+    std::optional<CloseReason> reason;
+    c.on_close([&](Connection &, CloseReason why) { reason = why; });
+    REQUIRE(c.idle_timeout(20ms, 0ms));
+
+    auto start = std::chrono::steady_clock::now();
+    tick_until(*r, [&] { return reason.has_value(); });
+    CHECK(*reason == CloseReason::Timeout);
+    CHECK(std::chrono::steady_clock::now() - start >= 15ms);
+}
+
+TEST_CASE("Connections may be destroyed from their own callbacks", "[net][connection]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+
+    /* The callback's captures outlive the connection it destroys */
+    std::string seen;
+    auto c = std::make_optional(Connection::adopt(*r, dup(pair.left())));
+    c->on_read([&, tag = std::string(64, 'c')](Connection &) {
+        c.reset();
+        seen = tag;
+    });
+    REQUIRE(write(pair.right(), "x", 1) == 1);
+    tick_until(*r, [&] { return !c.has_value(); });
+    CHECK(seen == std::string(64, 'c'));
+
+    auto d = std::make_optional(Connection::adopt(*r, dup(pair.right())));
+    d->on_close([&](Connection &, CloseReason) { d.reset(); });
+    pair.close_left();
+    tick_until(*r, [&] { return !d.has_value(); });
+}
+
+TEST_CASE("Moved connections keep their callbacks", "[net][connection]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+
+    std::string received;
+    auto first = Connection::adopt(*r, dup(pair.left()));
+    first.on_read([&](Connection &conn) {
+        received += conn.input().str();
+        conn.input().drain(conn.input().length());
+    });
+
+    Connection moved(std::move(first));
+    CHECK_FALSE(first);
+    Connection assigned;
+    assigned = std::move(moved);
+    CHECK_FALSE(moved);
+    REQUIRE(assigned);
+
+    REQUIRE(write(pair.right(), "moved", 5) == 5);
+    tick_until(*r, [&] { return received == "moved"; });
+}
+
+TEST_CASE("Connections moved from their own callbacks keep their callbacks", "[net][connection]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+
+    std::string received;
+    std::optional<Connection> moved;
+    auto first = std::make_optional(Connection::adopt(*r, dup(pair.left())));
+    first->on_read([&](Connection &conn) {
+        received += conn.input().str();
+        conn.input().drain(conn.input().length());
+        if (!moved) {
+            moved.emplace(std::move(conn));
+            first.reset();
+        }
+    });
+
+    REQUIRE(write(pair.right(), "one", 3) == 3);
+    tick_until(*r, [&] { return received == "one"; });
+    REQUIRE(moved);
+    REQUIRE(*moved);
+
+    REQUIRE(write(pair.right(), "two", 3) == 3);
+    tick_until(*r, [&] { return received == "onetwo"; });
+}
+
+// ---
+// Flow Control
+// ---
+
+/* Read (and discard) up to @p max bytes waiting on @p fd */
+static auto drain_peer(int fd, size_t max) -> size_t {
+    char buf[16 * 1024];
+    size_t total = 0;
+    while (total < max) {
+        auto n = read(fd, buf, std::min(sizeof(buf), max - total));
+        if (n <= 0) {
+            break;
+        }
+        total += static_cast<size_t>(n);
+    }
+    return total;
+}
+
+TEST_CASE("Output watermarks report backpressure", "[net][connection][flow_control]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+    auto c = Connection::adopt(*r, dup(pair.left()));
+
+    CHECK_FALSE(c.output_watermarks(2, 1));
+    REQUIRE(c.output_watermarks(64 * 1024, 256 * 1024));
+    std::vector<std::pair<bool, size_t>> crossings;
+    c.on_backpressure([&](Connection &conn, bool congested) {
+        crossings.emplace_back(congested, conn.output().length());
+    });
+
+    /* Crossing the high mark is reported straight away, before anything is written */
+    c.output().add(std::string(128 * 1024, 'a'));
+    CHECK(crossings.empty());
+    c.output().add(std::string(128 * 1024, 'b'));
+    REQUIRE(crossings.size() == 1);
+    CHECK(crossings[0].first);
+    CHECK(crossings[0].second == 256 * 1024);
+    CHECK(c.congested());
+
+    c.output().add(std::string(768 * 1024, 'c'));
+    CHECK(crossings.size() == 1);
+
+    /* Reading slowly on the other end eventually drains it below the low mark */
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (crossings.size() < 2) {
+        REQUIRE(std::chrono::steady_clock::now() < deadline);
+        drain_peer(pair.right(), 32 * 1024);
+        REQUIRE(r->tick());
+    }
+    CHECK_FALSE(crossings[1].first);
+    CHECK(crossings[1].second <= 64 * 1024);
+    CHECK_FALSE(c.congested());
+}
+
+TEST_CASE("Watermarks take the current state without reporting it", "[net][connection][flow_control]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+    auto c = Connection::adopt(*r, dup(pair.left()));
+
+    int calls = 0;
+    c.on_backpressure([&](Connection &, bool) { calls++; });
+    c.output().add(std::string(4096, 'x'));
+    REQUIRE(c.output_watermarks(10, 100));
+    CHECK(c.congested());
+    CHECK(calls == 0);
+
+    REQUIRE(c.output_watermarks(0, 0));
+    CHECK_FALSE(c.congested());
+    c.output().add(std::string(4096, 'x'));
+    CHECK(calls == 0);
+}
+
+TEST_CASE("Input limits stop reading until input is consumed", "[net][connection][flow_control]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+    auto c = Connection::adopt(*r, dup(pair.left()));
+    REQUIRE(c.input_limit(16 * 1024));
+
+    size_t reads = 0;
+    c.on_read([&](Connection &) { reads++; });
+    std::string chunk(64 * 1024, 'x');
+    REQUIRE(write(pair.right(), chunk.data(), chunk.size()) > 0);
+
+    tick_until(*r, [&] { return reads > 0; });
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(r->tick());
+    }
+    /* Reads stopped at the limit (bufferevents read 4KiB at a time) */
+    auto held = c.input().length();
+    CHECK(held >= 16 * 1024);
+    CHECK(held < 20 * 1024);
+
+    auto before = reads;
+    c.input().drain(c.input().length());
+    tick_until(*r, [&] { return reads > before; });
+    CHECK(c.input().length() > 0);
+    CHECK(c.input().length() < 20 * 1024);
+
+    /* Pausing is independent of the limit */
+    c.pause_reading();
+    c.input().drain(c.input().length());
+    before = reads;
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(r->tick());
+    }
+    CHECK(reads == before);
+    c.resume_reading();
+    tick_until(*r, [&] { return reads > before; });
+}
+
+TEST_CASE("Paused connections stop reading", "[net][connection][flow_control]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair pair;
+    auto c = Connection::adopt(*r, dup(pair.left()));
+    size_t reads = 0;
+    c.on_read([&](Connection &) { reads++; });
+
+    c.pause_reading();
+    REQUIRE(write(pair.right(), "held", 4) == 4);
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(r->tick());
+    }
+    CHECK(reads == 0);
+
+    c.resume_reading();
+    tick_until(*r, [&] { return reads == 1; });
+    CHECK(c.input().str() == "held");
+}
+
+TEST_CASE("Buffered bytes are gauged per connection and per reactor", "[net][connection][flow_control]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair first_pair;
+    pembroke::SocketPair second_pair;
+    auto first = Connection::adopt(*r, dup(first_pair.left()));
+    auto second = Connection::adopt(*r, dup(second_pair.left()));
+    CHECK(r->buffered_bytes() == 0);
+
+    first.pause_reading();
+    first.output().add("0123456789");
+    second.output().add("abc");
+    CHECK(first.buffered() == 10);
+    CHECK(r->buffered_bytes() == 13);
+
+    /* Written out */
+    tick_until(*r, [&] { return r->buffered_bytes() == 0; });
+    CHECK(first.buffered() == 0);
+
+    /* Read in, and released on close */
+    REQUIRE(write(second_pair.right(), "input", 5) == 5);
+    tick_until(*r, [&] { return second.input().length() == 5; });
+    CHECK(second.buffered() == 5);
+    CHECK(r->buffered_bytes() == 5);
+
+    Connection moved(std::move(second));
+    REQUIRE(write(second_pair.right(), "more", 4) == 4);
+    tick_until(*r, [&] { return moved.input().length() == 9; });
+    CHECK(r->buffered_bytes() == 9);
+
+    moved.close();
+    CHECK(r->buffered_bytes() == 0);
+}
@@ -0,0 +1,172 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pembroke/event.hpp"
+#include "pembroke/reactor.hpp"
+#include "pembroke/net/connection.hpp"
+#include "pembroke/net/listener.hpp"
+
+extern "C" {
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <event2/listener.h>
+#include <event2/util.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+}
+
+/*
+ * An echo server built from net::Listener and net::Connection, against the same server
+ * written directly on libevent's evconnlistener and bufferevent. Both are driven by the
+ * same raw bufferevent clients on the server's reactor, measuring connections per second
+ * (connect, echo a line, close) and bytes per second (echoing a large payload).
+ */
+
+static constexpr int ConnectionsPerRun = 100;
+static constexpr size_t PayloadBytes = 4 * 1024 * 1024;
+
+/* Captures the reactor's event_base, for the raw server and the clients */
+class BaseCapture final : public pembroke::Event {
+public:
+    event_base *base = nullptr;
+
+    auto register_event(event_base &b) noexcept -> bool override {
+        base = &b;
+        return true;
+    }
+};
+
+// ---
+// Raw libevent server
+// ---
+
+static void raw_read_cb(bufferevent *bev, void * /*unused*/) {
+    evbuffer_add_buffer(bufferevent_get_output(bev), bufferevent_get_input(bev));
+}
+
+static void raw_event_cb(bufferevent *bev, short /*unused*/, void * /*unused*/) {
+    bufferevent_free(bev);
+}
+
+static void raw_accept_cb(evconnlistener *listener, int fd, sockaddr * /*unused*/, int /*unused*/, void * /*unused*/) {
+    auto *bev = bufferevent_socket_new(evconnlistener_get_base(listener), fd, BEV_OPT_CLOSE_ON_FREE);
+    bufferevent_setcb(bev, raw_read_cb, nullptr, raw_event_cb, nullptr);
+    bufferevent_enable(bev, EV_READ | EV_WRITE);
+}
+
+static auto raw_listen(event_base *base) -> evconnlistener * {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto *listener = evconnlistener_new_bind(base, raw_accept_cb, nullptr, LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE,
+                                             -1, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    REQUIRE(listener != nullptr);
+    return listener;
+}
+
+static auto port_of(int fd) -> uint16_t {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    REQUIRE(getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len) == 0);
+    return ntohs(addr.sin_port);
+}
+
+// ---
+// Clients
+// ---
+
+struct Client {
+    bufferevent *bev = nullptr;
+    size_t expected = 0;
+    int *done = nullptr;
+};
+
+static void client_read_cb(bufferevent *bev, void *arg) {
+    auto *c = static_cast<Client *>(arg);
+    auto *in = bufferevent_get_input(bev);
+    if (evbuffer_get_length(in) >= c->expected) {
+        bufferevent_free(bev);
+        c->bev = nullptr;
+        (*c->done)++;
+    }
+}
+
+/* Open @p n clients to @p port, each sending @p payload and waiting for it to be echoed */
+static void run_clients(pembroke::Reactor &r, event_base *base, uint16_t port, int n, const std::string &payload) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    int done = 0;
+    std::vector<Client> clients(static_cast<size_t>(n));
+    for (auto &c : clients) {
+        c.expected = payload.size();
+        c.done = &done;
+        c.bev = bufferevent_socket_new(base, -1, BEV_OPT_CLOSE_ON_FREE);
+        bufferevent_setcb(c.bev, client_read_cb, nullptr, nullptr, &c);
+        bufferevent_setwatermark(c.bev, EV_READ, payload.size(), 0);
+        bufferevent_enable(c.bev, EV_READ | EV_WRITE);
+        REQUIRE(bufferevent_socket_connect(c.bev, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+        bufferevent_write(c.bev, payload.data(), payload.size());
+    }
+    while (done < n) {
+        REQUIRE(r.tick());
+    }
+}
+
+static auto large_payload() -> std::string {
+    std::string payload;
+    while (payload.size() < PayloadBytes) {
+        payload += "GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+    return payload;
+}
+
+TEST_CASE("Echo server: pembroke vs raw libevent", "[net][listener][connection][benchmark]") {
+    auto r = pembroke::reactor().build();
+    BaseCapture capture;
+    REQUIRE(r->register_event(capture));
+
+    std::vector<std::unique_ptr<pembroke::net::Connection>> connections;
+    pembroke::net::Listener listener("127.0.0.1:0", [&](pembroke::net::Connection &&c) {
+        auto &conn = *connections.emplace_back(std::make_unique<pembroke::net::Connection>(std::move(c)));
+        conn.on_read([](pembroke::net::Connection &self) {
+            self.output().append(std::move(self.input()));
+        });
+    });
+    REQUIRE(r->register_event(listener));
+    auto *raw = raw_listen(capture.base);
+    auto raw_port = port_of(evconnlistener_get_fd(raw));
+
+    const std::string line = "hello\n";
+    const auto payload = large_payload();
+
+    BENCHMARK("pembroke: " + std::to_string(ConnectionsPerRun) + " connections") {
+        run_clients(*r, capture.base, listener.port(), ConnectionsPerRun, line);
+        connections.clear();
+        return ConnectionsPerRun;
+    };
+
+    BENCHMARK("libevent: " + std::to_string(ConnectionsPerRun) + " connections") {
+        run_clients(*r, capture.base, raw_port, ConnectionsPerRun, line);
+        return ConnectionsPerRun;
+    };
+
+    BENCHMARK("pembroke: echo " + std::to_string(PayloadBytes / 1024) + "KiB") {
+        run_clients(*r, capture.base, listener.port(), 1, payload);
+        connections.clear();
+        return PayloadBytes;
+    };
+
+    BENCHMARK("libevent: echo " + std::to_string(PayloadBytes / 1024) + "KiB") {
+        run_clients(*r, capture.base, raw_port, 1, payload);
+        return PayloadBytes;
+    };
+
+    evconnlistener_free(raw);
+}
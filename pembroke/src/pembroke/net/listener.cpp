@@ -0,0 +1,167 @@
+#include "pembroke/net/listener.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <event2/event.h>
+#include <event2/listener.h>
+#include <event2/util.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+}
+
+namespace pembroke::net {
+
+    Listener::Listener(std::string address, AcceptCallback on_accept) noexcept
+        : m_address(std::move(address)), m_on_accept(std::move(on_accept)) {}
+
+    Listener::~Listener() {
+        close();
+    }
+
+    auto Listener::backlog(int n) noexcept -> Listener & {
+        m_backlog = n;
+        return *this;
+    }
+
+    auto Listener::reuse_port(bool val) noexcept -> Listener & {
+        m_reuse_port = val;
+        return *this;
+    }
+
+    auto Listener::accept_batch(size_t n) noexcept -> Listener & {
+        m_accept_batch = n;
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto Listener::register_event(Reactor &reactor) noexcept -> bool {
+        return listen(base_of(reactor), &reactor);
+    }
+
+    [[nodiscard]]
+    auto Listener::register_event(event_base &base) noexcept -> bool {
+        return listen(base, nullptr);
+    }
+
+    auto Listener::listen(event_base &base, Reactor *reactor) noexcept -> bool {
+        if (m_listener != nullptr) {
+            pembroke::logger::error("Attempting to register a listener twice");
+            return false;
+        }
+        m_reactor = reactor;
+        m_base = &base;
+
+        sockaddr_storage addr{};
+        socklen_t len = 0;
+        if (!internal::parse_address(m_address, addr, len)) {
+            pembroke::logger::warn(fmt::format("Unable to parse listener address {}", m_address));
+            return false;
+        }
+
+        /* Bound disabled, the reactor may be running on another thread and must not accept
+         * until the listener is complete */
+        unsigned flags = LEV_OPT_CLOSE_ON_FREE | LEV_OPT_CLOSE_ON_EXEC | LEV_OPT_REUSEABLE | LEV_OPT_DISABLED;
+        if (m_reuse_port) {
+            flags |= LEV_OPT_REUSEABLE_PORT;
+        }
+        /* libevent substitutes 128 for a negative backlog, the kernel clamps this one to its maximum */
+        int backlog = m_backlog < 0 ? std::numeric_limits<int>::max() : m_backlog;
+        m_listener = evconnlistener_new_bind(&base, Listener::accept_cb, this, flags, backlog,
+                                             reinterpret_cast<sockaddr *>(&addr), static_cast<int>(len));
+        if (m_listener == nullptr) {
+            pembroke::logger::warn(fmt::format("Unable to listen on {}: {}", m_address, std::strerror(errno)));
+            return false;
+        }
+
+        m_batch_end = event_new(&base, -1, 0, Listener::batch_end_cb, this);
+        if (m_batch_end == nullptr || !apply_priority(m_batch_end)) {
+            pembroke::logger::warn("Unable to create listener batch event");
+            close();
+            return false;
+        }
+        if (m_enable_on_listen && !enable()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    auto Listener::enable() noexcept -> bool {
+        if (m_listener == nullptr || evconnlistener_enable(m_listener) != 0) {
+            pembroke::logger::warn(fmt::format("Unable to start accepting on {}", m_address));
+            return false;
+        }
+        return true;
+    }
+
+    auto Listener::port() const noexcept -> uint16_t {
+        sockaddr_storage addr{};
+        socklen_t len = sizeof(addr);
+        if (m_listener == nullptr || getsockname(fd(), reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+            return 0;
+        }
+        return internal::port_of(addr);
+    }
+
+    auto Listener::fd() const noexcept -> int {
+        return m_listener == nullptr ? -1 : evconnlistener_get_fd(m_listener);
+    }
+
+    void Listener::close() noexcept {
+        if (m_batch_end != nullptr) {
+            event_free(m_batch_end);
+            m_batch_end = nullptr;
+        }
+        if (m_listener != nullptr) {
+            evconnlistener_free(m_listener);
+            m_listener = nullptr;
+        }
+        m_base = nullptr;
+        m_accepted = 0;
+    }
+
+    void Listener::accept_cb(evconnlistener *listener, int fd, sockaddr * /*unused*/, int /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Listener accept callback called with null listener");
+        auto *self = static_cast<Listener *>(arg);
+
+        /* Once a batch is full, stop accepting until the events that became ready alongside
+         * the listener have run (the batch-end event is queued behind them) */
+        if (self->m_accept_batch > 0) {
+            if (self->m_accepted++ == 0) {
+                event_active(self->m_batch_end, EV_TIMEOUT, 0);
+            }
+            if (self->m_accepted >= self->m_accept_batch) {
+                evconnlistener_disable(listener);
+            }
+        }
+
+        if (self->m_on_accept_fd) {
+            self->m_on_accept_fd(fd);
+            return;
+        }
+        auto connection = Connection::open(*self->m_base, self->m_reactor, fd, self->m_priority);
+        if (!connection) {
+            return;
+        }
+        // the callback is free to destroy the listener
+        self->run_callback(self->m_on_accept, CallbackKind::Io, std::move(connection));
+    }
+
+    void Listener::batch_end_cb(int /*unused*/, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Listener batch callback called with null listener");
+        auto *self = static_cast<Listener *>(arg);
+        self->m_accepted = 0;
+        if (self->m_listener != nullptr) {
+            evconnlistener_enable(self->m_listener);
+        }
+    }
+
+} // namespace pembroke::net
@@ -0,0 +1,125 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/net/connection.hpp"
+#include "pembroke/net/listener.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+extern "C" {
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+}
+
+using pembroke::net::Connection;
+using pembroke::net::Listener;
+
+static auto address_of(const Listener &l) -> std::string {
+    return "127.0.0.1:" + std::to_string(l.port());
+}
+
+// ---
+// Registration
+// ---
+
+TEST_CASE("Listeners fail to register on bad addresses", "[net][listener][registration]") {
+    auto r = pembroke::reactor().build();
+
+    Listener unparsable("not an address", [](Connection &&) {});
+    CHECK_FALSE(r->register_event(unparsable));
+    CHECK(unparsable.port() == 0);
+    CHECK(unparsable.fd() == -1);
+
+    Listener first("127.0.0.1:0", [](Connection &&) {});
+    REQUIRE(r->register_event(first));
+    CHECK(first.fd() != -1);
+    CHECK_FALSE(r->register_event(first));
+
+    /* Without reuse_port() the address is taken */
+    Listener second(address_of(first), [](Connection &&) {});
+    CHECK_FALSE(r->register_event(second));
+
+    first.close();
+    CHECK(first.port() == 0);
+    CHECK(first.fd() == -1);
+}
+
+TEST_CASE("Listeners with reuse_port share an address", "[net][listener][registration]") {
+    auto r = pembroke::reactor().build();
+
+    Listener first("127.0.0.1:0", [](Connection &&) {});
+    first.reuse_port();
+    REQUIRE(r->register_event(first));
+
+    Listener second(address_of(first), [](Connection &&) {});
+    second.reuse_port();
+    CHECK(r->register_event(second));
+    CHECK(second.port() == first.port());
+}
+
+// ---
+// Accepting
+// ---
+
+TEST_CASE("Accepted connections are closed unless kept", "[net][listener]") {
+    auto r = pembroke::reactor().build();
+    int accepted = 0;
+    Listener listener("127.0.0.1:0", [&](Connection &&c) {
+        CHECK(c);
+        accepted++;
+    });
+    REQUIRE(r->register_event(listener));
+
+    bool closed = false;
+    auto client = Connection::connect(*r, address_of(listener));
+    client.on_close([&](Connection &, pembroke::net::CloseReason) { closed = true; });
+    tick_until(*r, [&] { return closed; });
+    CHECK(accepted == 1);
+}
+
+TEST_CASE("Accept batches let other events run", "[net][listener]") {
+    auto r = pembroke::reactor().build();
+    struct {
+        std::vector<Connection> accepted;
+        std::optional<size_t> accepted_before_other;
+    } state;
+    auto &accepted = state.accepted;
+    Listener listener("127.0.0.1:0", [&](Connection &&c) {
+        if (accepted.empty()) {
+            /* Made ready behind the listener, as another event becoming ready would be */
+            event_base_once(bufferevent_get_base(c.underlying()), -1, EV_TIMEOUT, [](int, short, void *arg) {
+                auto *s = static_cast<decltype(state) *>(arg);
+                s->accepted_before_other = s->accepted.size();
+            }, &state, nullptr);
+        }
+        accepted.push_back(std::move(c));
+    });
+    listener.accept_batch(2);
+    REQUIRE(r->register_event(listener));
+
+    std::vector<Connection> clients;
+    for (int i = 0; i < 6; i++) {
+        clients.push_back(Connection::connect(*r, address_of(listener)));
+    }
+
+    tick_until(*r, [&] { return accepted.size() == 6; });
+    REQUIRE(state.accepted_before_other.has_value());
+    CHECK(*state.accepted_before_other <= 2);
+}
+
+TEST_CASE("Listeners may be closed from the accept callback", "[net][listener]") {
+    auto r = pembroke::reactor().build();
+    std::unique_ptr<Listener> listener;
+    listener = std::make_unique<Listener>("127.0.0.1:0", [&](Connection &&) {
+        listener.reset();
+    });
+    REQUIRE(r->register_event(*listener));
+
+    auto client = Connection::connect(*r, address_of(*listener));
+    tick_until(*r, [&] { return listener == nullptr; });
+}
@@ -0,0 +1,75 @@
+#include "pembroke/net/pipe_pool.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+}
+
+namespace pembroke::net {
+
+    PipePool::PipePool(size_t capacity) : m_capacity(capacity) {
+        m_free.reserve(capacity);
+    }
+
+    PipePool::~PipePool() noexcept {
+        for (auto &pipe : m_free) {
+            close(pipe);
+        }
+    }
+
+    auto PipePool::acquire() noexcept -> Pipe {
+        m_stats.acquired++;
+        if (!m_free.empty()) {
+            auto pipe = m_free.back();
+            m_free.pop_back();
+            m_stats.hits++;
+            return pipe;
+        }
+
+        int fds[2];
+        if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+            pembroke::logger::warn(fmt::format("Unable to create pipe: {}", std::strerror(errno)));
+            return Pipe{};
+        }
+        return Pipe{fds[0], fds[1]};
+    }
+
+    void PipePool::release(Pipe &pipe) noexcept {
+        if (!pipe) {
+            return;
+        }
+        m_stats.returned++;
+        int pending = 0;
+        if (m_free.size() >= m_capacity || ioctl(pipe.read_fd, FIONREAD, &pending) != 0 || pending != 0) {
+            m_stats.discarded++;
+            close(pipe);
+            return;
+        }
+        m_free.push_back(pipe);
+        pipe = Pipe{};
+    }
+
+    auto PipePool::stats() const noexcept -> Stats {
+        auto stats = m_stats;
+        stats.retained = m_free.size();
+        return stats;
+    }
+
+    void PipePool::close(Pipe &pipe) noexcept {
+        if (pipe.read_fd != -1) {
+            ::close(pipe.read_fd);
+        }
+        if (pipe.write_fd != -1) {
+            ::close(pipe.write_fd);
+        }
+        pipe = Pipe{};
+    }
+
+} // namespace pembroke::net
@@ -0,0 +1,130 @@
+#include "pembroke/net/sharded_listener.hpp"
+
+#include <utility>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <event2/util.h>
+}
+
+namespace pembroke::net {
+
+    /* @p address with its port replaced by @p port */
+    static auto with_port(const std::string &address, uint16_t port) -> std::string {
+        auto colon = address.rfind(':');
+        auto bracket = address.rfind(']');
+        if (colon == std::string::npos || (bracket != std::string::npos && colon < bracket)) {
+            return address + ":" + std::to_string(port);
+        }
+        return address.substr(0, colon) + ":" + std::to_string(port);
+    }
+
+    ShardedListener::ShardedListener(std::string address, ShardedAcceptCallback on_accept, AcceptMode mode) noexcept
+        : m_address(std::move(address)), m_on_accept(std::move(on_accept)), m_mode(mode) {}
+
+    ShardedListener::~ShardedListener() {
+        close();
+    }
+
+    auto ShardedListener::backlog(int n) noexcept -> ShardedListener & {
+        m_backlog = n;
+        return *this;
+    }
+
+    auto ShardedListener::accept_batch(size_t n) noexcept -> ShardedListener & {
+        m_accept_batch = n;
+        return *this;
+    }
+
+    auto ShardedListener::placement(Placement placement) noexcept -> ShardedListener & {
+        m_placement = placement;
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto ShardedListener::listen(ReactorGroup &group) noexcept -> bool {
+        if (!m_listeners.empty()) {
+            pembroke::logger::error("Attempting to listen with a sharded listener twice");
+            return false;
+        }
+        m_group = &group;
+        m_accepted = std::make_unique<std::atomic<uint64_t>[]>(group.size());
+        for (size_t shard = 0; shard < group.size(); shard++) {
+            m_accepted[shard].store(0, std::memory_order_relaxed);
+        }
+
+        size_t sockets = m_mode == AcceptMode::ReusePort ? group.size() : 1;
+        auto address = m_address;
+        for (size_t shard = 0; shard < sockets; shard++) {
+            auto &listener = m_listeners.emplace_back(std::make_unique<Listener>(address, [this, shard](Connection &&c) {
+                deliver(std::move(c), shard);
+            }));
+            listener->backlog(m_backlog).accept_batch(m_accept_batch).reuse_port(m_mode == AcceptMode::ReusePort);
+            listener->m_enable_on_listen = false;
+            if (m_mode == AcceptMode::Handoff) {
+                listener->m_on_accept_fd = [this](int fd) { hand_off(fd); };
+            }
+            if (!group.register_event(*listener, shard)) {
+                pembroke::logger::warn(fmt::format("Unable to listen on {} for reactor shard {}", address, shard));
+                close();
+                return false;
+            }
+            /* The others bind the same port, whatever the first was given */
+            address = with_port(m_address, listener->port());
+        }
+
+        /* Only once every socket is bound, so that a failure above leaves nothing accepting
+         * (and nothing a running reactor could be using) to roll back */
+        bool enabled = true;
+        for (auto &listener : m_listeners) {
+            enabled = listener->enable() && enabled;
+        }
+        return enabled;
+    }
+
+    auto ShardedListener::port() const noexcept -> uint16_t {
+        return m_listeners.empty() ? 0 : m_listeners.front()->port();
+    }
+
+    auto ShardedListener::accepted(size_t shard) const noexcept -> uint64_t {
+        if (m_group == nullptr || shard >= m_group->size()) {
+            return 0;
+        }
+        return m_accepted[shard].load(std::memory_order_relaxed);
+    }
+
+    void ShardedListener::close() noexcept {
+        m_listeners.clear();
+    }
+
+    void ShardedListener::deliver(Connection &&connection, size_t shard) noexcept {
+        m_accepted[shard].fetch_add(1, std::memory_order_relaxed);
+        m_on_accept(std::move(connection), shard);
+    }
+
+    void ShardedListener::hand_off(int fd) noexcept {
+        auto shard = m_group->pick_shard(m_placement);
+        auto &reactor = m_group->reactor(shard);
+        if (shard == 0) {
+            // already on the acceptor's reactor
+            if (auto c = Connection::adopt(reactor, fd)) {
+                deliver(std::move(c), shard);
+            }
+            return;
+        }
+
+        bool posted = reactor.post([this, &reactor, fd, shard]() -> void {
+            if (auto c = Connection::adopt(reactor, fd)) {
+                deliver(std::move(c), shard);
+            }
+        });
+        if (!posted) {
+            pembroke::logger::warn(fmt::format("Reactor shard {} task queue is full, dropping connection", shard));
+            evutil_closesocket(fd);
+        }
+    }
+
+} // namespace pembroke::net
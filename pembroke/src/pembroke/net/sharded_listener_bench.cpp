@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/reactor_group.hpp"
+#include "pembroke/net/sharded_listener.hpp"
+
+extern "C" {
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+/*
+ * Loopback accept rate of a ShardedListener in both modes. A client thread opens and
+ * closes connections as fast as it can, while the group's reactors accept them. Balance is
+ * reported as the share of connections taken by the busiest reactor (1/n is perfect).
+ */
+
+static constexpr int ConnectionsPerRun = 500;
+
+static auto connect_to(uint16_t port) -> int {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+static void run_accept_benchmark(pembroke::net::AcceptMode mode, size_t n_reactors) {
+    auto group = pembroke::reactor().build_group(n_reactors);
+    pembroke::net::ShardedListener listener("127.0.0.1:0", [](pembroke::net::Connection &&, size_t) {}, mode);
+    REQUIRE(listener.listen(*group));
+    REQUIRE(group->start());
+
+    auto total = [&] {
+        uint64_t sum = 0;
+        for (size_t shard = 0; shard < n_reactors; shard++) {
+            sum += listener.accepted(shard);
+        }
+        return sum;
+    };
+
+    std::string name = mode == pembroke::net::AcceptMode::ReusePort ? "reuse-port" : "handoff";
+    BENCHMARK(name + ", " + std::to_string(n_reactors) + " reactor(s), " + std::to_string(ConnectionsPerRun) + " connections") {
+        auto target = total() + ConnectionsPerRun;
+        for (int i = 0; i < ConnectionsPerRun; i++) {
+            ::close(connect_to(listener.port()));
+        }
+        while (total() < target) {
+            std::this_thread::yield();
+        }
+        return target;
+    };
+
+    uint64_t busiest = 0;
+    for (size_t shard = 0; shard < n_reactors; shard++) {
+        busiest = std::max(busiest, listener.accepted(shard));
+    }
+    WARN(name << " busiest reactor share: " << static_cast<double>(busiest) / static_cast<double>(total())
+              << " (ideal " << 1.0 / static_cast<double>(n_reactors) << ")");
+
+    group->stop();
+    listener.close();
+}
+
+TEST_CASE("ShardedListener accept rate and balance", "[net][sharded_listener][benchmark]") {
+    auto max = std::max(2U, std::thread::hardware_concurrency());
+    for (size_t n = 1; n <= max; n *= 2) {
+        run_accept_benchmark(pembroke::net::AcceptMode::ReusePort, n);
+        run_accept_benchmark(pembroke::net::AcceptMode::Handoff, n);
+    }
+}
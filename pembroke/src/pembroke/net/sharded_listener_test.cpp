@@ -0,0 +1,140 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/reactor_group.hpp"
+#include "pembroke/net/sharded_listener.hpp"
+
+extern "C" {
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+using namespace std::chrono_literals;
+using pembroke::net::AcceptMode;
+using pembroke::net::Connection;
+using pembroke::net::ShardedListener;
+
+/* A blocking client socket connected to 127.0.0.1:@p port */
+static auto connect_to(uint16_t port) -> int {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(fd >= 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+/* Per-shard connections, each vector only ever touched by its shard's thread */
+struct Accepted {
+    std::vector<std::vector<Connection>> connections;
+    std::vector<std::thread::id> threads;
+
+    explicit Accepted(size_t shards) : connections(shards), threads(shards) {}
+
+    /* Catch's assertions are not thread-safe, checks are made once the group has stopped */
+    void add(Connection &&c, size_t shard) {
+        threads[shard] = std::this_thread::get_id();
+        if (c) {
+            connections[shard].push_back(std::move(c));
+        }
+    }
+};
+
+static void connect_and_wait(ShardedListener &listener, size_t shards, int n) {
+    std::vector<int> clients;
+    for (int i = 0; i < n; i++) {
+        clients.push_back(connect_to(listener.port()));
+    }
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    for (;;) {
+        uint64_t total = 0;
+        for (size_t shard = 0; shard < shards; shard++) {
+            total += listener.accepted(shard);
+        }
+        if (total == static_cast<uint64_t>(n)) {
+            break;
+        }
+        REQUIRE(std::chrono::steady_clock::now() < deadline);
+        std::this_thread::sleep_for(1ms);
+    }
+    for (int fd : clients) {
+        ::close(fd);
+    }
+}
+
+TEST_CASE("Sharded listeners fail on bad addresses", "[net][sharded_listener]") {
+    auto group = pembroke::reactor().build_group(2);
+    ShardedListener listener("not an address", [](Connection &&, size_t) {});
+    CHECK_FALSE(listener.listen(*group));
+    CHECK(listener.port() == 0);
+    CHECK(listener.accepted(0) == 0);
+    CHECK(listener.accepted(5) == 0);
+}
+
+TEST_CASE("Reuse-port listeners accept on every reactor", "[net][sharded_listener]") {
+    auto group = pembroke::reactor().build_group(2);
+    Accepted accepted(group->size());
+    ShardedListener listener("127.0.0.1:0", [&](Connection &&c, size_t shard) {
+        accepted.add(std::move(c), shard);
+    });
+    REQUIRE(listener.listen(*group));
+    CHECK(listener.mode() == AcceptMode::ReusePort);
+    REQUIRE(listener.port() != 0);
+    REQUIRE(group->start());
+
+    /* The kernel hashes each connection to a socket, 64 all landing on one is vanishingly unlikely */
+    connect_and_wait(listener, group->size(), 64);
+    group->stop();
+
+    CHECK(listener.accepted(0) > 0);
+    CHECK(listener.accepted(1) > 0);
+    CHECK(accepted.connections[0].size() == listener.accepted(0));
+    CHECK(accepted.threads[0] != accepted.threads[1]);
+}
+
+TEST_CASE("Sharded listeners start on a running group with accept batches", "[net][sharded_listener]") {
+    auto mode = GENERATE(AcceptMode::ReusePort, AcceptMode::Handoff);
+    auto group = pembroke::reactor().build_group(2);
+    REQUIRE(group->start());
+
+    Accepted accepted(group->size());
+    ShardedListener listener("127.0.0.1:0", [&](Connection &&c, size_t shard) {
+        accepted.add(std::move(c), shard);
+    }, mode);
+    listener.accept_batch(2);
+    REQUIRE(listener.listen(*group));
+
+    connect_and_wait(listener, group->size(), 32);
+    group->stop();
+
+    CHECK(accepted.connections[0].size() + accepted.connections[1].size() == 32);
+}
+
+TEST_CASE("Handoff listeners spread connections round-robin", "[net][sharded_listener]") {
+    auto group = pembroke::reactor().build_group(3);
+    Accepted accepted(group->size());
+    ShardedListener listener("127.0.0.1:0", [&](Connection &&c, size_t shard) {
+        accepted.add(std::move(c), shard);
+    }, AcceptMode::Handoff);
+    REQUIRE(listener.listen(*group));
+    REQUIRE(group->start());
+
+    connect_and_wait(listener, group->size(), 9);
+    group->stop();
+
+    for (size_t shard = 0; shard < group->size(); shard++) {
+        CHECK(listener.accepted(shard) == 3);
+        CHECK(accepted.connections[shard].size() == 3);
+    }
+    CHECK(accepted.threads[1] != accepted.threads[2]);
+}
@@ -0,0 +1,226 @@
+#include "pembroke/net/splice.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+namespace pembroke::net {
+
+    /* Most bytes read per direction at a time, the capacity of a default pipe */
+    static constexpr size_t ChunkSize = 64 * 1024;
+
+    // ---
+    // Construction
+    // ---
+
+    Splice::Splice(Connection &&a, Connection &&b, SpliceCallback on_close, SpliceMode mode) noexcept
+        : m_on_close(std::move(on_close)) {
+        if (!a || !b || bufferevent_get_base(a.m_bev) != bufferevent_get_base(b.m_bev)) {
+            pembroke::logger::warn("Unable to splice closed connections, or connections on different reactors");
+            a.close();
+            b.close();
+            return;
+        }
+        auto *base = bufferevent_get_base(a.m_bev);
+        int priority = bufferevent_get_priority(a.m_bev);
+        if (mode == SpliceMode::ZeroCopy && a.m_reactor != nullptr) {
+            m_pipes = a.m_reactor->pipe_pool();
+        }
+
+        /* Whatever either connection still holds goes out first: b's unwritten output, then
+         * what was read from a and not yet consumed (and the other way around) */
+        Buffer a_input;
+        Buffer b_input;
+        m_fd_a = a.release(a_input, m_b_to_a.buffer);
+        m_fd_b = b.release(b_input, m_a_to_b.buffer);
+        m_a_to_b.buffer.append(std::move(a_input));
+        m_b_to_a.buffer.append(std::move(b_input));
+
+        m_a_to_b.from = m_b_to_a.to = m_fd_a;
+        m_a_to_b.to = m_b_to_a.from = m_fd_b;
+        for (auto *d : {&m_a_to_b, &m_b_to_a}) {
+            d->splice = this;
+            if (m_pipes != nullptr) {
+                d->pipe = m_pipes->acquire();
+                d->zero_copy = static_cast<bool>(d->pipe);
+            }
+            d->read_event = event_new(base, d->from, EV_READ | EV_PERSIST, Splice::ready_cb, d);
+            d->write_event = event_new(base, d->to, EV_WRITE | EV_PERSIST, Splice::ready_cb, d);
+            if (d->read_event == nullptr || d->write_event == nullptr ||
+                event_priority_set(d->read_event, priority) != 0 ||
+                event_priority_set(d->write_event, priority) != 0) {
+                pembroke::logger::warn("Unable to create splice events");
+                close();
+                return;
+            }
+        }
+
+        wait_for(m_a_to_b, m_a_to_b.buffer.length() > 0 ? m_a_to_b.write_event : m_a_to_b.read_event);
+        wait_for(m_b_to_a, m_b_to_a.buffer.length() > 0 ? m_b_to_a.write_event : m_b_to_a.read_event);
+    }
+
+    Splice::~Splice() noexcept {
+        close();
+    }
+
+    // ---
+    // Lifetime
+    // ---
+
+    void Splice::close() noexcept {
+        for (auto *d : {&m_a_to_b, &m_b_to_a}) {
+            if (d->read_event != nullptr) {
+                event_free(d->read_event);
+                d->read_event = nullptr;
+            }
+            if (d->write_event != nullptr) {
+                event_free(d->write_event);
+                d->write_event = nullptr;
+            }
+            d->waiting = nullptr;
+            if (m_pipes != nullptr) {
+                /* Pipes still holding data are closed rather than recycled */
+                m_pipes->release(d->pipe);
+            } else {
+                PipePool::close(d->pipe);
+            }
+            d->in_pipe = 0;
+            d->buffer.drain(d->buffer.length());
+        }
+        for (auto *fd : {&m_fd_a, &m_fd_b}) {
+            if (*fd != -1) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    void Splice::finish(CloseReason reason) noexcept {
+        int error = errno;
+        close();
+        errno = error;
+
+        /* Taken out of the splice first, the callback runs once and may destroy it */
+        auto on_close = std::move(m_on_close);
+        if (on_close) {
+            on_close(*this, reason);
+        }
+    }
+
+    // ---
+    // Moving Data
+    // ---
+
+    void Splice::pump(Direction &d) noexcept {
+        auto &other = &d == &m_a_to_b ? m_b_to_a : m_a_to_b;
+
+        for (size_t moved = 0; moved < MaxBytesPerWakeup;) {
+            while (d.buffer.length() + d.in_pipe > 0) {
+                auto n = write_out(d);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        /* Hold the source back until the destination has room */
+                        wait_for(d, d.write_event);
+                        return;
+                    }
+                    finish(CloseReason::Error);
+                    return;
+                }
+                d.forwarded += static_cast<uint64_t>(n);
+            }
+
+            if (d.eof) {
+                d.done = true;
+                wait_for(d, nullptr);
+                if (shutdown(d.to, SHUT_WR) != 0 && errno != ENOTCONN) {
+                    finish(CloseReason::Error);
+                } else if (other.done) {
+                    finish(CloseReason::Eof);
+                }
+                return;
+            }
+
+            auto n = read_in(d);
+            if (n == 0) {
+                d.eof = true;
+            } else if (n > 0) {
+                moved += static_cast<size_t>(n);
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                wait_for(d, d.read_event);
+                return;
+            } else if (errno == EINVAL && d.zero_copy) {
+                /* The sockets do not support splice, carry on through the buffer */
+                pembroke::logger::info("Splice unsupported between these sockets, falling back to buffered copies");
+                d.zero_copy = false;
+                m_pipes->release(d.pipe);
+            } else if (errno != EINTR) {
+                finish(CloseReason::Error);
+                return;
+            }
+        }
+
+        /* Let the reactor run other events, picking up where this left off next iteration */
+        wait_for(d, d.buffer.length() + d.in_pipe > 0 ? d.write_event : d.read_event);
+    }
+
+    auto Splice::read_in(Direction &d) noexcept -> int64_t {
+        if (!d.zero_copy) {
+            return d.buffer.read_from(d.from, ChunkSize);
+        }
+        auto n = splice(d.from, nullptr, d.pipe.write_fd, nullptr, ChunkSize, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0) {
+            d.in_pipe += static_cast<size_t>(n);
+        }
+        return n;
+    }
+
+    auto Splice::write_out(Direction &d) noexcept -> int64_t {
+        if (d.buffer.length() > 0) {
+            return d.buffer.write_to(d.to);
+        }
+        auto n = splice(d.pipe.read_fd, nullptr, d.to, nullptr, d.in_pipe, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0) {
+            d.in_pipe -= static_cast<size_t>(n);
+        }
+        return n;
+    }
+
+    void Splice::wait_for(Direction &d, ::event *ev) noexcept {
+        if (d.waiting == ev) {
+            return;
+        }
+        if (d.waiting != nullptr) {
+            event_del(d.waiting);
+        }
+        if (ev != nullptr) {
+            event_add(ev, nullptr);
+        }
+        d.waiting = ev;
+    }
+
+    // ---
+    // Callbacks
+    // ---
+
+    void Splice::ready_cb(int /*unused*/, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Splice callback called with null direction");
+        auto *d = static_cast<Direction *>(arg);
+        d->splice->pump(*d);
+    }
+
+} // namespace pembroke::net
@@ -0,0 +1,272 @@
+#include <catch2/catch.hpp>
+
+#include <csignal>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/net/connection.hpp"
+#include "pembroke/net/pipe_pool.hpp"
+#include "pembroke/net/splice.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+extern "C" {
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+using pembroke::net::CloseReason;
+using pembroke::net::Connection;
+using pembroke::net::PipePool;
+using pembroke::net::Splice;
+using pembroke::net::SpliceMode;
+
+/* Read everything available on the non-blocking @p fd into @p into, true at end of file */
+static auto read_available(int fd, std::string &into) -> bool {
+    char buf[4096];
+    for (;;) {
+        auto n = read(fd, buf, sizeof(buf));
+        if (n == 0) {
+            return true;
+        }
+        if (n < 0) {
+            return false;
+        }
+        into.append(buf, static_cast<size_t>(n));
+    }
+}
+
+static void write_all(int fd, const std::string &data) {
+    REQUIRE(write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+}
+
+// ---
+// Pipe Pool
+// ---
+
+TEST_CASE("Reactor has a pipe pool by default", "[net][splice][pipe_pool]") {
+    auto r = pembroke::reactor().build();
+    REQUIRE(r->pipe_pool() != nullptr);
+    CHECK(r->pipe_pool()->capacity() == 32);
+
+    auto disabled = pembroke::reactor().pipe_pool(0).build();
+    CHECK(disabled->pipe_pool() == nullptr);
+}
+
+TEST_CASE("Empty pipes are recycled through the pool", "[net][splice][pipe_pool]") {
+    PipePool pool(1);
+
+    auto first = pool.acquire();
+    REQUIRE(first);
+    int read_fd = first.read_fd;
+    pool.release(first);
+    CHECK_FALSE(first);
+
+    auto again = pool.acquire();
+    CHECK(again.read_fd == read_fd);
+    auto other = pool.acquire();
+    REQUIRE(other);
+
+    /* A pipe still holding data is closed, as is one the pool has no room for */
+    REQUIRE(write(again.write_fd, "x", 1) == 1);
+    pool.release(again);
+    pool.release(other);
+
+    auto stats = pool.stats();
+    CHECK(stats.acquired == 3);
+    CHECK(stats.hits == 1);
+    CHECK(stats.returned == 3);
+    CHECK(stats.discarded == 1);
+    CHECK(stats.retained == 1);
+}
+
+// ---
+// Forwarding
+// ---
+
+TEST_CASE("Splices forward data both ways", "[net][splice]") {
+    auto mode = GENERATE(SpliceMode::ZeroCopy, SpliceMode::Buffered);
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair client;
+    pembroke::SocketPair upstream;
+
+    Splice splice(Connection::adopt(*r, dup(client.left())), Connection::adopt(*r, dup(upstream.left())),
+                  [](Splice &, CloseReason) {}, mode);
+    REQUIRE(splice);
+    CHECK(splice.zero_copy() == (mode == SpliceMode::ZeroCopy));
+
+    std::string received;
+    write_all(client.right(), "request");
+    tick_until(*r, [&] { read_available(upstream.right(), received); return received == "request"; });
+
+    received.clear();
+    const std::string large(1024 * 1024, 'x');
+    size_t sent = 0;
+    tick_until(*r, [&] {
+        if (sent < large.size()) {
+            auto n = write(upstream.right(), large.data() + sent, large.size() - sent);
+            sent += n > 0 ? static_cast<size_t>(n) : 0;
+        }
+        read_available(client.right(), received);
+        return received.size() == large.size();
+    });
+    CHECK(received == large);
+    CHECK(splice.bytes_a_to_b() == 7);
+    CHECK(splice.bytes_b_to_a() == large.size());
+    CHECK(splice.zero_copy() == (mode == SpliceMode::ZeroCopy));
+}
+
+TEST_CASE("Splices forward what the connections had buffered first", "[net][splice]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair client;
+    pembroke::SocketPair upstream;
+
+    /* Read by the connection but not consumed */
+    auto a = Connection::adopt(*r, dup(client.left()));
+    write_all(client.right(), "early ");
+    tick_until(*r, [&] { return a.input().length() == 6; });
+
+    /* Queued on the connection but not yet written */
+    auto b = Connection::adopt(*r, dup(upstream.left()));
+    b.output().add("greeting ");
+
+    Splice splice(std::move(a), std::move(b), [](Splice &, CloseReason) {});
+    REQUIRE(splice);
+    CHECK(r->buffered_bytes() == 0);
+    write_all(client.right(), "late");
+
+    std::string received;
+    tick_until(*r, [&] { read_available(upstream.right(), received); return received.size() == 19; });
+    CHECK(received == "greeting early late");
+}
+
+TEST_CASE("Splices without a pipe pool copy through buffers", "[net][splice]") {
+    auto r = pembroke::reactor().pipe_pool(0).build();
+    pembroke::SocketPair client;
+    pembroke::SocketPair upstream;
+
+    Splice splice(Connection::adopt(*r, dup(client.left())), Connection::adopt(*r, dup(upstream.left())),
+                  [](Splice &, CloseReason) {});
+    REQUIRE(splice);
+    CHECK_FALSE(splice.zero_copy());
+
+    std::string received;
+    write_all(client.right(), "request");
+    tick_until(*r, [&] { read_available(upstream.right(), received); return received == "request"; });
+}
+
+TEST_CASE("Splices fail on closed connections", "[net][splice]") {
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair client;
+
+    Splice splice(Connection::adopt(*r, dup(client.left())), Connection(), [](Splice &, CloseReason) {});
+    CHECK_FALSE(splice);
+    CHECK(splice.bytes_a_to_b() == 0);
+}
+
+// ---
+// Flow Control
+// ---
+
+TEST_CASE("Splices stop reading while the destination is full", "[net][splice][flow_control]") {
+    auto mode = GENERATE(SpliceMode::ZeroCopy, SpliceMode::Buffered);
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair client;
+    pembroke::SocketPair upstream;
+
+    Splice splice(Connection::adopt(*r, dup(client.left())), Connection::adopt(*r, dup(upstream.left())),
+                  [](Splice &, CloseReason) {}, mode);
+    REQUIRE(splice);
+
+    /* Nothing reads the upstream, so once its socket buffers fill the splice stops reading
+     * the client, whose socket buffers fill in turn */
+    const std::string chunk(64 * 1024, 'x');
+    size_t sent = 0;
+    for (int idle = 0; idle < 3;) {
+        auto n = write(client.right(), chunk.data(), chunk.size());
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            idle = 0;
+        } else {
+            idle++;
+        }
+        REQUIRE(r->tick());
+    }
+    auto forwarded = splice.bytes_a_to_b();
+    CHECK(forwarded < sent);
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(r->tick());
+    }
+    CHECK(splice.bytes_a_to_b() == forwarded);
+
+    /* Draining the upstream lets everything through */
+    std::string received;
+    tick_until(*r, [&] { read_available(upstream.right(), received); return received.size() == sent; });
+    CHECK(splice.bytes_a_to_b() == sent);
+}
+
+// ---
+// Closing
+// ---
+
+TEST_CASE("Splices pass half-closes on", "[net][splice]") {
+    auto mode = GENERATE(SpliceMode::ZeroCopy, SpliceMode::Buffered);
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair client;
+    pembroke::SocketPair upstream;
+
+    std::optional<CloseReason> closed;
+    Splice splice(Connection::adopt(*r, dup(client.left())), Connection::adopt(*r, dup(upstream.left())),
+                  [&](Splice &, CloseReason reason) { closed = reason; }, mode);
+    REQUIRE(splice);
+
+    /* The client is done sending, the upstream sees the end once the request is through */
+    write_all(client.right(), "request");
+    REQUIRE(shutdown(client.right(), SHUT_WR) == 0);
+    std::string request;
+    tick_until(*r, [&] { return read_available(upstream.right(), request); });
+    CHECK(request == "request");
+    CHECK_FALSE(closed);
+
+    /* ... and can still respond */
+    write_all(upstream.right(), "response");
+    REQUIRE(shutdown(upstream.right(), SHUT_WR) == 0);
+    std::string response;
+    tick_until(*r, [&] { return closed.has_value(); });
+    CHECK(*closed == CloseReason::Eof);
+    CHECK_FALSE(splice);
+    CHECK(read_available(client.right(), response));
+    CHECK(response == "response");
+
+    /* Both pipes went back to the pool */
+    if (mode == SpliceMode::ZeroCopy) {
+        CHECK(r->pipe_pool()->stats().retained == 2);
+    }
+}
+
+TEST_CASE("Splices report errors and may be destroyed from the close callback", "[net][splice]") {
+    /* Writing to the reset upstream raises SIGPIPE */
+    auto previous = std::signal(SIGPIPE, SIG_IGN);
+    auto r = pembroke::reactor().build();
+    pembroke::SocketPair client;
+    pembroke::SocketPair upstream;
+
+    std::optional<CloseReason> closed;
+    std::unique_ptr<Splice> splice;
+    splice = std::make_unique<Splice>(
+        Connection::adopt(*r, dup(client.left())), Connection::adopt(*r, dup(upstream.right())),
+        [&](Splice &, CloseReason reason) {
+            closed = reason;
+            splice.reset();
+        });
+    REQUIRE(*splice);
+
+    upstream.close_left();
+    write_all(client.right(), "request");
+    tick_until(*r, [&] { return closed.has_value(); });
+    CHECK(*closed == CloseReason::Error);
+    CHECK(splice == nullptr);
+    std::signal(SIGPIPE, previous);
+}
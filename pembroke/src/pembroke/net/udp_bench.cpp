@@ -0,0 +1,192 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+#include "pembroke/event.hpp"
+#include "pembroke/reactor.hpp"
+#include "pembroke/net/udp_socket.hpp"
+
+extern "C" {
+#include <event2/event.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+/*
+ * Packets per second through a net::UdpSocket (one recvmmsg per wakeup, one sendmmsg per
+ * loop iteration) against a raw libevent event doing one recvfrom per callback and a
+ * sendto per datagram. Datagrams are sent in bursts small enough to fit the default socket
+ * buffers, so that none are dropped.
+ */
+
+static constexpr int Bursts = 32;
+static constexpr int BurstSize = 64;
+static constexpr int PacketsPerRun = Bursts * BurstSize;
+static constexpr size_t PacketBytes = 64;
+
+/* Captures the reactor's event_base, for the raw receiver */
+class BaseCapture final : public pembroke::Event {
+public:
+    event_base *base = nullptr;
+
+    auto register_event(event_base &b) noexcept -> bool override {
+        base = &b;
+        return true;
+    }
+};
+
+static auto loopback(uint16_t port) -> sockaddr_in {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return addr;
+}
+
+static auto bound_socket() -> int {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    REQUIRE(fd != -1);
+    auto addr = loopback(0);
+    REQUIRE(bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+static auto port_of(int fd) -> uint16_t {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    REQUIRE(getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len) == 0);
+    return ntohs(addr.sin_port);
+}
+
+/* Sends bursts of datagrams with a single sendmmsg each */
+struct Blaster {
+    int fd;
+    std::vector<char> payload = std::vector<char>(PacketBytes, 'x');
+    std::vector<iovec> iov;
+    std::vector<mmsghdr> msgs;
+    sockaddr_in to{};
+
+    Blaster(int fd, uint16_t port) : fd(fd), iov(BurstSize), msgs(BurstSize), to(loopback(port)) {
+        for (size_t i = 0; i < msgs.size(); i++) {
+            iov[i] = iovec{payload.data(), payload.size()};
+            msgs[i] = mmsghdr{};
+            msgs[i].msg_hdr.msg_name = &to;
+            msgs[i].msg_hdr.msg_namelen = sizeof(to);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    void burst() {
+        REQUIRE(sendmmsg(fd, msgs.data(), BurstSize, 0) == BurstSize);
+    }
+};
+
+// ---
+// Raw libevent receiver
+// ---
+
+static void raw_read_cb(int fd, short /*unused*/, void *arg) {
+    char buf[2048];
+    if (recvfrom(fd, buf, sizeof(buf), 0, nullptr, nullptr) > 0) {
+        (*static_cast<int *>(arg))++;
+    }
+}
+
+/* Drain a sink socket, returning the number of datagrams received */
+static auto drain(int fd) -> int {
+    char buf[2048];
+    int n = 0;
+    while (recv(fd, buf, sizeof(buf), 0) > 0) {
+        n++;
+    }
+    return n;
+}
+
+TEST_CASE("UDP receive: recvmmsg batches vs one recvfrom per event", "[net][udp][benchmark]") {
+    auto r = pembroke::reactor().build();
+    BaseCapture capture;
+    REQUIRE(r->register_event(capture));
+
+    int received = 0;
+    pembroke::net::UdpSocket socket("127.0.0.1:0", [&](auto &, const pembroke::net::DatagramBatch &batch) {
+        received += static_cast<int>(batch.size());
+    });
+    REQUIRE(r->register_event(socket));
+
+    int raw_fd = bound_socket();
+    int raw_received = 0;
+    auto *raw = event_new(capture.base, raw_fd, EV_READ | EV_PERSIST, raw_read_cb, &raw_received);
+    REQUIRE(event_add(raw, nullptr) == 0);
+
+    int client = bound_socket();
+    Blaster to_pembroke(client, socket.port());
+    Blaster to_raw(client, port_of(raw_fd));
+
+    BENCHMARK("pembroke: " + std::to_string(PacketsPerRun) + " datagrams") {
+        received = 0;
+        for (int b = 1; b <= Bursts; b++) {
+            to_pembroke.burst();
+            while (received < b * BurstSize) {
+                REQUIRE(r->tick());
+            }
+        }
+        return received;
+    };
+
+    BENCHMARK("libevent: " + std::to_string(PacketsPerRun) + " datagrams") {
+        raw_received = 0;
+        for (int b = 1; b <= Bursts; b++) {
+            to_raw.burst();
+            while (raw_received < b * BurstSize) {
+                REQUIRE(r->tick());
+            }
+        }
+        return raw_received;
+    };
+
+    event_free(raw);
+    ::close(raw_fd);
+    ::close(client);
+}
+
+TEST_CASE("UDP send: sendmmsg batches vs one sendto per datagram", "[net][udp][benchmark]") {
+    auto r = pembroke::reactor().build();
+
+    pembroke::net::UdpSocket socket("127.0.0.1:0", [](auto &, const auto &) {});
+    REQUIRE(r->register_event(socket));
+
+    int sink = bound_socket();
+    auto to = loopback(port_of(sink));
+    auto *peer = reinterpret_cast<const sockaddr *>(&to);
+    const std::string payload(PacketBytes, 'x');
+    int raw_fd = bound_socket();
+
+    BENCHMARK("pembroke: " + std::to_string(PacketsPerRun) + " datagrams") {
+        int sent = 0;
+        for (int b = 0; b < Bursts; b++) {
+            for (int i = 0; i < BurstSize; i++) {
+                socket.send(payload, peer, sizeof(to));
+            }
+            REQUIRE(r->tick());
+            sent += drain(sink);
+        }
+        return sent;
+    };
+
+    BENCHMARK("sendto: " + std::to_string(PacketsPerRun) + " datagrams") {
+        int sent = 0;
+        for (int b = 0; b < Bursts; b++) {
+            for (int i = 0; i < BurstSize; i++) {
+                sendto(raw_fd, payload.data(), payload.size(), 0, peer, sizeof(to));
+            }
+            sent += drain(sink);
+        }
+        return sent;
+    };
+
+    ::close(raw_fd);
+    ::close(sink);
+}
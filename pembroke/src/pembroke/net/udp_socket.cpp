@@ -0,0 +1,382 @@
+#include "pembroke/net/udp_socket.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <event2/event.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+}
+
+namespace pembroke::internal {
+
+    /* The largest UDP payload (over IPv4) */
+    static constexpr size_t MaxDatagram = 65507;
+    /* The most segments the kernel accepts in a single GSO send */
+    static constexpr size_t MaxSegments = 64;
+
+    /* Everything a socket needs to receive and send a batch, allocated once at
+     * registration: a slot of max_datagram bytes per datagram, and the headers pointing
+     * at them */
+    struct UdpSlabs {
+        size_t capacity;
+        size_t slot;
+
+        std::vector<std::byte> in_data;
+        std::vector<sockaddr_storage> in_peers;
+        std::vector<iovec> in_iov;
+        std::vector<mmsghdr> in_msgs;
+        std::vector<net::Datagram> datagrams;
+
+        /* Queued datagrams, always starting at the first slot */
+        std::vector<std::byte> out_data;
+        std::vector<uint32_t> out_len;
+        std::vector<sockaddr_storage> out_peers;
+        std::vector<socklen_t> out_peer_len;
+        size_t out_count = 0;
+
+        /* Built by each flush, one message per datagram (or per GSO run of datagrams) */
+        std::vector<iovec> out_iov;
+        std::vector<mmsghdr> out_msgs;
+        std::vector<size_t> out_msg_datagrams;
+        std::vector<char> out_cmsg;
+
+        UdpSlabs(size_t n, size_t slot_size)
+            : capacity(n), slot(slot_size),
+              in_data(n * slot_size), in_peers(n), in_iov(n), in_msgs(n), datagrams(n),
+              out_data(n * slot_size), out_len(n), out_peers(n), out_peer_len(n),
+              out_iov(n), out_msgs(n), out_msg_datagrams(n), out_cmsg(n * CMSG_SPACE(sizeof(uint16_t))) {
+            for (size_t i = 0; i < n; i++) {
+                in_iov[i] = iovec{&in_data[i * slot], slot};
+                auto &hdr = in_msgs[i].msg_hdr;
+                hdr = msghdr{};
+                hdr.msg_name = &in_peers[i];
+                hdr.msg_iov = &in_iov[i];
+                hdr.msg_iovlen = 1;
+            }
+        }
+
+        auto out_slot(size_t i) noexcept -> std::byte * {
+            return &out_data[i * slot];
+        }
+
+        auto same_peer(size_t a, size_t b) const noexcept -> bool {
+            return out_peer_len[a] == out_peer_len[b] &&
+                   std::memcmp(&out_peers[a], &out_peers[b], out_peer_len[a]) == 0;
+        }
+
+        /* The number of queued datagrams from @p first that can be sent as one GSO message:
+         * same peer, every segment the size of the first but the last (which may be shorter) */
+        auto gso_run(size_t first) const noexcept -> size_t {
+            size_t segment = out_len[first];
+            size_t total = segment;
+            size_t end = first + 1;
+            if (segment == 0) {
+                return 1;
+            }
+            while (end < out_count && end - first < MaxSegments && out_len[end - 1] == segment &&
+                   out_len[end] <= segment && out_len[end] > 0 && total + out_len[end] <= MaxDatagram &&
+                   same_peer(first, end)) {
+                total += out_len[end];
+                end++;
+            }
+            return end - first;
+        }
+
+        /* Fill out_msgs for the queued datagrams, returning the number of messages */
+        auto build_messages(bool gso) noexcept -> size_t {
+            size_t msgs = 0;
+            for (size_t i = 0; i < out_count;) {
+                size_t run = 1;
+#ifdef UDP_SEGMENT
+                if (gso) {
+                    run = gso_run(i);
+                }
+#else
+                (void)gso;
+#endif
+                auto &hdr = out_msgs[msgs].msg_hdr;
+                hdr = msghdr{};
+                hdr.msg_name = &out_peers[i];
+                hdr.msg_namelen = out_peer_len[i];
+                hdr.msg_iov = &out_iov[i];
+                hdr.msg_iovlen = run;
+                for (size_t j = i; j < i + run; j++) {
+                    out_iov[j] = iovec{out_slot(j), out_len[j]};
+                }
+#ifdef UDP_SEGMENT
+                if (run > 1) {
+                    hdr.msg_control = &out_cmsg[msgs * CMSG_SPACE(sizeof(uint16_t))];
+                    hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+                    auto *cmsg = CMSG_FIRSTHDR(&hdr);
+                    cmsg->cmsg_level = SOL_UDP;
+                    cmsg->cmsg_type = UDP_SEGMENT;
+                    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                    auto segment = static_cast<uint16_t>(out_len[i]);
+                    std::memcpy(CMSG_DATA(cmsg), &segment, sizeof(segment));
+                }
+#endif
+                out_msg_datagrams[msgs++] = run;
+                i += run;
+            }
+            return msgs;
+        }
+
+        /* Drop the first @p n queued datagrams, moving the rest to the front */
+        void consume(size_t n) noexcept {
+            size_t rest = out_count - n;
+            if (rest > 0) {
+                std::memmove(out_slot(0), out_slot(n), rest * slot);
+                std::move(out_len.begin() + n, out_len.begin() + out_count, out_len.begin());
+                std::move(out_peers.begin() + n, out_peers.begin() + out_count, out_peers.begin());
+                std::move(out_peer_len.begin() + n, out_peer_len.begin() + out_count, out_peer_len.begin());
+            }
+            out_count = rest;
+        }
+    };
+
+} // namespace pembroke::internal
+
+namespace pembroke::net {
+
+    using internal::MaxDatagram;
+
+    // ---
+    // Construction
+    // ---
+
+    UdpSocket::UdpSocket(std::string address, DatagramCallback on_datagrams) noexcept
+        : m_address(std::move(address)), m_on_datagrams(std::move(on_datagrams)) {}
+
+    UdpSocket::~UdpSocket() {
+        close();
+    }
+
+    auto UdpSocket::batch_size(size_t n) -> UdpSocket & {
+        if (n == 0) {
+            throw ConfigurationException("UDP batch size must be at least 1");
+        }
+        m_batch_size = n;
+        return *this;
+    }
+
+    auto UdpSocket::max_datagram(size_t bytes) -> UdpSocket & {
+        if (bytes == 0 || bytes > MaxDatagram) {
+            throw ConfigurationException("UDP datagram size must be between 1 and 65507 bytes");
+        }
+        m_max_datagram = bytes;
+        return *this;
+    }
+
+    auto UdpSocket::gso(bool val) noexcept -> UdpSocket & {
+        m_gso = val;
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto UdpSocket::register_event(event_base &base) noexcept -> bool {
+        if (m_fd != -1) {
+            pembroke::logger::error("Attempting to register a UDP socket twice");
+            return false;
+        }
+
+        sockaddr_storage addr{};
+        socklen_t len = 0;
+        if (!internal::parse_address(m_address, addr, len)) {
+            pembroke::logger::warn(fmt::format("Unable to parse UDP address {}", m_address));
+            return false;
+        }
+        m_fd = socket(addr.ss_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_fd == -1 || bind(m_fd, reinterpret_cast<sockaddr *>(&addr), len) != 0) {
+            pembroke::logger::warn(fmt::format("Unable to bind UDP socket to {}: {}", m_address, std::strerror(errno)));
+            close();
+            return false;
+        }
+
+        m_slabs = std::make_unique<internal::UdpSlabs>(m_batch_size, m_max_datagram);
+        m_read_event = event_new(&base, m_fd, EV_READ | EV_PERSIST, UdpSocket::read_cb, this);
+        m_flush_event = event_new(&base, m_fd, EV_WRITE, UdpSocket::flush_cb, this);
+        if (m_read_event == nullptr || m_flush_event == nullptr ||
+            !apply_priority(m_read_event) || !apply_priority(m_flush_event) ||
+            event_add(m_read_event, nullptr) != 0) {
+            pembroke::logger::warn("Unable to create UDP socket events");
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // ---
+    // Sending
+    // ---
+
+    auto UdpSocket::send(std::string_view data, const sockaddr *to, uint32_t to_len) noexcept -> bool {
+        if (m_slabs == nullptr || data.size() > m_max_datagram || to_len > sizeof(sockaddr_storage)) {
+            return false;
+        }
+        auto &s = *m_slabs;
+        if (s.out_count == s.capacity) {
+            (void)flush();
+            if (s.out_count == s.capacity) {
+                return false;
+            }
+        }
+
+        size_t i = s.out_count;
+        std::memcpy(s.out_slot(i), data.data(), data.size());
+        s.out_len[i] = static_cast<uint32_t>(data.size());
+        std::memcpy(&s.out_peers[i], to, to_len);
+        s.out_peer_len[i] = to_len;
+        if (s.out_count++ == 0) {
+            event_active(m_flush_event, EV_WRITE, 0);
+        }
+        return true;
+    }
+
+    auto UdpSocket::send(std::string_view data, const std::string &address) noexcept -> bool {
+        sockaddr_storage addr{};
+        socklen_t len = 0;
+        if (!internal::parse_address(address, addr, len)) {
+            pembroke::logger::warn(fmt::format("Unable to parse UDP address {}", address));
+            return false;
+        }
+        return send(data, reinterpret_cast<const sockaddr *>(&addr), len);
+    }
+
+    auto UdpSocket::flush() noexcept -> int {
+        if (m_slabs == nullptr) {
+            errno = EBADF;
+            return -1;
+        }
+        auto &s = *m_slabs;
+        bool gso = m_gso;
+        int error = 0;
+
+        while (s.out_count > 0) {
+            auto msgs = s.build_messages(gso);
+            int sent = sendmmsg(m_fd, s.out_msgs.data(), static_cast<unsigned>(msgs), MSG_DONTWAIT);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (gso && s.out_msg_datagrams[0] > 1) {
+                    /* No GSO support at all (EIO) turns it off for good, anything else (a
+                     * segment above the path MTU) only for this flush */
+                    if (errno == EIO) {
+                        m_gso = false;
+                    }
+                    gso = false;
+                    continue;
+                }
+                error = errno;
+                pembroke::logger::warn(fmt::format("Unable to send UDP datagram: {}", std::strerror(error)));
+                s.consume(s.out_msg_datagrams[0]);
+                continue;
+            }
+
+            size_t done = 0;
+            for (size_t m = 0; m < static_cast<size_t>(sent); m++) {
+                done += s.out_msg_datagrams[m];
+            }
+            s.consume(done);
+        }
+
+        if (error != 0) {
+            errno = error;
+            return -1;
+        }
+        return static_cast<int>(s.out_count);
+    }
+
+    auto UdpSocket::queued() const noexcept -> size_t {
+        return m_slabs == nullptr ? 0 : m_slabs->out_count;
+    }
+
+    // ---
+    // Lifetime
+    // ---
+
+    auto UdpSocket::port() const noexcept -> uint16_t {
+        sockaddr_storage addr{};
+        socklen_t len = sizeof(addr);
+        if (m_fd == -1 || getsockname(m_fd, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+            return 0;
+        }
+        return internal::port_of(addr);
+    }
+
+    void UdpSocket::close() noexcept {
+        if (m_read_event != nullptr) {
+            event_free(m_read_event);
+            m_read_event = nullptr;
+        }
+        if (m_flush_event != nullptr) {
+            event_free(m_flush_event);
+            m_flush_event = nullptr;
+        }
+        if (m_fd != -1) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        m_slabs.reset();
+    }
+
+    // ---
+    // Callbacks
+    // ---
+
+    void UdpSocket::read_cb(int fd, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "UDP socket read callback called with null socket");
+        auto *self = static_cast<UdpSocket *>(arg);
+        auto &s = *self->m_slabs;
+
+        for (auto &msg : s.in_msgs) {
+            msg.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        }
+        int n = recvmmsg(fd, s.in_msgs.data(), static_cast<unsigned>(s.capacity), MSG_DONTWAIT, nullptr);
+        if (n <= 0) {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                pembroke::logger::warn(fmt::format("Unable to receive UDP datagrams: {}", std::strerror(errno)));
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < static_cast<size_t>(n); i++) {
+            const auto &msg = s.in_msgs[i];
+            s.datagrams[i] = Datagram{
+                ByteSlice{&s.in_data[i * s.slot], std::min<size_t>(msg.msg_len, s.slot)},
+                reinterpret_cast<const sockaddr *>(&s.in_peers[i]),
+                msg.msg_hdr.msg_namelen,
+                (msg.msg_hdr.msg_flags & MSG_TRUNC) != 0,
+            };
+        }
+        self->run_callback(self->m_on_datagrams, CallbackKind::Io, *self,
+                           DatagramBatch{s.datagrams.data(), static_cast<size_t>(n)});
+    }
+
+    void UdpSocket::flush_cb(int /*unused*/, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "UDP socket flush callback called with null socket");
+        auto *self = static_cast<UdpSocket *>(arg);
+        (void)self->flush();
+        if (self->queued() > 0) {
+            /* The send buffer is full (even if a datagram was dropped first), try again
+             * once it has room */
+            event_add(self->m_flush_event, nullptr);
+        }
+    }
+
+} // namespace pembroke::net
@@ -0,0 +1,259 @@
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/net/udp_socket.hpp"
+#include "pembroke/internal/test_common.hpp"
+
+extern "C" {
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+}
+
+using pembroke::net::DatagramBatch;
+using pembroke::net::UdpSocket;
+
+static auto address_of(const UdpSocket &s) -> std::string {
+    return "127.0.0.1:" + std::to_string(s.port());
+}
+
+static auto port_of(const sockaddr *addr) -> uint16_t {
+    return ntohs(reinterpret_cast<const sockaddr_in *>(addr)->sin_port);
+}
+
+/* Datagrams received by a socket, copied out of the batches */
+struct Received {
+    std::vector<std::string> datagrams;
+    std::vector<size_t> batches;
+    std::vector<uint16_t> peers;
+    size_t truncated = 0;
+
+    auto callback() {
+        return [this](UdpSocket &, const DatagramBatch &batch) {
+            batches.push_back(batch.size());
+            for (const auto &d : batch) {
+                datagrams.emplace_back(d.str());
+                peers.push_back(port_of(d.peer));
+                truncated += d.truncated ? 1 : 0;
+            }
+        };
+    }
+};
+
+// ---
+// Registration
+// ---
+
+TEST_CASE("UDP sockets fail to register on bad addresses", "[net][udp][registration]") {
+    auto r = pembroke::reactor().build();
+
+    UdpSocket unparsable("not an address", [](auto &, const auto &) {});
+    CHECK_FALSE(r->register_event(unparsable));
+    CHECK(unparsable.fd() == -1);
+    CHECK(unparsable.port() == 0);
+    CHECK_FALSE(unparsable.send("hello", "127.0.0.1:9"));
+
+    UdpSocket first("127.0.0.1:0", [](auto &, const auto &) {});
+    REQUIRE(r->register_event(first));
+    CHECK(first.port() != 0);
+    CHECK_FALSE(r->register_event(first));
+
+    UdpSocket second(address_of(first), [](auto &, const auto &) {});
+    CHECK_FALSE(r->register_event(second));
+
+    first.close();
+    CHECK(first.fd() == -1);
+    CHECK(first.port() == 0);
+}
+
+TEST_CASE("UDP socket options are validated", "[net][udp][registration]") {
+    UdpSocket s("127.0.0.1:0", [](auto &, const auto &) {});
+    CHECK_THROWS_AS(s.batch_size(0), pembroke::ConfigurationException);
+    CHECK_THROWS_AS(s.max_datagram(0), pembroke::ConfigurationException);
+    CHECK_THROWS_AS(s.max_datagram(65508), pembroke::ConfigurationException);
+    CHECK_NOTHROW(s.batch_size(1).max_datagram(65507));
+}
+
+// ---
+// Receiving and sending
+// ---
+
+TEST_CASE("UDP sockets exchange datagrams", "[net][udp]") {
+    auto r = pembroke::reactor().build();
+
+    Received received;
+    UdpSocket server("127.0.0.1:0", [&](UdpSocket &s, const DatagramBatch &batch) {
+        for (const auto &d : batch) {
+            CHECK(s.send("re: " + std::string(d.str()), d.peer, d.peer_len));
+        }
+    });
+    UdpSocket client("127.0.0.1:0", received.callback());
+    REQUIRE(r->register_event(server));
+    REQUIRE(r->register_event(client));
+
+    CHECK(client.send("hello", address_of(server)));
+    CHECK(client.send("world", address_of(server)));
+    CHECK(client.queued() == 2);
+    tick_until(*r, [&] { return received.datagrams.size() == 2; });
+
+    CHECK(client.queued() == 0);
+    CHECK(received.datagrams == std::vector<std::string>{"re: hello", "re: world"});
+    CHECK(received.peers == std::vector<uint16_t>{server.port(), server.port()});
+    CHECK(received.truncated == 0);
+}
+
+TEST_CASE("UDP sockets receive at most a batch per wakeup", "[net][udp]") {
+    auto r = pembroke::reactor().build();
+
+    Received received;
+    UdpSocket server("127.0.0.1:0", received.callback());
+    server.batch_size(8);
+    REQUIRE(r->register_event(server));
+
+    /* Queued by the kernel before the reactor runs */
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    REQUIRE(fd != -1);
+    sockaddr_in to{};
+    to.sin_family = AF_INET;
+    to.sin_port = htons(server.port());
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 20; i++) {
+        auto msg = std::to_string(i);
+        REQUIRE(sendto(fd, msg.data(), msg.size(), 0, reinterpret_cast<sockaddr *>(&to), sizeof(to)) ==
+                static_cast<ssize_t>(msg.size()));
+    }
+    ::close(fd);
+
+    tick_until(*r, [&] { return received.datagrams.size() == 20; });
+    CHECK(received.batches.front() == 8);
+    for (auto n : received.batches) {
+        CHECK(n <= 8);
+    }
+    for (int i = 0; i < 20; i++) {
+        CHECK(received.datagrams[i] == std::to_string(i));
+    }
+}
+
+TEST_CASE("UDP sockets send runs of equal datagrams as separate datagrams", "[net][udp]") {
+    auto r = pembroke::reactor().build();
+    bool gso = GENERATE(true, false);
+
+    Received received;
+    UdpSocket server("127.0.0.1:0", received.callback());
+    UdpSocket client("127.0.0.1:0", [](auto &, const auto &) {});
+    client.gso(gso);
+    REQUIRE(r->register_event(server));
+    REQUIRE(r->register_event(client));
+
+    /* 10 of the same size, a shorter one to end the run, then another peer's size */
+    std::vector<std::string> sent;
+    for (int i = 0; i < 10; i++) {
+        sent.emplace_back(100, static_cast<char>('a' + i));
+    }
+    sent.emplace_back(40, 'z');
+    sent.emplace_back(200, 'y');
+    for (const auto &msg : sent) {
+        REQUIRE(client.send(msg, address_of(server)));
+    }
+    CHECK(client.flush() == 0);
+
+    tick_until(*r, [&] { return received.datagrams.size() == sent.size(); });
+    CHECK(received.datagrams == sent);
+}
+
+TEST_CASE("UDP sockets limit datagram sizes", "[net][udp]") {
+    auto r = pembroke::reactor().build();
+
+    Received received;
+    UdpSocket server("127.0.0.1:0", received.callback());
+    server.max_datagram(16);
+    UdpSocket client("127.0.0.1:0", [](auto &, const auto &) {});
+    client.max_datagram(32);
+    REQUIRE(r->register_event(server));
+    REQUIRE(r->register_event(client));
+
+    CHECK_FALSE(client.send(std::string(33, 'x'), address_of(server)));
+    CHECK(client.queued() == 0);
+
+    CHECK(client.send(std::string(32, 'x'), address_of(server)));
+    tick_until(*r, [&] { return received.datagrams.size() == 1; });
+    CHECK(received.datagrams.front() == std::string(16, 'x'));
+    CHECK(received.truncated == 1);
+}
+
+TEST_CASE("UDP sockets flush when the queue is full", "[net][udp]") {
+    auto r = pembroke::reactor().build();
+
+    Received received;
+    UdpSocket server("127.0.0.1:0", received.callback());
+    UdpSocket client("127.0.0.1:0", [](auto &, const auto &) {});
+    client.batch_size(4);
+    REQUIRE(r->register_event(server));
+    REQUIRE(r->register_event(client));
+
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(client.send(std::to_string(i), address_of(server)));
+    }
+    CHECK(client.queued() == 2);
+
+    tick_until(*r, [&] { return received.datagrams.size() == 10; });
+    CHECK(client.queued() == 0);
+}
+
+TEST_CASE("UDP sockets keep flushing after dropping a datagram", "[net][udp]") {
+    auto r = pembroke::reactor().build();
+    UdpSocket client("127.0.0.1:0", [](auto &, const auto &) {});
+    client.gso(false);
+    REQUIRE(r->register_event(client));
+
+    /* Swap the socket for a local datagram socket with a tiny send buffer, sending to a
+     * receiver that is not read yet (so the buffer fills) and a peer that does not exist
+     * (so sending to it fails outright) */
+    auto abstract = [](const std::string &name, sockaddr_un &addr) {
+        addr = sockaddr_un{};
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path + 1, name.data(), name.size());
+        return static_cast<uint32_t>(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+    };
+    sockaddr_un receiver_addr{};
+    sockaddr_un missing_addr{};
+    auto name = "pembroke-udp-test-" + std::to_string(getpid());
+    auto receiver_len = abstract(name, receiver_addr);
+    auto missing_len = abstract(name + "-missing", missing_addr);
+
+    int receiver = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    REQUIRE(bind(receiver, reinterpret_cast<sockaddr *>(&receiver_addr), receiver_len) == 0);
+    int local = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    int sndbuf = 4096;
+    REQUIRE(setsockopt(local, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) == 0);
+    REQUIRE(dup2(local, client.fd()) == client.fd());
+    close(local);
+
+    const std::string payload(1024, 'x');
+    REQUIRE(client.send(payload, reinterpret_cast<sockaddr *>(&missing_addr), missing_len));
+    for (int i = 0; i < 32; i++) {
+        REQUIRE(client.send(payload, reinterpret_cast<sockaddr *>(&receiver_addr), receiver_len));
+    }
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(r->tick());
+    }
+    REQUIRE(client.queued() > 0);
+
+    size_t received = 0;
+    char buf[2048];
+    tick_until(*r, [&] {
+        while (recv(receiver, buf, sizeof(buf), 0) > 0) {
+            received++;
+        }
+        return received == 32;
+    });
+    CHECK(client.queued() == 0);
+    close(receiver);
+}
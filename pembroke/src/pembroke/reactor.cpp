@@ -1,10 +1,22 @@
 #include "pembroke/reactor.hpp"
+#include "pembroke/reactor_group.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/task_queue.hpp"
 #include "pembroke/internal/util.hpp"
+#include "pembroke/net/pipe_pool.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
 
 extern "C" {
 #include <event2/event.h>
+#include <event2/thread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 }
 
 namespace pembroke {
@@ -14,6 +26,13 @@ namespace pembroke {
 
     constexpr int LOOP_BREAK_SUCCESS = 0;
 
+    /* libevent's limit on the number of distinct common timeouts per event_base */
+    constexpr size_t MAX_COMMON_TIMEOUTS = 256;
+
+    /* libevent supports strictly fewer than EVENT_MAX_PRIORITIES priority queues, and one
+     * of them is reserved for tick_fast() */
+    constexpr int MAX_PRIORITIES = EVENT_MAX_PRIORITIES - 2;
+
     // ---
     // REACTOR CONFIGURATION / BUILDER CODE
     // ---
@@ -42,15 +61,177 @@ namespace pembroke {
         return *this;
     }
 
+    auto ReactorBuilder::thread_safe(bool val) noexcept -> ReactorBuilder & {
+        m_thread_safe = val;
+        return *this;
+    }
+
+    auto ReactorBuilder::task_queue_capacity(size_t capacity) noexcept -> ReactorBuilder & {
+        m_task_queue_capacity = capacity;
+        return *this;
+    }
+
+    auto ReactorBuilder::timing_wheel(duration resolution) noexcept -> ReactorBuilder & {
+        m_timing_wheel_resolution = resolution;
+        return *this;
+    }
+
+    auto ReactorBuilder::file_segment_cache(size_t entries) noexcept -> ReactorBuilder & {
+        m_file_segment_cache = entries;
+        return *this;
+    }
+
+    auto ReactorBuilder::buffer_pool(size_t capacity) noexcept -> ReactorBuilder & {
+        m_buffer_pool = capacity;
+        return *this;
+    }
+
+    auto ReactorBuilder::pipe_pool(size_t capacity) noexcept -> ReactorBuilder & {
+        m_pipe_pool = capacity;
+        return *this;
+    }
+
+    auto ReactorBuilder::common_timeout(duration timeout) -> ReactorBuilder & {
+        if (std::find(m_common_timeouts.begin(), m_common_timeouts.end(), timeout) == m_common_timeouts.end()) {
+            m_common_timeouts.push_back(timeout);
+        }
+        return *this;
+    }
+
+    auto ReactorBuilder::instrument(bool val) noexcept -> ReactorBuilder & {
+        m_instrument = val;
+        return *this;
+    }
+
+    auto ReactorBuilder::max_dispatch_interval(duration interval) noexcept -> ReactorBuilder & {
+        m_max_dispatch_interval = interval;
+        return *this;
+    }
+
+    auto ReactorBuilder::max_dispatch_callbacks(int n) noexcept -> ReactorBuilder & {
+        m_max_dispatch_callbacks = n;
+        return *this;
+    }
+
+    auto ReactorBuilder::dispatch_limit_priority(int priority) noexcept -> ReactorBuilder & {
+        m_dispatch_limit_priority = priority;
+        return *this;
+    }
+
+    auto ReactorBuilder::precise_timer(bool val) noexcept -> ReactorBuilder & {
+        m_precise_timer = val;
+        return *this;
+    }
+
+    auto ReactorBuilder::cache_time(bool val) noexcept -> ReactorBuilder & {
+        m_cache_time = val;
+        return *this;
+    }
+
+    auto ReactorBuilder::epoll_changelist(bool val) noexcept -> ReactorBuilder & {
+        m_epoll_changelist = val;
+        return *this;
+    }
+
+    auto ReactorBuilder::priorities(int n) noexcept -> ReactorBuilder & {
+        m_priorities = n;
+        return *this;
+    }
+
     auto ReactorBuilder::build() const noexcept -> std::unique_ptr<Reactor> {
         return std::make_unique<Reactor>(*this);
     }
 
+    auto ReactorBuilder::build_group(size_t n) const -> std::unique_ptr<ReactorGroup> {
+        if (n == 0) {
+            n = std::max(1U, std::thread::hardware_concurrency());
+        }
+        return std::make_unique<ReactorGroup>(*this, n);
+    }
+
     // ---
     // REACTOR IMPLEMENTATION CODE
     // ---
 
+    /* Validate and apply the builder's dispatch limits (see ReactorBuilder::max_dispatch_interval) */
+    static void configure_dispatch(event_config &config, const ReactorBuilder &builder) {
+        if (builder.m_max_dispatch_interval < no_delay) {
+            throw ConfigurationException("Reactor max dispatch interval must not be negative");
+        }
+        if (builder.m_max_dispatch_callbacks < 0) {
+            throw ConfigurationException("Reactor max dispatch callbacks must not be negative");
+        }
+        int priority = builder.m_dispatch_limit_priority;
+        if (priority < 0) {
+            priority = builder.m_priorities > 1 ? 1 : 0;
+        } else if (priority >= builder.m_priorities) {
+            throw ConfigurationException("Reactor dispatch limit priority must be one of its priorities");
+        }
+
+        bool limit_time = builder.m_max_dispatch_interval > no_delay;
+        bool limit_callbacks = builder.m_max_dispatch_callbacks > 0;
+        if (!limit_time && !limit_callbacks) {
+            return;
+        }
+
+        timeval tv = internal::to_timeval(builder.m_max_dispatch_interval);
+        // reactor priorities below the top are one libevent queue lower (see internal::TickFastQueue)
+        int queue = (builder.m_priorities > 1 && priority >= internal::TickFastQueue) ? priority + 1 : priority;
+        int ret = event_config_set_max_dispatch_interval(
+            &config,
+            limit_time ? &tv : nullptr,
+            limit_callbacks ? builder.m_max_dispatch_callbacks : -1,
+            queue);
+        if (ret != 0) {
+            throw ConfigurationException("Unable to update reactor config dispatch limits");
+        }
+    }
+
+    /* libevent's locking callbacks are process-global and must be installed before the
+     * first event_base that needs them is created, so only ever do this once. */
+    static auto enable_threading() -> bool {
+        static std::once_flag flag;
+        static bool enabled = false;
+        std::call_once(flag, []() -> void {
+            enabled = evthread_use_pthreads() == 0;
+        });
+        return enabled;
+    }
+
+    namespace internal {
+
+        UniqueFd::~UniqueFd() {
+            reset();
+        }
+
+        void UniqueFd::reset(int fd) noexcept {
+            if (m_fd != -1) {
+                close(m_fd);
+            }
+            m_fd = fd;
+        }
+
+    } // namespace internal
+
     Reactor::Reactor(const ReactorBuilder &builder) {
+        if (builder.m_thread_safe && !enable_threading()) {
+            throw ConfigurationException("Unable to enable thread-safety for reactor");
+        }
+        if (builder.m_priorities < 1 || builder.m_priorities > MAX_PRIORITIES) {
+            throw ConfigurationException("Reactor priorities must be between 1 and 254");
+        }
+        if (builder.m_task_queue_capacity == 0) {
+            throw ConfigurationException("Reactor task queue capacity must be non-zero");
+        }
+        if (builder.m_common_timeouts.size() > MAX_COMMON_TIMEOUTS) {
+            throw ConfigurationException("Too many common timeouts declared for reactor");
+        }
+        for (auto timeout : builder.m_common_timeouts) {
+            if (timeout <= no_delay) {
+                throw ConfigurationException("Reactor common timeouts must be positive");
+            }
+        }
+
         auto config = std::unique_ptr<
             event_config,
             decltype(event_config_free) *>(event_config_new(), event_config_free);
@@ -80,19 +261,143 @@ namespace pembroke {
                 throw ConfigurationException("Unable to update reactor config for O(1) trigger support");
             }
         }
-        // TODO: Configure other features/configs
+
+        configure_dispatch(*config, builder);
+
+        int flags = 0;
+        if (builder.m_precise_timer) {
+            flags |= EVENT_BASE_FLAG_PRECISE_TIMER;
+        }
+        if (!builder.m_cache_time) {
+            flags |= EVENT_BASE_FLAG_NO_CACHE_TIME;
+        }
+        if (builder.m_epoll_changelist) {
+            flags |= EVENT_BASE_FLAG_EPOLL_USE_CHANGELIST;
+        }
+        if (flags != 0 && event_config_set_flag(config.get(), flags) != 0) {
+            throw ConfigurationException("Unable to update reactor config flags");
+        }
 
         m_base = reactor_base(event_base_new_with_config(config.get()), event_base_free);
         if (m_base == nullptr) {
             throw ConfigurationException("Unable to construct reactor with current configuration");
         }
+
+        if (builder.m_epoll_changelist && std::string_view(event_base_get_method(m_base.get())) != "epoll") {
+            pembroke::logger::warn(fmt::format(
+                "Reactor epoll changelist requested but backend is {}, ignoring",
+                event_base_get_method(m_base.get())));
+        }
+
+        // priorities must be set up before any events are added to the base
+        m_priorities = builder.m_priorities;
+        if (m_priorities > 1) {
+            // one extra libevent queue for the end of tick_fast() (see internal::TickFastQueue)
+            if (event_base_priority_init(m_base.get(), m_priorities + 1) != 0) {
+                throw ConfigurationException("Unable to initialize reactor priorities");
+            }
+            m_tick_fast_event = event_ptr(event_new(m_base.get(), -1, 0, Reactor::end_tick_cb, this), event_free);
+            if (m_tick_fast_event == nullptr
+                    || event_priority_set(m_tick_fast_event.get(), internal::TickFastQueue) != 0) {
+                throw ConfigurationException("Unable to create reactor priority event");
+            }
+        }
+
+        m_tasks = std::make_unique<internal::TaskQueue>(builder.m_task_queue_capacity);
+        m_wakeup_fd.reset(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+        if (m_wakeup_fd.get() == -1) {
+            throw ConfigurationException("Unable to create reactor wakeup file-descriptor");
+        }
+        m_wakeup_event = event_ptr(
+            event_new(m_base.get(), m_wakeup_fd.get(), EV_READ | EV_PERSIST, Reactor::run_tasks_cb, this),
+            event_free);
+        if (m_wakeup_event == nullptr
+                || !internal::set_priority(m_wakeup_event.get(), Event::DefaultPriority)
+                || event_add(m_wakeup_event.get(), nullptr) != 0) {
+            throw ConfigurationException("Unable to register reactor wakeup event");
+        }
+
+        if (builder.m_instrument) {
+            m_instrumentation = std::make_unique<Instrumentation>();
+            m_stop_event = event_ptr(event_new(m_base.get(), -1, 0, Reactor::stop_cb, this), event_free);
+            if (m_stop_event == nullptr
+                    || !internal::set_priority(m_stop_event.get(), Event::DefaultPriority)) {
+                throw ConfigurationException("Unable to create reactor stop event");
+            }
+        }
+
+        if (builder.m_timing_wheel_resolution > no_delay) {
+            m_timing_wheel = std::make_unique<TimingWheel>(*m_base, builder.m_timing_wheel_resolution);
+        }
+
+        if (builder.m_file_segment_cache > 0) {
+            m_file_segments = std::make_unique<FileSegmentCache>(builder.m_file_segment_cache);
+        }
+
+        if (builder.m_buffer_pool > 0) {
+            m_buffer_pool = std::make_unique<BufferPool>(builder.m_buffer_pool);
+        }
+
+        if (builder.m_pipe_pool > 0) {
+            m_pipe_pool = std::make_unique<net::PipePool>(builder.m_pipe_pool);
+        }
+
+        m_common_timeouts.reserve(builder.m_common_timeouts.size());
+        for (auto timeout : builder.m_common_timeouts) {
+            timeval tv = internal::to_timeval(timeout);
+            const timeval *common = event_base_init_common_timeout(m_base.get(), &tv);
+            if (common == nullptr) {
+                throw ConfigurationException("Unable to initialize common timeout for reactor");
+            }
+            m_common_timeouts.emplace_back(timeout, common);
+        }
+    }
+
+    Reactor::~Reactor() {
+        // The event must be removed from the base before its file-descriptor is closed
+        m_wakeup_event.reset();
+        m_timing_wheel.reset();
     }
 
     auto Reactor::run_blocking() const noexcept -> bool {
-        return event_base_loop(m_base.get(), EVLOOP_NO_EXIT_ON_EMPTY) == LOOP_RAN_SUCCESSFULLY;
+        /* Events on the timing wheel may only be scheduled and cancelled from this thread
+         * while the loop runs (see TimingWheel::set_owner()) */
+        if (m_timing_wheel == nullptr) {
+            return run_loop();
+        }
+        m_timing_wheel->set_owner(std::this_thread::get_id());
+        bool ok = run_loop();
+        m_timing_wheel->set_owner(std::thread::id());
+        return ok;
+    }
+
+    auto Reactor::run_loop() const noexcept -> bool {
+        if (m_instrumentation == nullptr) {
+            return event_base_loop(m_base.get(), EVLOOP_NO_EXIT_ON_EMPTY) == LOOP_RAN_SUCCESSFULLY;
+        }
+
+        /* EVLOOP_ONCE returns once a batch of ready callbacks has run, giving a point to
+         * close each tick. Keep going until the loop is stopped. Every call clears the loop's
+         * break flag, so stop() also activates the stop event, which breaks the next call if
+         * it lands in between. */
+        for (;;) {
+            int ret = event_base_loop(m_base.get(), EVLOOP_ONCE | EVLOOP_NO_EXIT_ON_EMPTY);
+            m_instrumentation->tick_finished();
+            if (ret != LOOP_RAN_SUCCESSFULLY) {
+                return false;
+            }
+            if (event_base_got_break(m_base.get()) != 0 || event_base_got_exit(m_base.get()) != 0) {
+                // the stop (if any) has been honoured, do not carry it over to the next run
+                event_del(m_stop_event.get());
+                return true;
+            }
+        }
     }
 
     auto Reactor::stop() const noexcept -> bool {
+        if (m_stop_event != nullptr) {
+            event_active(m_stop_event.get(), EV_TIMEOUT, 0);
+        }
         return event_base_loopbreak(m_base.get()) == LOOP_BREAK_SUCCESS;
     }
 
@@ -101,24 +406,162 @@ namespace pembroke {
             /* If we know we have active events, pass EVLOOP_ONCE to ensure
              * that we're waiting for current active events to finish and run
              * thier callbacks. */
-            return event_base_loop(m_base.get(), EVLOOP_ONCE) == LOOP_RAN_SUCCESSFULLY;
+            bool ok = event_base_loop(m_base.get(), EVLOOP_ONCE) == LOOP_RAN_SUCCESSFULLY;
+            end_tick();
+            return ok;
         }
         /* If we don't have any active events, still run the loop, but run with
          * EVLOOP_NONBLOCK, which will not block until any events are active. */
         int ret = event_base_loop(m_base.get(), EVLOOP_NONBLOCK);
+        end_tick();
         return (ret == LOOP_RAN_NO_EVENTS) || (ret == LOOP_RAN_SUCCESSFULLY);
     }
 
     auto Reactor::tick_fast() const noexcept -> bool {
-        /* Use EVLOOP_NONBLOCK to only execute callbacks for high-priority,
-         * ready events */
+        /* EVLOOP_NONBLOCK keeps iterating for as long as events are active and libevent runs
+         * one priority queue per iteration, highest first. The end-of-tick event has a queue
+         * of its own just below the top priority, so it runs (and breaks the loop) as soon as
+         * the top priority is empty, ahead of any lower-priority events that are ready. */
+        if (m_tick_fast_event != nullptr) {
+            event_active(m_tick_fast_event.get(), EV_TIMEOUT, 0);
+        }
         int ret = event_base_loop(m_base.get(), EVLOOP_NONBLOCK);
+        if (m_tick_fast_event != nullptr) {
+            // still active if the loop was stopped by a callback first
+            event_del(m_tick_fast_event.get());
+        }
+        end_tick();
         return (ret == LOOP_RAN_SUCCESSFULLY) || (ret == LOOP_RAN_NO_EVENTS);
     }
 
     
     auto Reactor::register_event(pembroke::Event &event) noexcept -> bool {
-        return event.register_event(*m_base);
+        event.m_instrumentation = m_instrumentation.get();
+        return event.register_event(*this);
+    }
+
+    auto Reactor::register_event(pembroke::Event &event, int priority) noexcept -> bool {
+        if (priority < 0 || priority >= m_priorities) {
+            pembroke::logger::warn(fmt::format(
+                "Attempting to register event with priority {} on a reactor with {} priorities",
+                priority, m_priorities));
+            return false;
+        }
+        event.m_priority = priority;
+        return register_event(event);
+    }
+
+    auto Reactor::instrumentation() const noexcept -> Instrumentation * {
+        return m_instrumentation.get();
+    }
+
+    auto Reactor::buffered_bytes() const noexcept -> size_t {
+        return m_buffered_bytes.load(std::memory_order_relaxed);
+    }
+
+    void Reactor::end_tick() const noexcept {
+        if (m_instrumentation != nullptr) {
+            m_instrumentation->tick_finished();
+        }
+    }
+
+    auto Reactor::priorities() const noexcept -> int {
+        return m_priorities;
+    }
+
+    auto Reactor::timing_wheel() noexcept -> TimingWheel * {
+        return m_timing_wheel.get();
+    }
+
+    auto Reactor::file_segments() noexcept -> FileSegmentCache * {
+        return m_file_segments.get();
+    }
+
+    auto Reactor::buffer_pool() noexcept -> BufferPool * {
+        return m_buffer_pool.get();
+    }
+
+    auto Reactor::pipe_pool() noexcept -> net::PipePool * {
+        return m_pipe_pool.get();
+    }
+
+    auto Reactor::common_timeout(duration timeout) const noexcept -> const timeval * {
+        /* Only a handful of durations are ever declared, a linear scan beats hashing */
+        for (const auto &[common, tv] : m_common_timeouts) {
+            if (common == timeout) {
+                return tv;
+            }
+        }
+        return nullptr;
+    }
+
+    // ---
+    // EVENT DEFAULTS (needing access to reactor internals)
+    // ---
+
+    auto Event::register_event(Reactor &reactor) noexcept -> bool {
+        return register_event(*reactor.m_base);
+    }
+
+    auto Event::base_of(Reactor &reactor) noexcept -> event_base & {
+        return *reactor.m_base;
+    }
+
+    auto Event::apply_priority(::event *ev) const noexcept -> bool {
+        return internal::set_priority(ev, m_priority);
+    }
+
+    auto Reactor::post_task(Callback &&task) noexcept -> bool {
+        if (!m_tasks->push(std::move(task))) {
+            return false;
+        }
+
+        /* Only the first post after the reactor has started draining needs to wake it up,
+         * every post after that is coalesced into the same batch. The exchange pairs with
+         * the one in run_tasks_cb() so that a task is never left behind without a wakeup. */
+        if (!m_wakeup_pending.exchange(true, std::memory_order_acq_rel)) {
+            uint64_t one = 1;
+            ssize_t ret = write(m_wakeup_fd.get(), &one, sizeof(one));
+            (void)ret;  // EAGAIN only means the counter is already non-zero, which is fine
+        }
+        return true;
+    }
+
+    auto Reactor::user_event_count() const noexcept -> size_t {
+        int n = event_base_get_num_events(m_base.get(), EVENT_BASE_COUNT_ADDED | EVENT_BASE_COUNT_ACTIVE);
+        /* exclude the (always added) wakeup event */
+        auto count = n < 1 ? size_t{0} : static_cast<size_t>(n - 1);
+        /* count timing-wheel entries in place of the wheel's driving timer */
+        if (m_timing_wheel != nullptr && m_timing_wheel->size() > 0) {
+            count += m_timing_wheel->size() - 1;
+        }
+        return count;
+    }
+
+    void Reactor::end_tick_cb(int /*unused*/, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Reactor tick callback called with null reactor");
+        auto *self = static_cast<Reactor *>(arg);
+        event_base_loopbreak(self->m_base.get());
+    }
+
+    void Reactor::stop_cb(int /*unused*/, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Reactor stop callback called with null reactor");
+        auto *self = static_cast<Reactor *>(arg);
+        event_base_loopbreak(self->m_base.get());
+    }
+
+    void Reactor::run_tasks_cb(int fd, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Reactor task callback called with null reactor");
+        auto *self = static_cast<Reactor *>(arg);
+
+        uint64_t count = 0;
+        ssize_t ret = read(fd, &count, sizeof(count));
+        (void)ret;
+
+        /* Re-open the wakeup window before draining. Anything posted from here on will
+         * either be picked up by this drain or trigger a new wakeup. */
+        self->m_wakeup_pending.exchange(false, std::memory_order_acq_rel);
+        self->m_tasks->drain(self->m_tasks->capacity(), self->m_instrumentation.get());
     }
 
 
@@ -0,0 +1,125 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pembroke/instrumentation.hpp"
+#include "pembroke/reactor.hpp"
+#include "pembroke/event/delayed.hpp"
+#include "pembroke/event/timer.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke::event;
+
+/*
+ * Cost of handing a task to a running reactor with Reactor::post(). The reactor
+ * runs on its own thread and drains as fast as it can while the benchmark thread
+ * produces.
+ */
+
+static constexpr int TasksPerRun = 100000;
+
+TEST_CASE("Reactor::post throughput", "[reactor][post][benchmark]") {
+    auto r = pembroke::reactor().task_queue_capacity(1U << 16U).build();
+    std::atomic<bool> running{true};
+    std::atomic<int> ran{0};
+
+    std::thread loop([&]() -> void {
+        while (running.load()) {
+            (void)r->run_blocking();
+        }
+    });
+
+    BENCHMARK_ADVANCED("post (single producer)")(Catch::Benchmark::Chronometer meter) {
+        ran = 0;
+        meter.measure([&]() -> bool {
+            return r->post([&ran]() -> void { ran.fetch_add(1, std::memory_order_relaxed); });
+        });
+    };
+
+    BENCHMARK("post + drain, 100k tasks") {
+        ran = 0;
+        for (int i = 0; i < TasksPerRun; i++) {
+            while (!r->post([&ran]() -> void { ran.fetch_add(1, std::memory_order_relaxed); })) {
+                std::this_thread::yield();
+            }
+        }
+        while (ran.load() < TasksPerRun) {
+            std::this_thread::yield();
+        }
+        return ran.load();
+    };
+
+    running = false;
+    while (!r->post([&]() -> void { (void)r->stop(); })) {
+        std::this_thread::yield();
+    }
+    loop.join();
+}
+
+/*
+ * Effect of the reactor's timer and dispatch tuning on raw callback throughput (zero-interval
+ * timer firings, re-armed every iteration) and on timer jitter (lateness of a 1ms timer).
+ */
+
+static constexpr int ThroughputFirings = 10000;
+static constexpr int JitterFirings = 200;
+
+struct TuningCase {
+    const char *name;
+    pembroke::ReactorBuilder builder;
+};
+
+static auto tuning_matrix() -> std::vector<TuningCase> {
+    return {
+        {"default", pembroke::reactor()},
+        {"precise timer", pembroke::reactor().precise_timer()},
+        {"no time cache", pembroke::reactor().cache_time(false)},
+        {"epoll changelist", pembroke::reactor().epoll_changelist()},
+        {"max dispatch 16 callbacks", pembroke::reactor().max_dispatch_callbacks(16)},
+        {"max dispatch 100us", pembroke::reactor().max_dispatch_interval(100us)},
+    };
+}
+
+TEST_CASE("Reactor tuning: timer throughput", "[reactor][config][benchmark]") {
+    for (auto &tuning : tuning_matrix()) {
+        auto r = tuning.builder.build();
+        auto x = 0;
+        auto event = TimerEvent(0us, 0us, [&]() -> void {
+            if (++x % ThroughputFirings == 0) {
+                (void)r->stop();
+            }
+        });
+        REQUIRE(r->register_event(event));
+
+        BENCHMARK(std::string(tuning.name) + ", 10k firings") {
+            return r->run_blocking();
+        };
+    }
+}
+
+TEST_CASE("Reactor tuning: timer jitter", "[reactor][config][benchmark]") {
+    for (auto &tuning : tuning_matrix()) {
+        auto r = tuning.builder.build();
+        pembroke::Histogram lateness;
+        auto x = 0;
+
+        TimerEvent *self = nullptr;
+        auto event = TimerEvent(1ms, [&]() -> void {
+            lateness.record(self->lateness());
+            if (++x == JitterFirings) {
+                (void)r->stop();
+            }
+        });
+        self = &event;
+        REQUIRE(r->register_event(event));
+        REQUIRE(r->run_blocking());
+
+        auto snap = lateness.snapshot();
+        WARN(tuning.name << ": 1ms timer lateness p50 " << snap.percentile(50).count() / 1000
+             << "us, p99 " << snap.percentile(99).count() / 1000
+             << "us, max " << snap.max().count() / 1000 << "us");
+    }
+}
@@ -0,0 +1,134 @@
+#include "pembroke/reactor_group.hpp"
+
+#include <limits>
+
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <event2/event.h>
+}
+
+namespace pembroke {
+
+    ReactorGroup::ReactorGroup(const ReactorBuilder &builder, size_t n) {
+        if (n == 0) {
+            throw ConfigurationException("Unable to construct a reactor group with no reactors");
+        }
+
+        auto thread_safe_builder = builder;
+        thread_safe_builder.thread_safe();
+
+        m_reactors.reserve(n);
+        m_stop_events.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            auto &r = m_reactors.emplace_back(std::make_unique<Reactor>(thread_safe_builder));
+
+            /* Each reactor gets a dedicated stop-event. Activating an event (unlike calling
+             * event_base_loopbreak) is not lost if the reactor thread has not yet entered its
+             * loop, so stop() cannot race with start(). */
+            auto *base = r->m_base.get();
+            m_stop_events.emplace_back(event_new(base, -1, 0, ReactorGroup::stop_cb, base), event_free);
+            if (m_stop_events.back() == nullptr
+                    || !internal::set_priority(m_stop_events.back().get(), Event::DefaultPriority)) {
+                throw ConfigurationException("Unable to construct reactor group stop-event");
+            }
+        }
+    }
+
+    ReactorGroup::~ReactorGroup() {
+        stop();
+    }
+
+    auto ReactorGroup::start() -> bool {
+        if (m_running.exchange(true)) {
+            return false;
+        }
+
+        m_threads.reserve(m_reactors.size());
+        for (auto &r : m_reactors) {
+            m_threads.emplace_back([this, reactor = r.get()]() -> void {
+                /* A reactor may be stopped individually (e.g. from one of its own callbacks),
+                 * so only the group-wide flag decides when the thread is done. */
+                while (m_running.load(std::memory_order_acquire)) {
+                    if (!reactor->run_blocking()) {
+                        pembroke::logger::error("Reactor in group exited with an error");
+                        break;
+                    }
+                }
+            });
+        }
+        return true;
+    }
+
+    auto ReactorGroup::stop() noexcept -> bool {
+        if (!m_running.exchange(false, std::memory_order_acq_rel)) {
+            return false;
+        }
+
+        for (auto &ev : m_stop_events) {
+            event_active(ev.get(), 0, 0);
+        }
+        for (auto &t : m_threads) {
+            t.join();
+        }
+        m_threads.clear();
+        return true;
+    }
+
+    auto ReactorGroup::running() const noexcept -> bool {
+        return m_running.load(std::memory_order_acquire);
+    }
+
+    auto ReactorGroup::size() const noexcept -> size_t {
+        return m_reactors.size();
+    }
+
+    auto ReactorGroup::reactor(size_t shard) noexcept -> Reactor & {
+        ASSERT_DEBUG(shard < m_reactors.size(), "Reactor shard out of range");
+        return *m_reactors[shard];
+    }
+
+    auto ReactorGroup::load(size_t shard) const noexcept -> size_t {
+        ASSERT_DEBUG(shard < m_reactors.size(), "Reactor shard out of range");
+        return m_reactors[shard]->user_event_count();
+    }
+
+    auto ReactorGroup::register_event(Event &event, Placement placement) noexcept -> bool {
+        return m_reactors[pick_shard(placement)]->register_event(event);
+    }
+
+    auto ReactorGroup::register_event(Event &event, size_t shard) noexcept -> bool {
+        if (shard >= m_reactors.size()) {
+            pembroke::logger::error("Attempting to register event on non-existent reactor shard");
+            return false;
+        }
+        return m_reactors[shard]->register_event(event);
+    }
+
+    auto ReactorGroup::pick_shard(Placement placement) noexcept -> size_t {
+        switch (placement) {
+        case Placement::LeastLoaded: {
+            size_t best = 0;
+            size_t best_load = std::numeric_limits<size_t>::max();
+            for (size_t i = 0; i < m_reactors.size(); i++) {
+                auto l = load(i);
+                if (l < best_load) {
+                    best = i;
+                    best_load = l;
+                }
+            }
+            return best;
+        }
+        case Placement::RoundRobin:
+        default:
+            return m_next_shard.fetch_add(1, std::memory_order_relaxed) % m_reactors.size();
+        }
+    }
+
+    void ReactorGroup::stop_cb(int /*unused*/, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Reactor group stop-event called with null base");
+        event_base_loopbreak(static_cast<event_base *>(arg));
+    }
+
+} // namespace pembroke
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "pembroke/reactor_group.hpp"
+#include "pembroke/event/timer.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke::event;
+
+/*
+ * Scaling benchmark for ReactorGroup. A fixed amount of work (timer firings that
+ * each burn a little CPU) is spread across 1..N reactors. With perfect scaling the
+ * time per run halves each time the number of reactors doubles.
+ */
+
+static constexpr int TimersPerReactor = 64;
+static constexpr int TotalFirings = 200000;
+static constexpr int WorkPerFiring = 200;
+
+static auto burn(int n) -> uint64_t {
+    volatile uint64_t acc = 0;
+    for (int i = 0; i < n; i++) {
+        acc = acc * 31 + i;
+    }
+    return acc;
+}
+
+static void run_scaling_benchmark(size_t n_reactors) {
+    auto group = pembroke::reactor().build_group(n_reactors);
+    REQUIRE(group->start());
+
+    std::atomic<int> firings{0};
+    std::atomic<bool> done{false};
+    std::vector<std::unique_ptr<TimerEvent>> timers;
+
+    BENCHMARK_ADVANCED("timer firings, " + std::to_string(n_reactors) + " reactor(s)")(
+            Catch::Benchmark::Chronometer meter) {
+        meter.measure([&]() -> int {
+            firings = 0;
+            done = false;
+            timers.clear();
+            for (size_t i = 0; i < n_reactors * TimersPerReactor; i++) {
+                auto &t = timers.emplace_back(std::make_unique<TimerEvent>(0us, [&]() -> void {
+                    burn(WorkPerFiring);
+                    if (firings.fetch_add(1, std::memory_order_relaxed) + 1 >= TotalFirings) {
+                        done = true;
+                    }
+                }));
+                (void)group->register_event(*t);
+            }
+            while (!done.load()) {
+                std::this_thread::yield();
+            }
+            /* timers may only be torn down once their reactors are no longer running */
+            group->stop();
+            timers.clear();
+            (void)group->start();
+            return firings.load();
+        });
+    };
+
+    group->stop();
+    timers.clear();
+}
+
+TEST_CASE("ReactorGroup scaling", "[reactor_group][benchmark]") {
+    auto max = std::max(1U, std::thread::hardware_concurrency());
+    for (size_t n = 1; n <= max; n *= 2) {
+        run_scaling_benchmark(n);
+    }
+}
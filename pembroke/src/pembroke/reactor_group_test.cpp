@@ -0,0 +1,200 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "pembroke/reactor_group.hpp"
+#include "pembroke/event/delayed.hpp"
+#include "pembroke/event/timer.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke::event;
+
+/* Spin (with a generous timeout) until a predicate holds, since callbacks run on
+ * the group's threads and not the test's. */
+template<typename Pred>
+static auto wait_for(Pred pred) -> bool {
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(100us);
+    }
+    return true;
+}
+
+// ---
+// Construction
+// ---
+
+TEST_CASE("Reactor group constructable from builder", "[reactor_group][construction]") {
+    std::unique_ptr<pembroke::ReactorGroup> g;
+    REQUIRE_NOTHROW(g = pembroke::reactor().build_group(3));
+    CHECK(g->size() == 3);
+    CHECK_FALSE(g->running());
+}
+
+TEST_CASE("Reactor group defaults to one reactor per core", "[reactor_group][construction]") {
+    auto g = pembroke::reactor().build_group();
+    CHECK(g->size() >= 1);
+}
+
+TEST_CASE("Reactor group cannot be copied or moved", "[reactor_group][construction]") {
+    CHECK_FALSE(std::is_copy_constructible<pembroke::ReactorGroup>::value);
+    CHECK_FALSE(std::is_move_constructible<pembroke::ReactorGroup>::value);
+}
+
+// ---
+// Start / Stop
+// ---
+
+TEST_CASE("Reactor group starts and stops", "[reactor_group][execution]") {
+    auto g = pembroke::reactor().build_group(2);
+
+    CHECK(g->start());
+    CHECK(g->running());
+    CHECK_FALSE(g->start());
+
+    CHECK(g->stop());
+    CHECK_FALSE(g->running());
+    CHECK_FALSE(g->stop());
+}
+
+TEST_CASE("Reactor group stops immediately after start", "[reactor_group][execution]") {
+    auto g = pembroke::reactor().build_group(4);
+    for (int i = 0; i < 10; i++) {
+        CHECK(g->start());
+        CHECK(g->stop());
+    }
+}
+
+TEST_CASE("Reactor group stops on destruction", "[reactor_group][execution]") {
+    auto g = pembroke::reactor().build_group(2);
+    CHECK(g->start());
+    REQUIRE_NOTHROW(g.reset());
+}
+
+// ---
+// Event Placement
+// ---
+
+TEST_CASE("Reactor group places events round-robin", "[reactor_group][placement]") {
+    auto g = pembroke::reactor().build_group(3);
+    std::vector<std::unique_ptr<DelayedEvent>> events;
+
+    for (int i = 0; i < 6; i++) {
+        auto &e = events.emplace_back(std::make_unique<DelayedEvent>(1min, []() -> void {}));
+        CHECK(g->register_event(*e));
+    }
+
+    for (size_t i = 0; i < g->size(); i++) {
+        CHECK(g->load(i) == 2);
+    }
+}
+
+TEST_CASE("Reactor group places events on the least-loaded reactor", "[reactor_group][placement]") {
+    auto g = pembroke::reactor().build_group(3);
+    std::vector<std::unique_ptr<DelayedEvent>> events;
+
+    auto add = [&](auto &&reg) -> void {
+        auto &e = events.emplace_back(std::make_unique<DelayedEvent>(1min, []() -> void {}));
+        CHECK(reg(*e));
+    };
+
+    add([&](auto &e) { return g->register_event(e, 0); });
+    add([&](auto &e) { return g->register_event(e, 0); });
+    add([&](auto &e) { return g->register_event(e, 2); });
+
+    add([&](auto &e) { return g->register_event(e, pembroke::Placement::LeastLoaded); });
+    CHECK(g->load(1) == 1);
+
+    add([&](auto &e) { return g->register_event(e, pembroke::Placement::LeastLoaded); });
+    add([&](auto &e) { return g->register_event(e, pembroke::Placement::LeastLoaded); });
+    CHECK(g->load(0) == 2);
+    CHECK(g->load(1) == 2);
+    CHECK(g->load(2) == 2);
+}
+
+TEST_CASE("Reactor group rejects out-of-range shards", "[reactor_group][placement]") {
+    auto g = pembroke::reactor().build_group(2);
+    auto e = DelayedEvent(1min, []() -> void {});
+    CHECK_FALSE(g->register_event(e, 2));
+}
+
+// ---
+// Execution
+// ---
+
+TEST_CASE("Reactor group runs events on their reactor's thread", "[reactor_group][execution]") {
+    auto g = pembroke::reactor().build_group(2);
+    REQUIRE(g->start());
+
+    std::atomic<int> x{0};
+    std::thread::id ids[2];
+
+    auto e0 = DelayedEvent(0us, [&]() -> void { ids[0] = std::this_thread::get_id(); x += 1; });
+    auto e1 = DelayedEvent(0us, [&]() -> void { ids[1] = std::this_thread::get_id(); x += 1; });
+    CHECK(g->register_event(e0, 0));
+    CHECK(g->register_event(e1, 1));
+
+    REQUIRE(wait_for([&]() { return x.load() == 2; }));
+    CHECK(g->stop());
+
+    CHECK(ids[0] != std::this_thread::get_id());
+    CHECK(ids[1] != std::this_thread::get_id());
+    CHECK(ids[0] != ids[1]);
+}
+
+TEST_CASE("Reactor group keeps running after a single reactor is stopped", "[reactor_group][execution]") {
+    auto g = pembroke::reactor().build_group(1);
+    REQUIRE(g->start());
+
+    std::atomic<int> x{0};
+    auto stopper = DelayedEvent(0us, [&]() -> void {
+        CHECK(g->reactor(0).stop());
+        x += 1;
+    });
+    auto after = DelayedEvent(1ms, [&]() -> void { x += 1; });
+    CHECK(g->register_event(stopper));
+    CHECK(g->register_event(after));
+
+    REQUIRE(wait_for([&]() { return x.load() == 2; }));
+    CHECK(g->stop());
+}
+
+TEST_CASE("Reactor group runs many timers across reactors", "[reactor_group][execution]") {
+    auto g = pembroke::reactor().build_group(4);
+    REQUIRE(g->start());
+
+    std::atomic<int> x{0};
+    std::vector<std::unique_ptr<TimerEvent>> timers;
+    for (int i = 0; i < 16; i++) {
+        auto &t = timers.emplace_back(std::make_unique<TimerEvent>(100us, [&]() -> void { x += 1; }));
+        CHECK(g->register_event(*t));
+    }
+
+    REQUIRE(wait_for([&]() { return x.load() >= 16 * 5; }));
+    CHECK(g->stop());
+}
+
+TEST_CASE("Reactor group runs timing wheel events registered through post()", "[reactor_group][execution]") {
+    auto g = pembroke::reactor().timing_wheel(1ms).build_group(1);
+    REQUIRE(g->start());
+
+    std::atomic<int> x{0};
+    std::atomic<bool> registered{false};
+    auto e = DelayedEvent(1ms, [&]() -> void { x += 1; });
+    e.use_timing_wheel();
+    auto &r = g->reactor(0);
+    REQUIRE(r.post([&]() -> void { registered = r.register_event(e); }));
+
+    REQUIRE(wait_for([&]() { return x.load() == 1; }));
+    CHECK(g->stop());
+    CHECK(registered.load());
+}
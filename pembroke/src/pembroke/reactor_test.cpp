@@ -1,11 +1,18 @@
 #include <catch2/catch.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "pembroke/reactor.hpp"
 #include "pembroke/event/delayed.hpp"
+#include "pembroke/event/timer.hpp"
+
+extern "C" {
+#include <unistd.h>
+}
 
 using namespace std::chrono_literals;
 using namespace pembroke::event;
@@ -58,6 +65,35 @@ TEST_CASE("Reactor features-toggles", "[reactor][construction]") {
     }
 }
 
+TEST_CASE("Reactor declares common timeouts", "[reactor][construction]") {
+    auto r = pembroke::reactor().common_timeout(5s).common_timeout(30s).common_timeout(5s).build();
+
+    CHECK(r->common_timeout(5s) != nullptr);
+    CHECK(r->common_timeout(30s) != nullptr);
+    CHECK(r->common_timeout(5s) != r->common_timeout(30s));
+    CHECK(r->common_timeout(10s) == nullptr);
+}
+
+TEST_CASE("Reactor rejects invalid common timeouts", "[reactor][construction]") {
+    /* The lowest free file-descriptor, which moves if a failed construction leaks one */
+    auto lowest_free_fd = [] {
+        int fd = dup(0);
+        close(fd);
+        return fd;
+    };
+    int free_fd = lowest_free_fd();
+
+    CHECK_THROWS_AS(pembroke::Reactor(pembroke::reactor().common_timeout(pembroke::no_delay)),
+                    pembroke::ConfigurationException);
+
+    auto builder = pembroke::reactor();
+    for (int i = 1; i <= 257; i++) {
+        builder.common_timeout(std::chrono::milliseconds(i));
+    }
+    CHECK_THROWS_AS(pembroke::Reactor(builder), pembroke::ConfigurationException);
+    CHECK(lowest_free_fd() == free_fd);
+}
+
 TEST_CASE("Reactor cannot be copied", "[reactor][construction]") {
     CHECK_FALSE(std::is_copy_assignable<pembroke::Reactor>::value);
     CHECK_FALSE(std::is_copy_constructible<pembroke::Reactor>::value);
@@ -172,4 +208,246 @@ TEST_CASE("Schedule events while paused, execute on resumption", "[reactor][exec
 
     CHECK(r->tick()); // stopped on first tick
     CHECK(r->tick()); // execute events schedule post-stop CHECK(x == 4);
-}
\ No newline at end of file
+}
+
+// ---
+// Cross-Thread Task Submission
+// ---
+
+TEST_CASE("Post task from reactor thread", "[reactor][post]") {
+    auto r = pembroke::reactor().build();
+    auto x = 0;
+
+    CHECK(r->post([&]() -> void { x += 1; }));
+    CHECK(x == 0);
+
+    CHECK(r->tick());
+    CHECK(x == 1);
+}
+
+TEST_CASE("Posted tasks run in order, in a single batch", "[reactor][post]") {
+    auto r = pembroke::reactor().build();
+    std::vector<int> order;
+
+    for (int i = 0; i < 10; i++) {
+        CHECK(r->post([&order, i]() -> void { order.push_back(i); }));
+    }
+
+    CHECK(r->tick());
+    CHECK(order == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+}
+
+TEST_CASE("Post fails once task queue is full", "[reactor][post]") {
+    auto r = pembroke::reactor().task_queue_capacity(4).build();
+    auto x = 0;
+
+    for (int i = 0; i < 4; i++) {
+        CHECK(r->post([&]() -> void { x += 1; }));
+    }
+    CHECK_FALSE(r->post([&]() -> void { x += 1; }));
+
+    CHECK(r->tick());
+    CHECK(x == 4);
+    CHECK(r->post([&]() -> void { x += 1; }));
+    CHECK(r->tick());
+    CHECK(x == 5);
+}
+
+TEST_CASE("Task posted from another thread wakes blocking reactor", "[reactor][post]") {
+    auto r = pembroke::reactor().build();
+    std::atomic<int> x{0};
+
+    std::thread producer([&]() -> void {
+        std::this_thread::sleep_for(10ms);
+        CHECK(r->post([&]() -> void {
+            x += 1;
+            CHECK(r->stop());
+        }));
+    });
+
+    CHECK(r->run_blocking());
+    producer.join();
+    CHECK(x == 1);
+}
+
+TEST_CASE("Tasks posted from many threads all run", "[reactor][post]") {
+    constexpr int Producers = 4;
+    constexpr int PerProducer = 5000;
+
+    auto r = pembroke::reactor().task_queue_capacity(64).build();
+    int x = 0;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < Producers; p++) {
+        producers.emplace_back([&]() -> void {
+            for (int i = 0; i < PerProducer; i++) {
+                while (!r->post([&]() -> void {
+                    if (++x == Producers * PerProducer) {
+                        CHECK(r->stop());
+                    }
+                })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    CHECK(r->run_blocking());
+    for (auto &t : producers) {
+        t.join();
+    }
+    CHECK(x == Producers * PerProducer);
+}
+
+// ---
+// Priorities
+// ---
+
+TEST_CASE("Reactor priorities are configurable", "[reactor][priority]") {
+    CHECK(pembroke::reactor().build()->priorities() == 1);
+    CHECK(pembroke::reactor().priorities(3).build()->priorities() == 3);
+
+    CHECK_THROWS_AS(pembroke::Reactor(pembroke::reactor().priorities(0)), pembroke::ConfigurationException);
+    CHECK_THROWS_AS(pembroke::Reactor(pembroke::reactor().priorities(255)), pembroke::ConfigurationException);
+}
+
+TEST_CASE("Register event with out-of-range priority", "[reactor][priority]") {
+    auto r = pembroke::reactor().priorities(2).build();
+    auto event = DelayedEvent(0s, []() -> void {});
+
+    CHECK_FALSE(r->register_event(event, -1));
+    CHECK_FALSE(r->register_event(event, 2));
+    CHECK(r->register_event(event, 1));
+}
+
+TEST_CASE("Higher-priority events run before lower-priority events", "[reactor][priority]") {
+    auto r = pembroke::reactor().priorities(2).build();
+    std::vector<int> order;
+
+    std::vector<DelayedEvent> events;
+    events.reserve(6);
+    for (int i = 0; i < 6; i++) {
+        // alternate low (1) and high (0) priority events, all ready at once
+        int priority = (i % 2 == 0) ? 1 : 0;
+        events.emplace_back(0s, [&order, priority]() -> void { order.push_back(priority); });
+        CHECK(r->register_event(events.back(), priority));
+    }
+
+    CHECK(r->tick());
+    CHECK(order == std::vector<int>{0, 0, 0, 1, 1, 1});
+}
+
+TEST_CASE("High-priority events preempt a low-priority batch", "[reactor][priority]") {
+    auto r = pembroke::reactor().priorities(2).build();
+    int low = 0;
+    int high = 0;
+
+    // a batch of bulk, low-priority work that is ready ahead of the high-priority event
+    std::vector<DelayedEvent> batch;
+    batch.reserve(100);
+    for (int i = 0; i < 100; i++) {
+        batch.emplace_back(0s, [&low]() -> void { low += 1; });
+        CHECK(r->register_event(batch.back(), 1));
+    }
+    auto urgent = DelayedEvent(0s, [&]() -> void {
+        CHECK(low == 0);
+        high += 1;
+    });
+    CHECK(r->register_event(urgent, 0));
+
+    // tick_fast only drains the top priority
+    CHECK(r->tick_fast());
+    CHECK(high == 1);
+    CHECK(low == 0);
+    CHECK(r->tick_fast());
+    CHECK(low == 0);
+
+    CHECK(r->tick());
+    CHECK(low == 100);
+}
+
+TEST_CASE("Repeating timers keep their priority", "[reactor][priority]") {
+    auto r = pembroke::reactor().priorities(2).build();
+    std::vector<char> order;
+
+    auto bulk = TimerEvent(0us, 1ms, [&]() -> void { order.push_back('b'); });
+    auto urgent = TimerEvent(0us, 1ms, [&]() -> void {
+        order.push_back('u');
+        if (order.size() >= 6) {
+            CHECK(r->stop());
+        }
+    });
+    CHECK(r->register_event(bulk, 1));
+    CHECK(r->register_event(urgent, 0));
+
+    CHECK(r->run_blocking());
+    // whenever both are due in the same iteration the urgent timer runs first
+    CHECK(order.front() == 'u');
+}
+
+// ---
+// Dispatch and Timer Tuning
+// ---
+
+TEST_CASE("Reactor builds with timer and backend flags", "[reactor][construction][config]") {
+    auto builder = pembroke::reactor();
+
+    SECTION("precise timer") { builder.precise_timer(); }
+    SECTION("no time cache") { builder.cache_time(false); }
+    SECTION("epoll changelist") { builder.epoll_changelist(); }
+    SECTION("all") { builder.precise_timer().cache_time(false).epoll_changelist(); }
+
+    auto r = builder.build();
+    auto x = 0;
+    auto event = DelayedEvent(1ms, [&]() -> void {
+        x += 1;
+        CHECK(r->stop());
+    });
+    CHECK(r->register_event(event));
+    CHECK(r->run_blocking());
+    CHECK(x == 1);
+}
+
+TEST_CASE("Reactor rejects invalid dispatch limits", "[reactor][construction][config]") {
+    using pembroke::ConfigurationException;
+    using pembroke::Reactor;
+
+    CHECK_THROWS_AS(Reactor(pembroke::reactor().max_dispatch_interval(-1ms)), ConfigurationException);
+    CHECK_THROWS_AS(Reactor(pembroke::reactor().max_dispatch_callbacks(-1)), ConfigurationException);
+    CHECK_THROWS_AS(Reactor(pembroke::reactor().dispatch_limit_priority(1)), ConfigurationException);
+    CHECK_THROWS_AS(Reactor(pembroke::reactor().priorities(2).dispatch_limit_priority(2)), ConfigurationException);
+
+    CHECK_NOTHROW(Reactor(pembroke::reactor().max_dispatch_interval(1ms).max_dispatch_callbacks(8)));
+    CHECK_NOTHROW(Reactor(pembroke::reactor().priorities(3).max_dispatch_callbacks(1).dispatch_limit_priority(2)));
+}
+
+/* Low-priority events, the first of which schedules a high-priority event, returning the
+ * order in which they all ran */
+static auto run_low_batch(pembroke::ReactorBuilder builder) -> std::vector<char> {
+    auto r = builder.priorities(2).build();
+    std::vector<char> order;
+
+    auto high = DelayedEvent(0s, [&]() -> void { order.push_back('H'); });
+    std::vector<DelayedEvent> lows;
+    lows.reserve(3);
+    lows.emplace_back(0s, [&]() -> void {
+        order.push_back('L');
+        CHECK(r->register_event(high, 0));
+    });
+    lows.emplace_back(0s, [&]() -> void { order.push_back('L'); });
+    lows.emplace_back(0s, [&]() -> void { order.push_back('L'); });
+    for (auto &low : lows) {
+        CHECK(r->register_event(low, 1));
+    }
+
+    CHECK(r->tick());
+    return order;
+}
+
+TEST_CASE("Dispatch limits let high-priority events preempt a batch", "[reactor][priority][config]") {
+    // without a limit the whole low-priority batch runs first
+    CHECK(run_low_batch(pembroke::reactor()) == std::vector<char>{'L', 'L', 'L', 'H'});
+
+    // checking for higher-priority events after every callback
+    CHECK(run_low_batch(pembroke::reactor().max_dispatch_callbacks(1)) == std::vector<char>{'L', 'H', 'L', 'L'});
+}
@@ -0,0 +1,266 @@
+#include "pembroke/timing_wheel.hpp"
+
+#include <algorithm>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/internal/logging.hpp"
+#include "pembroke/internal/util.hpp"
+
+extern "C" {
+#include <event2/event.h>
+}
+
+namespace pembroke {
+
+    // ---
+    // Entry
+    // ---
+
+    TimingWheel::Entry::~Entry() {
+        cancel();
+    }
+
+    TimingWheel::Entry::Entry(Entry &&other) noexcept
+        : m_callback(other.m_callback), m_arg(other.m_arg) {
+        take_place_of(other);
+    }
+
+    auto TimingWheel::Entry::operator=(Entry &&other) noexcept -> Entry & {
+        if (this != &other) {
+            cancel();
+            m_callback = other.m_callback;
+            m_arg = other.m_arg;
+            take_place_of(other);
+        }
+        return *this;
+    }
+
+    void TimingWheel::Entry::cancel() noexcept {
+        if (m_wheel != nullptr) {
+            m_wheel->cancel(*this);
+        }
+    }
+
+    void TimingWheel::Entry::take_place_of(Entry &other) noexcept {
+        m_wheel = other.m_wheel;
+        m_head = other.m_head;
+        m_prev = other.m_prev;
+        m_next = other.m_next;
+        m_expiry = other.m_expiry;
+
+        if (m_wheel != nullptr) {
+            if (m_prev != nullptr) {
+                m_prev->m_next = this;
+            } else {
+                *m_head = this;
+            }
+            if (m_next != nullptr) {
+                m_next->m_prev = this;
+            }
+        }
+
+        other.m_wheel = nullptr;
+        other.m_head = nullptr;
+        other.m_prev = nullptr;
+        other.m_next = nullptr;
+    }
+
+    // ---
+    // Wheel
+    // ---
+
+    static constexpr uint64_t SlotMask = TimingWheel::Slots - 1;
+    static constexpr uint64_t MaxTicks = (uint64_t{1} << (TimingWheel::SlotBits * TimingWheel::Levels)) - 1;
+
+    TimingWheel::TimingWheel(event_base &base, duration resolution)
+        : m_start(clock::now()), m_resolution(resolution) {
+        if (resolution <= duration::zero()) {
+            throw ConfigurationException("Timing wheel resolution must be positive");
+        }
+        m_driver = decltype(m_driver)(
+            event_new(&base, -1, EV_PERSIST, TimingWheel::tick_cb, this),
+            event_free);
+        if (m_driver == nullptr || !internal::set_priority(m_driver.get(), Event::DefaultPriority)) {
+            throw ConfigurationException("Unable to create timing wheel driver event");
+        }
+    }
+
+    TimingWheel::~TimingWheel() {
+        for (auto &level : m_slots) {
+            for (auto &head : level) {
+                while (head != nullptr) {
+                    unlink(*head);
+                }
+            }
+        }
+    }
+
+    auto TimingWheel::schedule(Entry &entry, duration delay) noexcept -> bool {
+        assert_owner();
+        if (entry.m_wheel != nullptr) {
+            entry.m_wheel->unlink(entry);
+        }
+
+        uint64_t now = current_tick();
+        if (m_size.load(std::memory_order_relaxed) == 0) {
+            /* Nothing is waiting on the wheel, so rather than replaying every idle tick
+             * just jump straight to the present. */
+            m_now_tick = std::max(m_now_tick, now);
+        }
+
+        auto ticks = static_cast<uint64_t>((std::max(delay, duration::zero()).count()
+            + m_resolution.count() - 1) / m_resolution.count());
+        ticks = std::clamp<uint64_t>(ticks, 1, MaxTicks);
+
+        /* Expiry is relative to real time, but must land strictly after the tick the wheel
+         * is currently on (which may lag behind real time if the loop is busy) */
+        entry.m_expiry = std::max(now + ticks, m_now_tick + 1);
+        entry.m_expiry = std::min(entry.m_expiry, m_now_tick + MaxTicks);
+        link(entry);
+
+        return arm_driver();
+    }
+
+    void TimingWheel::cancel(Entry &entry) noexcept {
+        if (entry.m_wheel != this) {
+            return;
+        }
+        assert_owner();
+        unlink(entry);
+        if (m_size.load(std::memory_order_relaxed) == 0) {
+            disarm_driver();
+        }
+    }
+
+    auto TimingWheel::resolution() const noexcept -> duration {
+        return m_resolution;
+    }
+
+    auto TimingWheel::size() const noexcept -> size_t {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    void TimingWheel::set_owner(std::thread::id owner) noexcept {
+        m_owner.store(owner, std::memory_order_relaxed);
+    }
+
+    void TimingWheel::assert_owner() const noexcept {
+        auto owner = m_owner.load(std::memory_order_relaxed);
+        ASSERT_RELEASE(owner == std::thread::id() || owner == std::this_thread::get_id(),
+                       "Timing wheel used from a thread other than its reactor's, see Reactor::post()");
+    }
+
+    auto TimingWheel::max_delay() const noexcept -> duration {
+        return m_resolution * static_cast<int64_t>(MaxTicks);
+    }
+
+    void TimingWheel::advance() noexcept {
+        uint64_t now = current_tick();
+        while (m_now_tick < now && m_size.load(std::memory_order_relaxed) > 0) {
+            expire_tick();
+        }
+        m_now_tick = std::max(m_now_tick, now);
+
+        if (m_size.load(std::memory_order_relaxed) == 0) {
+            disarm_driver();
+        }
+    }
+
+    auto TimingWheel::current_tick() const noexcept -> uint64_t {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<duration>(clock::now() - m_start).count() / m_resolution.count());
+    }
+
+    void TimingWheel::link(Entry &entry) noexcept {
+        /* Pick the level by how far away the expiry is, and the slot by the expiry's own
+         * bits for that level. A slot at level L is cascaded down when the wheel reaches
+         * the start of its range, which is always after now and no later than the expiry. */
+        uint64_t delta = entry.m_expiry - m_now_tick;
+        size_t level = 0;
+        while (level < Levels - 1 && delta >= (uint64_t{1} << (SlotBits * (level + 1)))) {
+            level++;
+        }
+        auto slot = static_cast<size_t>((entry.m_expiry >> (SlotBits * level)) & SlotMask);
+
+        Entry **head = &m_slots[level][slot];
+        entry.m_wheel = this;
+        entry.m_head = head;
+        entry.m_prev = nullptr;
+        entry.m_next = *head;
+        if (*head != nullptr) {
+            (*head)->m_prev = &entry;
+        }
+        *head = &entry;
+        m_size.store(m_size.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void TimingWheel::unlink(Entry &entry) noexcept {
+        if (entry.m_prev != nullptr) {
+            entry.m_prev->m_next = entry.m_next;
+        } else {
+            *entry.m_head = entry.m_next;
+        }
+        if (entry.m_next != nullptr) {
+            entry.m_next->m_prev = entry.m_prev;
+        }
+        entry.m_wheel = nullptr;
+        entry.m_head = nullptr;
+        entry.m_prev = nullptr;
+        entry.m_next = nullptr;
+        m_size.store(m_size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    void TimingWheel::cascade(size_t level) noexcept {
+        auto slot = static_cast<size_t>((m_now_tick >> (SlotBits * level)) & SlotMask);
+        Entry *e = m_slots[level][slot];
+        m_slots[level][slot] = nullptr;
+        while (e != nullptr) {
+            Entry *next = e->m_next;
+            m_size.store(m_size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            link(*e);
+            e = next;
+        }
+    }
+
+    void TimingWheel::expire_tick() noexcept {
+        m_now_tick++;
+
+        for (size_t level = 1; level < Levels; level++) {
+            if ((m_now_tick & ((uint64_t{1} << (SlotBits * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        /* Entries scheduled from within a callback always land at least one tick ahead,
+         * so the slot being expired can only shrink while we work through it. */
+        Entry **head = &m_slots[0][m_now_tick & SlotMask];
+        while (*head != nullptr) {
+            Entry *e = *head;
+            unlink(*e);
+            e->m_callback(e->m_arg);
+        }
+    }
+
+    auto TimingWheel::arm_driver() noexcept -> bool {
+        if (m_driver_armed) {
+            return true;
+        }
+        timeval tv = internal::to_timeval(m_resolution);
+        m_driver_armed = evtimer_add(m_driver.get(), &tv) == 0;
+        return m_driver_armed;
+    }
+
+    void TimingWheel::disarm_driver() noexcept {
+        if (m_driver_armed) {
+            evtimer_del(m_driver.get());
+            m_driver_armed = false;
+        }
+    }
+
+    void TimingWheel::tick_cb(int /*unused*/, short /*unused*/, void *arg) noexcept {
+        ASSERT_RELEASE(arg != nullptr, "Timing wheel ticked with null wheel");
+        static_cast<TimingWheel *>(arg)->advance();
+    }
+
+} // namespace pembroke
@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/event/delayed.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke::event;
+
+/*
+ * Register + cancel throughput for large numbers of live timeouts, on libevent's
+ * timer heap versus the reactor's timing wheel. The timeouts mimic per-connection
+ * idle timeouts: many live at once, almost all canceled before they expire.
+ */
+
+static constexpr size_t LiveTimeouts = 100000;
+
+static void register_cancel(pembroke::Reactor &r, std::vector<std::unique_ptr<DelayedEvent>> &live, bool wheel) {
+    for (size_t i = 0; i < live.size(); i++) {
+        live[i] = std::make_unique<DelayedEvent>(30s + std::chrono::microseconds(i), []() -> void {});
+        live[i]->use_timing_wheel(wheel);
+        (void)r.register_event(*live[i]);
+    }
+    for (auto &e : live) {
+        (void)e->cancel();
+    }
+}
+
+TEST_CASE("Timeout register/cancel: heap vs timing wheel", "[timing_wheel][benchmark]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    std::vector<std::unique_ptr<DelayedEvent>> live(LiveTimeouts);
+
+    BENCHMARK("heap, 100k register + cancel") {
+        register_cancel(*r, live, false);
+        return live.size();
+    };
+
+    BENCHMARK("timing wheel, 100k register + cancel") {
+        register_cancel(*r, live, true);
+        return live.size();
+    };
+}
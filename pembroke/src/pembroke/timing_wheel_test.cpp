@@ -0,0 +1,240 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "pembroke/reactor.hpp"
+#include "pembroke/timing_wheel.hpp"
+#include "pembroke/event/delayed.hpp"
+#include "pembroke/event/timer.hpp"
+
+using namespace std::chrono_literals;
+using namespace pembroke::event;
+using pembroke::TimingWheel;
+
+static void count_cb(void *arg) noexcept {
+    *static_cast<int *>(arg) += 1;
+}
+
+/* Tick the reactor until the predicate holds or a (generous) timeout passes */
+template<typename Pred>
+static auto tick_until(pembroke::Reactor &r, Pred pred) -> bool {
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(100us);
+        (void)r.tick();
+    }
+    return true;
+}
+
+// ---
+// Construction
+// ---
+
+TEST_CASE("Reactor has no timing wheel by default", "[timing_wheel][construction]") {
+    auto r = pembroke::reactor().build();
+    CHECK(r->timing_wheel() == nullptr);
+}
+
+TEST_CASE("Reactor builds timing wheel with resolution", "[timing_wheel][construction]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    REQUIRE(r->timing_wheel() != nullptr);
+    CHECK(r->timing_wheel()->resolution() == 1ms);
+    CHECK(r->timing_wheel()->size() == 0);
+    CHECK(r->timing_wheel()->max_delay() >= 24h);
+}
+
+// ---
+// Scheduling
+// ---
+
+TEST_CASE("Timing wheel expires entries", "[timing_wheel][execution]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto *wheel = r->timing_wheel();
+    int x = 0;
+
+    TimingWheel::Entry e{count_cb, &x};
+    CHECK(wheel->schedule(e, 2ms));
+    CHECK(e.scheduled());
+    CHECK(wheel->size() == 1);
+
+    CHECK(tick_until(*r, [&]() { return x == 1; }));
+    CHECK_FALSE(e.scheduled());
+    CHECK(wheel->size() == 0);
+}
+
+TEST_CASE("Timing wheel cancels entries", "[timing_wheel][execution]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto *wheel = r->timing_wheel();
+    int x = 0;
+
+    TimingWheel::Entry e1{count_cb, &x};
+    TimingWheel::Entry e2{count_cb, &x};
+    CHECK(wheel->schedule(e1, 1ms));
+    CHECK(wheel->schedule(e2, 1ms));
+    e1.cancel();
+    CHECK(wheel->size() == 1);
+
+    {
+        TimingWheel::Entry e3{count_cb, &x};
+        CHECK(wheel->schedule(e3, 1ms));
+    }
+    CHECK(wheel->size() == 1);
+
+    CHECK(tick_until(*r, [&]() { return wheel->size() == 0; }));
+    std::this_thread::sleep_for(5ms);
+    CHECK(r->tick());
+    CHECK(x == 1);
+}
+
+TEST_CASE("Timing wheel reschedules entries", "[timing_wheel][execution]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto *wheel = r->timing_wheel();
+    int x = 0;
+
+    TimingWheel::Entry e{count_cb, &x};
+    CHECK(wheel->schedule(e, 1h));
+    CHECK(wheel->schedule(e, 1ms));
+    CHECK(wheel->size() == 1);
+
+    CHECK(tick_until(*r, [&]() { return x == 1; }));
+}
+
+TEST_CASE("Timing wheel expires entries in order across levels", "[timing_wheel][execution]") {
+    /* A very coarse resolution would make this test slow, so use a fine one and
+     * advance the wheel by hand across several level boundaries. */
+    auto r = pembroke::reactor().timing_wheel(10us).build();
+    auto *wheel = r->timing_wheel();
+
+    std::vector<int> fired;
+    struct Ctx { std::vector<int> *fired; int id; };
+    std::vector<Ctx> ctxs;
+    ctxs.reserve(4);
+    std::vector<TimingWheel::Entry> entries;
+    entries.reserve(4);
+
+    auto cb = [](void *arg) noexcept -> void {
+        auto *ctx = static_cast<Ctx *>(arg);
+        ctx->fired->push_back(ctx->id);
+    };
+
+    const pembroke::duration delays[] = {
+        pembroke::duration(300 * 10),    // level 1
+        pembroke::duration(20 * 10),     // level 0
+        pembroke::duration(70000 * 10),  // level 2
+        pembroke::duration(1000 * 10),   // level 1
+    };
+    for (int i = 0; i < 4; i++) {
+        ctxs.push_back(Ctx{&fired, i});
+        entries.emplace_back(cb, &ctxs.back());
+        CHECK(wheel->schedule(entries.back(), delays[i]));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (fired.size() < 4 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+        wheel->advance();
+    }
+    CHECK(fired == std::vector<int>{1, 0, 3, 2});
+}
+
+TEST_CASE("Moving a scheduled entry keeps it on the wheel", "[timing_wheel][execution]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto *wheel = r->timing_wheel();
+    int x = 0;
+
+    TimingWheel::Entry e1{count_cb, &x};
+    TimingWheel::Entry e2{count_cb, &x};
+    CHECK(wheel->schedule(e1, 1ms));
+    CHECK(wheel->schedule(e2, 1ms));
+
+    TimingWheel::Entry moved{std::move(e1)};
+    CHECK_FALSE(e1.scheduled());
+    CHECK(moved.scheduled());
+    CHECK(wheel->size() == 2);
+
+    CHECK(tick_until(*r, [&]() { return x == 2; }));
+}
+
+// ---
+// Events on the Wheel
+// ---
+
+TEST_CASE("Delayed event runs on timing wheel", "[timing_wheel][event][delayed]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto x = 0;
+
+    auto event = DelayedEvent(1ms, [&]() -> void { x += 1; });
+    event.use_timing_wheel();
+    CHECK(r->register_event(event));
+    CHECK(r->timing_wheel()->size() == 1);
+    CHECK_FALSE(r->register_event(event));
+
+    CHECK(tick_until(*r, [&]() { return x == 1; }));
+    CHECK(event.canceled());
+}
+
+TEST_CASE("Delayed event on timing wheel can be canceled", "[timing_wheel][event][delayed]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto x = 0;
+
+    auto event = DelayedEvent(1ms, [&]() -> void { x += 1; });
+    event.use_timing_wheel();
+    CHECK(r->register_event(event));
+    CHECK(event.cancel());
+    CHECK(r->timing_wheel()->size() == 0);
+
+    std::this_thread::sleep_for(5ms);
+    CHECK(r->tick());
+    CHECK(x == 0);
+}
+
+TEST_CASE("Delayed event falls back to heap without a wheel", "[timing_wheel][event][delayed]") {
+    auto r = pembroke::reactor().build();
+    auto x = 0;
+
+    auto event = DelayedEvent(0us, [&]() -> void { x += 1; });
+    event.use_timing_wheel();
+    CHECK(r->register_event(event));
+    CHECK(r->tick());
+    CHECK(x == 1);
+}
+
+TEST_CASE("Timer event repeats on timing wheel", "[timing_wheel][event][timer]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto x = 0;
+
+    auto event = TimerEvent(1ms, [&]() -> void { x += 1; });
+    event.use_timing_wheel();
+    CHECK(r->register_event(event));
+
+    CHECK(tick_until(*r, [&]() { return x >= 3; }));
+    CHECK(r->timing_wheel()->size() == 1);
+
+    CHECK(event.cancel());
+    CHECK(r->timing_wheel()->size() == 0);
+}
+
+TEST_CASE("Timer event on timing wheel canceled from its callback", "[timing_wheel][event][timer]") {
+    auto r = pembroke::reactor().timing_wheel(1ms).build();
+    auto x = 0;
+
+    TimerEvent *self = nullptr;
+    auto event = TimerEvent(1ms, [&]() -> void {
+        x += 1;
+        CHECK(self->cancel());
+    });
+    self = &event;
+    event.use_timing_wheel();
+    CHECK(r->register_event(event));
+
+    CHECK(tick_until(*r, [&]() { return x == 1; }));
+    std::this_thread::sleep_for(5ms);
+    CHECK(r->tick());
+    CHECK(x == 1);
+    CHECK(r->timing_wheel()->size() == 0);
+}